@@ -0,0 +1,227 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _EI_CLASSIFIER_PLANNED_STORAGE_H_
+#define _EI_CLASSIFIER_PLANNED_STORAGE_H_
+
+/**
+ * Planned storage for process_impulse (EI_CLASSIFIER_PLANNED_STORAGE=1)
+ *
+ * Every buffer a run of the impulse needs - the feature array and one matrix
+ * per DSP block over a shared feature buffer, the raw window of the spectral
+ * DSP block if it needs one, the raw output array, its matrices and the output tensor array
+ * of the EON graph - is a static array sized from the impulse metadata, and
+ * init_impulse binds it to the impulse once. After that run_classifier does
+ * not allocate (build the EON graph with EI_CLASSIFIER_ALLOCATION_STATIC too,
+ * otherwise its tensor arena is still allocated per inference). With
+ * EI_CLASSIFIER_SHARED_ARENA the feature matrices can map the graph's input
+ * tensor instead of the feature buffer (tflite_eon.h), so the DSP blocks
+ * write the features where the graph reads them.
+ *
+ * The storage is shared by every run, so only one impulse runs at a time.
+ */
+
+#include <new>
+#include <string.h>
+#include "edge-impulse-sdk/classifier/ei_model_types.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "model-parameters/model_metadata.h"
+
+#ifndef EI_CLASSIFIER_PLANNED_STORAGE
+#define EI_CLASSIFIER_PLANNED_STORAGE 0
+#endif
+
+#if EI_CLASSIFIER_PLANNED_STORAGE
+
+// The DSP block and output tensor counts are not exported as macros, these
+// match this impulse; override with -D for a larger one (init_impulse checks)
+#ifndef EI_CLASSIFIER_PLANNED_DSP_BLOCKS
+#define EI_CLASSIFIER_PLANNED_DSP_BLOCKS        1
+#endif
+#ifndef EI_CLASSIFIER_PLANNED_OUTPUT_TENSORS
+#define EI_CLASSIFIER_PLANNED_OUTPUT_TENSORS    1
+#endif
+#ifndef EI_CLASSIFIER_PLANNED_OUTPUT_SIZE       // floats per output tensor
+#define EI_CLASSIFIER_PLANNED_OUTPUT_SIZE       EI_CLASSIFIER_NN_OUTPUT_COUNT
+#endif
+// Raw window of the spectral DSP block, in floats; a single-axis wavelet block
+// reads the signal into its own buffer instead (ei_run_dsp.h)
+#ifndef EI_CLASSIFIER_PLANNED_DSP_INPUT_SIZE
+#if EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME == 1 && EI_DSP_PARAMS_GENERATED && !EI_DSP_PARAMS_ALL && \
+        EI_DSP_PARAMS_SPECTRAL_ANALYSIS_ANALYSIS_TYPE_WAVELET && !EI_DSP_PARAMS_SPECTRAL_ANALYSIS_ANALYSIS_TYPE_FFT
+#define EI_CLASSIFIER_PLANNED_DSP_INPUT_SIZE    0
+#else
+#define EI_CLASSIFIER_PLANNED_DSP_INPUT_SIZE    EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE
+#endif
+#endif
+
+typedef struct {
+    const ei_impulse_t *impulse;    // impulse the storage is bound to, nullptr before init_impulse
+
+    // DSP blocks: block ix writes its slice of feature_buffer through features[ix].matrix
+    ei_feature_t features[EI_CLASSIFIER_PLANNED_DSP_BLOCKS];
+    size_t feature_count;           // floats over all DSP blocks
+    alignas(ei::matrix_t) uint8_t feature_matrices[EI_CLASSIFIER_PLANNED_DSP_BLOCKS][sizeof(ei::matrix_t)];
+    float feature_buffer[EI_CLASSIFIER_NN_INPUT_FRAME_SIZE];
+#if EI_CLASSIFIER_PLANNED_DSP_INPUT_SIZE > 0
+    float dsp_input[EI_CLASSIFIER_PLANNED_DSP_INPUT_SIZE];
+#endif
+
+    // Learning blocks: result->_raw_outputs and the graph's output tensors
+    ei_feature_t raw_outputs[EI_CLASSIFIER_PLANNED_OUTPUT_TENSORS];
+    alignas(ei::matrix_t) uint8_t output_matrices[EI_CLASSIFIER_PLANNED_OUTPUT_TENSORS][sizeof(ei::matrix_t)];
+    float output_buffer[EI_CLASSIFIER_PLANNED_OUTPUT_TENSORS][EI_CLASSIFIER_PLANNED_OUTPUT_SIZE];
+    TfLiteTensor output_tensors[EI_CLASSIFIER_PLANNED_OUTPUT_TENSORS];
+} ei_planned_storage_t;
+
+static ei_planned_storage_t ei_planned_storage;
+
+/**
+ * Bind the planned storage to an impulse: one feature matrix per DSP block
+ * over consecutive slices of the feature buffer. A no-op when it is already
+ * bound to this impulse. Fails if the impulse does not fit the capacity.
+ */
+static EI_IMPULSE_ERROR ei_planned_storage_plan(const ei_impulse_t *impulse)
+{
+    ei_planned_storage_t &ps = ei_planned_storage;
+    if (ps.impulse == impulse) {
+        return EI_IMPULSE_OK;
+    }
+    ps.impulse = nullptr;
+
+    if (impulse->dsp_blocks_size > EI_CLASSIFIER_PLANNED_DSP_BLOCKS ||
+            impulse->output_tensors_size > EI_CLASSIFIER_PLANNED_OUTPUT_TENSORS) {
+        ei_printf("ERR: Impulse has %u DSP blocks and %u output tensors, planned for %u and %u\n",
+            (unsigned)impulse->dsp_blocks_size, (unsigned)impulse->output_tensors_size,
+            (unsigned)EI_CLASSIFIER_PLANNED_DSP_BLOCKS, (unsigned)EI_CLASSIFIER_PLANNED_OUTPUT_TENSORS);
+        return EI_IMPULSE_INVALID_SIZE;
+    }
+
+    size_t offset = 0;
+    for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+        const ei_model_dsp_t &block = impulse->dsp_blocks[ix];
+        if (offset + block.n_output_features > EI_CLASSIFIER_NN_INPUT_FRAME_SIZE) {
+            ei_printf("ERR: DSP features do not fit the planned feature buffer (%u)\n",
+                (unsigned)EI_CLASSIFIER_NN_INPUT_FRAME_SIZE);
+            return EI_IMPULSE_INVALID_SIZE;
+        }
+        // non-owning, never destroyed
+        ps.features[ix].matrix = ::new (ps.feature_matrices[ix])
+            ei::matrix_t(1, block.n_output_features, ps.feature_buffer + offset);
+        ps.features[ix].blockId = block.blockId;
+        offset += block.n_output_features;
+    }
+    ps.feature_count = offset;
+
+    for (size_t ix = 0; ix < EI_CLASSIFIER_PLANNED_OUTPUT_TENSORS; ix++) {
+        ::new (ps.output_matrices[ix]) ei::matrix_t(1, EI_CLASSIFIER_PLANNED_OUTPUT_SIZE, ps.output_buffer[ix]);
+    }
+
+    ps.impulse = impulse;
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * Map the feature matrices over consecutive slices of `buffer` (the graph's
+ * input tensor, at least feature_count floats), or the feature buffer again
+ * when nullptr.
+ */
+static inline void ei_planned_features_bind(float *buffer)
+{
+    ei_planned_storage_t &ps = ei_planned_storage;
+    float *slice = buffer ? buffer : ps.feature_buffer;
+    for (size_t ix = 0; ps.impulse && ix < ps.impulse->dsp_blocks_size; ix++) {
+        ps.features[ix].matrix->buffer = slice;
+        slice += ps.features[ix].matrix->cols;
+    }
+}
+
+/**
+ * Buffer for the raw window of a DSP block (length floats), nullptr if it is
+ * longer than planned.
+ */
+static inline float *ei_planned_dsp_input(size_t length)
+{
+#if EI_CLASSIFIER_PLANNED_DSP_INPUT_SIZE > 0
+    return length <= EI_CLASSIFIER_PLANNED_DSP_INPUT_SIZE ? ei_planned_storage.dsp_input : nullptr;
+#else
+    (void)length;
+    return nullptr;
+#endif
+}
+
+/**
+ * Output tensor array for a graph with `count` outputs, nullptr if more than planned.
+ */
+static inline TfLiteTensor *ei_planned_output_tensors(size_t count)
+{
+    return count <= EI_CLASSIFIER_PLANNED_OUTPUT_TENSORS ? ei_planned_storage.output_tensors : nullptr;
+}
+
+/**
+ * Whether raw output ix of `size` values fits the planned storage.
+ */
+static inline bool ei_planned_output_fits(size_t ix, size_t size)
+{
+    if (ix >= EI_CLASSIFIER_PLANNED_OUTPUT_TENSORS || size > EI_CLASSIFIER_PLANNED_OUTPUT_SIZE) {
+        ei_printf("ERR: Output %u (%u values) does not fit the planned storage\n", (unsigned)ix, (unsigned)size);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Float matrix for raw output ix of `size` values (see ei_planned_output_fits).
+ */
+static inline ei::matrix_t *ei_planned_output_matrix(size_t ix, size_t size)
+{
+    ei::matrix_t *matrix = (ei::matrix_t*)ei_planned_storage.output_matrices[ix];
+    matrix->rows = 1;
+    matrix->cols = size;
+    return matrix;
+}
+
+/**
+ * Whether a raw output matrix is planned (run_postprocessing frees the others).
+ */
+static inline bool ei_planned_storage_owns(const void *matrix)
+{
+    const uint8_t *p = (const uint8_t*)matrix;
+    const uint8_t *begin = &ei_planned_storage.output_matrices[0][0];
+    return p >= begin && p < begin + sizeof(ei_planned_storage.output_matrices);
+}
+
+#endif // EI_CLASSIFIER_PLANNED_STORAGE
+
+#endif // _EI_CLASSIFIER_PLANNED_STORAGE_H_
@@ -41,9 +41,12 @@
 #include "ei_run_dsp.h"
 #include "ei_classifier_types.h"
 #include "ei_signal_with_axes.h"
+#include "ei_signal_with_spans.h"
+#include "ei_planned_storage.h"
 #include "postprocessing/ei_postprocessing.h"
 #include "edge-impulse-sdk/classifier/ei_data_normalization.h"
 #include "edge-impulse-sdk/classifier/ei_print_results.h"
+#include "edge-impulse-sdk/dsp/ei_profiler.h"
 
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
 #include "edge-impulse-sdk/porting/ei_logging.h"
@@ -112,6 +115,14 @@ EI_IMPULSE_ERROR ei_unscale_fmatrix(ei_learning_block_t *block, ei::matrix_t *fm
 
 static uint64_t classifier_continuous_features_written = 0;
 
+/**
+ * Observer of the features of every run, after data normalization (e.g. for
+ * telemetry), called once per DSP block. See ei_set_features_observer().
+ */
+typedef void (*ei_features_observer_t)(const float *features, size_t count, void *ctx);
+static ei_features_observer_t features_observer = nullptr;
+static void *features_observer_ctx = nullptr;
+
 /* Private functions ------------------------------------------------------- */
 
 /* These functions (up to Public functions section) are not exposed to end-user,
@@ -128,6 +139,34 @@ __attribute__((unused)) void display_results(ei_impulse_handle_t *handle, ei_imp
     display_postprocessing(handle, result);
 }
 
+#if EI_CLASSIFIER_PLANNED_STORAGE
+/**
+ * @brief      Bind the planned storage to the impulse and, with the shared
+ *             arena, map the features onto the EON graph's input tensor.
+ *             A no-op once bound to this impulse.
+ *
+ * @param      impulse  struct with information about model and DSP
+ *
+ * @return     The ei impulse error.
+ */
+static EI_IMPULSE_ERROR plan_impulse_storage(const ei_impulse_t *impulse)
+{
+    if (ei_planned_storage.impulse == impulse) {
+        return EI_IMPULSE_OK;
+    }
+    EI_IMPULSE_ERROR res = ei_planned_storage_plan(impulse);
+#if EI_CLASSIFIER_SHARED_ARENA && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_COMPILED == 1)
+    if (res == EI_IMPULSE_OK) {
+        res = plan_features_in_input_tensor(impulse);
+    }
+    if (res != EI_IMPULSE_OK) {
+        ei_planned_storage.impulse = nullptr;
+    }
+#endif
+    return res;
+}
+#endif // EI_CLASSIFIER_PLANNED_STORAGE
+
 /**
  * @brief      Do inferencing over the processed feature matrix
  *
@@ -201,6 +240,9 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
 
     memset(result, 0, sizeof(ei_impulse_result_t));
 
+    // nothing outlives a run in the DSP arena
+    ei_dsp_arena_reset();
+
 #if EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
     static std::vector<ei_impulse_result_classification_t> classification_results;
     classification_results.clear(); // todo, should not clear and re-gen this every time...
@@ -231,9 +273,18 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
 
     uint8_t num_results = handle->impulse->output_tensors_size;
 
+#if EI_CLASSIFIER_PLANNED_STORAGE
+    // bound by init_impulse; a no-op unless run_classifier_init() was skipped
+    EI_IMPULSE_ERROR plan_res = plan_impulse_storage(handle->impulse);
+    if (plan_res != EI_IMPULSE_OK) {
+        return plan_res;
+    }
+    result->_raw_outputs = ei_planned_storage.raw_outputs;
+#else
     std::unique_ptr<ei_feature_t[]> raw_results_ptr(new ei_feature_t[num_results]);
 
     result->_raw_outputs = raw_results_ptr.get();
+#endif
     memset(result->_raw_outputs, 0, sizeof(ei_feature_t) * num_results);
 
 #if (EI_CLASSIFIER_QUANTIZATION_ENABLED == 1 && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TENSAIFLOW || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_ONNX_TIDL) || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_DRPAI || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_ATON)
@@ -251,6 +302,10 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
 
     uint32_t block_num = handle->impulse->dsp_blocks_size;
 
+#if EI_CLASSIFIER_PLANNED_STORAGE
+    // one matrix per block over the planned feature buffer
+    ei_feature_t* features = ei_planned_storage.features;
+#else
     // smart pointer to features array
     std::unique_ptr<ei_feature_t[]> features_ptr(new ei_feature_t[block_num]);
     ei_feature_t* features = features_ptr.get();
@@ -271,6 +326,7 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
         ei_printf("ERR: Out of memory, can't allocate matrix_ptrs\n");
         return EI_IMPULSE_ALLOC_FAILED;
     }
+#endif // EI_CLASSIFIER_PLANNED_STORAGE
 
     uint64_t dsp_start_us = ei_read_timer_us();
 
@@ -279,6 +335,7 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
     for (size_t ix = 0; ix < handle->impulse->dsp_blocks_size; ix++) {
         ei_model_dsp_t block = handle->impulse->dsp_blocks[ix];
 
+#if !EI_CLASSIFIER_PLANNED_STORAGE
         matrix_ptrs[ix] = std::unique_ptr<ei::matrix_t>(new ei::matrix_t(1, block.n_output_features));
         if (matrix_ptrs[ix] == nullptr) {
             ei_printf("ERR: Out of memory, can't allocate matrix_ptrs[%lu]\n", (unsigned long)ix);
@@ -293,6 +350,7 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
 
         features[ix].matrix = matrix_ptrs[ix].get();
         features[ix].blockId = block.blockId;
+#endif // !EI_CLASSIFIER_PLANNED_STORAGE
 
         if (out_features_index + block.n_output_features > handle->impulse->nn_input_frame_size) {
             ei_printf("ERR: Would write outside feature buffer\n");
@@ -349,15 +407,18 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
     }
 
 #if EI_CLASSIFIER_HAS_DATA_NORMALIZATION
+    EI_PROFILE_START(normalization_start_us);
     EI_IMPULSE_ERROR dn_error = run_data_normalization(handle, features);
     if (dn_error != EI_IMPULSE_OK) {
         ei_printf("ERR: Failed to run Data Normalization process (%d)\n", dn_error);
         return dn_error;
     }
+    EI_PROFILE_END(normalization_start_us, EI_PROFILE_NORMALIZATION, 0);
 #endif
 
     result->timing.dsp_us = ei_read_timer_us() - dsp_start_us;
     result->timing.dsp = (int)(result->timing.dsp_us / 1000);
+    EI_PROFILE_END(dsp_start_us, EI_PROFILE_DSP, 0);
 
     if (debug) {
         ei_printf("Features (%d ms.): ", result->timing.dsp);
@@ -373,6 +434,14 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
         }
     }
 
+    if (features_observer) {
+        for (size_t ix = 0; ix < block_num; ix++) {
+            if (features[ix].matrix != nullptr) {
+                features_observer(features[ix].matrix->buffer, features[ix].matrix->cols, features_observer_ctx);
+            }
+        }
+    }
+
     if (debug) {
         ei_printf("Running impulse...\n");
     }
@@ -380,12 +449,17 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
 #if EI_CLASSIFIER_DSP_ONLY
     return EI_IMPULSE_OK;
 #else
+    EI_PROFILE_START(inference_start_us);
     EI_IMPULSE_ERROR res = run_inference(handle, features, result, debug);
+    EI_PROFILE_END(inference_start_us, EI_PROFILE_INFERENCE, 0);
     if (res != EI_IMPULSE_OK) {
         return res;
     }
     else {
-        return run_postprocessing(handle, result);
+        EI_PROFILE_START(postprocessing_start_us);
+        res = run_postprocessing(handle, result);
+        EI_PROFILE_END(postprocessing_start_us, EI_PROFILE_POSTPROCESSING, 0);
+        return res;
     }
 #endif
 }
@@ -402,7 +476,14 @@ extern "C" EI_IMPULSE_ERROR init_impulse(ei_impulse_handle_t *handle) {
         return EI_IMPULSE_OUT_OF_MEMORY;
     }
     handle->state.reset();
+    if (ei_dsp_init_workspaces(handle->impulse) != EIDSP_OK) {
+        return EI_IMPULSE_DSP_ERROR;
+    }
+#if EI_CLASSIFIER_PLANNED_STORAGE
+    return plan_impulse_storage(handle->impulse);
+#else
     return EI_IMPULSE_OK;
+#endif
 }
 
 /**
@@ -426,6 +507,9 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
 
     memset(result, 0, sizeof(ei_impulse_result_t));
 
+    // nothing outlives a run in the DSP arena
+    ei_dsp_arena_reset();
+
 #if EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
     static std::vector<ei_impulse_result_classification_t> classification_results;
     classification_results.clear(); // todo, should not clear and re-gen this every time...
@@ -462,10 +546,20 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
 
 #endif // EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
 
+#if EI_CLASSIFIER_PLANNED_STORAGE
+    // bound by init_impulse; a no-op unless run_classifier_init() was skipped
+    EI_IMPULSE_ERROR plan_res = plan_impulse_storage(handle->impulse);
+    if (plan_res != EI_IMPULSE_OK) {
+        return plan_res;
+    }
+    result->_raw_outputs = ei_planned_storage.raw_outputs;
+    memset(result->_raw_outputs, 0, sizeof(ei_feature_t) * handle->impulse->output_tensors_size);
+#else
     // smart pointer to results array
     std::unique_ptr<ei_feature_t[]> raw_results_ptr(new ei_feature_t[handle->impulse->learning_blocks_size]);
     result->_raw_outputs = raw_results_ptr.get();
     memset(result->_raw_outputs, 0, sizeof(ei_feature_t) * handle->impulse->learning_blocks_size);
+#endif
 
     auto impulse = handle->impulse;
     static ei::matrix_t static_features_matrix(1, impulse->nn_input_frame_size);
@@ -502,8 +596,11 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
         else if (block.extract_fn == extract_mfe_features) {
             extract_fn_slice = &extract_mfe_per_slice_features;
         }
+        else if (block.extract_fn == extract_spectral_analysis_features) {
+            extract_fn_slice = &extract_spectral_analysis_per_slice_features;
+        }
         else {
-            ei_printf("ERR: Unknown extract function, only MFCC, MFE and spectrogram supported\n");
+            ei_printf("ERR: Unknown extract function, only MFCC, MFE, spectrogram and wavelet spectral analysis supported\n");
             return EI_IMPULSE_DSP_ERROR;
         }
 
@@ -540,6 +637,10 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
     if (classifier_continuous_features_written >= impulse->nn_input_frame_size) {
         dsp_start_us = ei_read_timer_us();
 
+#if EI_CLASSIFIER_PLANNED_STORAGE
+        // one matrix per block over the planned feature buffer, as process_impulse
+        ei_feature_t* features = ei_planned_storage.features;
+#else
         uint32_t block_num = impulse->dsp_blocks_size + impulse->learning_blocks_size;
 
         // smart pointer to features array
@@ -552,16 +653,19 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
         memset(features, 0, sizeof(ei_feature_t) * block_num);
 
         // have it outside of the loop to avoid going out of scope
-        std::unique_ptr<ei::matrix_t> *matrix_ptrs = new std::unique_ptr<ei::matrix_t>[block_num];
+        std::unique_ptr<std::unique_ptr<ei::matrix_t>[]> matrix_ptrs_ptr(new std::unique_ptr<ei::matrix_t>[block_num]);
+        std::unique_ptr<ei::matrix_t> *matrix_ptrs = matrix_ptrs_ptr.get();
         if (matrix_ptrs == nullptr) {
             ei_printf("ERR: Out of memory, can't allocate matrix_ptrs\n");
             return EI_IMPULSE_ALLOC_FAILED;
         }
+#endif // EI_CLASSIFIER_PLANNED_STORAGE
 
         out_features_index = 0;
         // iterate over every dsp block and run normalization
         for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
             ei_model_dsp_t block = impulse->dsp_blocks[ix];
+#if !EI_CLASSIFIER_PLANNED_STORAGE
             matrix_ptrs[ix] = std::unique_ptr<ei::matrix_t>(new ei::matrix_t(1, block.n_output_features));
 
             if (matrix_ptrs[ix] == nullptr) {
@@ -571,12 +675,12 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
 
             if (matrix_ptrs[ix]->buffer == nullptr) {
                 ei_printf("ERR: Out of memory, can't allocate matrix_ptrs[%lu]\n", (unsigned long)ix);
-                delete[] matrix_ptrs;
                 return EI_IMPULSE_ALLOC_FAILED;
             }
 
             features[ix].matrix = matrix_ptrs[ix].get();
             features[ix].blockId = block.blockId;
+#endif // !EI_CLASSIFIER_PLANNED_STORAGE
 
             /* Create a copy of the matrix for normalization */
             for (size_t m_ix = 0; m_ix < block.n_output_features; m_ix++) {
@@ -595,9 +699,23 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
             out_features_index += block.n_output_features;
         }
 
+#if EI_CLASSIFIER_HAS_DATA_NORMALIZATION
+        EI_IMPULSE_ERROR dn_error = run_data_normalization(handle, features);
+        if (dn_error != EI_IMPULSE_OK) {
+            ei_printf("ERR: Failed to run Data Normalization process (%d)\n", dn_error);
+            return dn_error;
+        }
+#endif
+
         result->timing.dsp_us += ei_read_timer_us() - dsp_start_us;
         result->timing.dsp = (int)(result->timing.dsp_us / 1000);
 
+        if (features_observer) {
+            for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+                features_observer(features[ix].matrix->buffer, features[ix].matrix->cols, features_observer_ctx);
+            }
+        }
+
         if (debug) {
             ei_printf("Feature Matrix: \n");
             for (size_t ix = 0; ix < features->matrix->cols; ix++) {
@@ -612,7 +730,6 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
         if (ei_impulse_error != EI_IMPULSE_OK) {
             return ei_impulse_error;
         }
-        delete[] matrix_ptrs;
         ei_impulse_error = run_postprocessing(handle, result);
         if (ei_impulse_error != EI_IMPULSE_OK) {
             return ei_impulse_error;
@@ -817,6 +934,22 @@ will be documented by Doxygen. */
  * @{
  */
 
+/**
+ * @brief Observe the features of every run.
+ *
+ * After the DSP blocks and data normalization, `observer` is called once per
+ * DSP block with that block's features, before inference. It runs on the
+ * inference path, so it should only copy or queue the data.
+ *
+ * @param[in] observer Callback, or `nullptr` to stop observing
+ * @param[in] ctx Passed to every call of `observer`
+ */
+__attribute__((unused)) void ei_set_features_observer(ei_features_observer_t observer, void *ctx)
+{
+    features_observer = observer;
+    features_observer_ctx = ctx;
+}
+
 /**
  * @brief Initialize static variables for running preprocessing and inference
  *  continuously.
@@ -1032,7 +1165,11 @@ extern "C" EI_IMPULSE_ERROR run_classifier(
     ei_impulse_result_t *result,
     bool debug = false)
 {
-    return process_impulse(&ei_default_impulse, signal, result, debug);
+    EI_PROFILE_BEGIN_RUN();
+    EI_PROFILE_START(impulse_start_us);
+    EI_IMPULSE_ERROR res = process_impulse(&ei_default_impulse, signal, result, debug);
+    EI_PROFILE_END(impulse_start_us, EI_PROFILE_IMPULSE, 0);
+    return res;
 }
 
 /**
@@ -36,10 +36,12 @@
 #define _EDGE_IMPULSE_RUN_DSP_H_
 
 #include "edge-impulse-sdk/classifier/ei_model_types.h"
+#include "edge-impulse-sdk/classifier/ei_planned_storage.h"
 #include "edge-impulse-sdk/dsp/spectral/spectral.hpp"
 #include "edge-impulse-sdk/dsp/speechpy/speechpy.hpp"
 #include "edge-impulse-sdk/classifier/ei_signal_with_range.h"
 #include "edge-impulse-sdk/dsp/ei_flatten.h"
+#include "edge-impulse-sdk/dsp/ei_profiler.h"
 #include "model-parameters/model_metadata.h"
 
 #if EI_CLASSIFIER_HR_ENABLED
@@ -131,13 +133,28 @@ __attribute__((unused)) int extract_spectral_analysis_features(
 {
     ei_dsp_config_spectral_analysis_t *config = (ei_dsp_config_spectral_analysis_t *)config_ptr;
 
-    // input matrix from the raw signal
-    matrix_t input_matrix(signal->total_length / config->axes, config->axes);
-    if (!input_matrix.buffer) {
-        EIDSP_ERR(EIDSP_OUT_OF_MEM);
+#if EI_DSP_PARAMS_SPECTRAL_ANALYSIS_ANALYSIS_TYPE_WAVELET || EI_DSP_PARAMS_ALL
+    // one axis: the wavelet block reads the signal into its own buffer, no input matrix
+    if (config->axes == 1 && strcmp(config->analysis_type, "Wavelet") == 0) {
+        return spectral::wavelet::extract_wavelet_features(signal, output_matrix, config, frequency);
     }
+#endif
 
+    // input matrix from the raw signal; the block's temporaries live until it returns
+    ei::dsp_arena_frame frame;
+#if EI_CLASSIFIER_PLANNED_STORAGE
+    float *input_buffer = ei_planned_dsp_input(signal->total_length);
+    if (!input_buffer) {
+        EIDSP_ERR(EIDSP_BUFFER_SIZE_MISMATCH);
+    }
+    matrix_t input_matrix(signal->total_length / config->axes, config->axes, input_buffer);
+#else
+    EI_DSP_ARENA_MATRIX(input_matrix, signal->total_length / config->axes, config->axes);
+#endif
+
+    EI_PROFILE_START(copy_start_us);
     signal->get_data(0, signal->total_length, input_matrix.buffer);
+    EI_PROFILE_END(copy_start_us, EI_PROFILE_SIGNAL_COPY, 0);
 
 #if EI_DSP_PARAMS_SPECTRAL_ANALYSIS_ANALYSIS_TYPE_WAVELET || EI_DSP_PARAMS_ALL
     if (strcmp(config->analysis_type, "Wavelet") == 0) {
@@ -145,6 +162,11 @@ __attribute__((unused)) int extract_spectral_analysis_features(
     }
 #endif
 
+    // only the wavelet feature writer applies a folded data normalization
+    if (config->feature_scale || config->feature_offset) {
+        EIDSP_ERR(EIDSP_NOT_SUPPORTED);
+    }
+
 #if EI_DSP_PARAMS_SPECTRAL_ANALYSIS_ANALYSIS_TYPE_FFT || EI_DSP_PARAMS_ALL
     if (strcmp(config->analysis_type, "FFT") == 0) {
         if (config->implementation_version == 1) {
@@ -188,6 +210,78 @@ __attribute__((unused)) int extract_spectral_analysis_features(
     return EIDSP_NOT_SUPPORTED;
 }
 
+/**
+ * Size the workspaces of the impulse's wavelet blocks for a full window of
+ * raw_sample_count samples, so the first run does not allocate them. Called
+ * by init_impulse.
+ */
+__attribute__((unused)) int ei_dsp_init_workspaces(const ei_impulse_t *impulse)
+{
+#if EI_DSP_PARAMS_SPECTRAL_ANALYSIS_ANALYSIS_TYPE_WAVELET || EI_DSP_PARAMS_ALL
+    for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+        const ei_model_dsp_t &block = impulse->dsp_blocks[ix];
+        if (block.extract_fn != &extract_spectral_analysis_features) {
+            continue;
+        }
+        ei_dsp_config_spectral_analysis_t *config = (ei_dsp_config_spectral_analysis_t *)block.config;
+        if (strcmp(config->analysis_type, "Wavelet") != 0) {
+            continue;
+        }
+        EI_TRY(spectral::wavelet::init_window_workspace(
+            impulse->raw_sample_count, config->wavelet, config->wavelet_level));
+    }
+#else
+    (void)impulse;
+#endif
+    return EIDSP_OK;
+}
+
+#if EI_DSP_PARAMS_SPECTRAL_ANALYSIS_ANALYSIS_TYPE_WAVELET || EI_DSP_PARAMS_ALL
+// sliding window state for continuous wavelet features, shared between invocations
+static spectral::wavelet_stream *ei_dsp_cont_wavelet = nullptr;
+#endif
+
+__attribute__((unused)) int extract_spectral_analysis_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float frequency, matrix_size_t *matrix_size_out) {
+#if EI_DSP_PARAMS_SPECTRAL_ANALYSIS_ANALYSIS_TYPE_WAVELET || EI_DSP_PARAMS_ALL
+    ei_dsp_config_spectral_analysis_t *config = (ei_dsp_config_spectral_analysis_t *)config_ptr;
+
+    if (strcmp(config->analysis_type, "Wavelet") != 0) {
+        ei_printf("ERR: Continuous spectral analysis is only supported for the Wavelet analysis type\n");
+        EIDSP_ERR(EIDSP_NOT_SUPPORTED);
+    }
+
+    if (config->axes != 1) {
+        EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+    }
+
+    if (!ei_dsp_cont_wavelet) {
+        ei_dsp_cont_wavelet = new spectral::wavelet_stream();
+        int ret = ei_dsp_cont_wavelet->init(EI_CLASSIFIER_RAW_SAMPLE_COUNT, config);
+        if (ret != EIDSP_OK) {
+            delete ei_dsp_cont_wavelet;
+            ei_dsp_cont_wavelet = nullptr;
+            EIDSP_ERR(ret);
+        }
+    }
+
+    bool features_ready = false;
+    int ret = ei_dsp_cont_wavelet->update(signal, output_matrix, config, frequency, &features_ready);
+    if (ret != EIDSP_OK) {
+        ei_printf("ERR: Wavelet slice failed (%d)\n", ret);
+        EIDSP_ERR(ret);
+    }
+
+    // the whole feature vector is rewritten once the window is full, nothing before that
+    matrix_size_out->rows = features_ready ? 1 : 0;
+    matrix_size_out->cols = features_ready ? output_matrix->rows * output_matrix->cols : 0;
+
+    return EIDSP_OK;
+#else
+    ei_printf("ERR: Continuous spectral analysis is only supported for the Wavelet analysis type\n");
+    EIDSP_ERR(EIDSP_NOT_SUPPORTED);
+#endif
+}
+
 __attribute__((unused)) int extract_raw_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float frequency) {
     ei_dsp_config_raw_t config = *((ei_dsp_config_raw_t*)config_ptr);
 
@@ -1412,6 +1506,13 @@ __attribute__((unused)) int ei_dsp_clear_continuous_audio_state() {
     ei_dsp_cont_current_frame_size = 0;
     ei_dsp_cont_current_frame_ix = 0;
 
+#if EI_DSP_PARAMS_SPECTRAL_ANALYSIS_ANALYSIS_TYPE_WAVELET || EI_DSP_PARAMS_ALL
+    if (ei_dsp_cont_wavelet) {
+        delete ei_dsp_cont_wavelet;
+    }
+    ei_dsp_cont_wavelet = nullptr;
+#endif
+
     return EIDSP_OK;
 }
 
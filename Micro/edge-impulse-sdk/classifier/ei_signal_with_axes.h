@@ -35,6 +35,7 @@
 #ifndef _EI_CLASSIFIER_SIGNAL_WITH_AXES_H_
 #define _EI_CLASSIFIER_SIGNAL_WITH_AXES_H_
 
+#include <algorithm>
 #include "edge-impulse-sdk/dsp/numpy_types.h"
 #include "edge-impulse-sdk/dsp/returntypes.hpp"
 #include "edge-impulse-sdk/classifier/ei_model_types.h"
@@ -68,16 +69,37 @@ public:
     }
 
     int get_data(size_t offset, size_t length, float *out_ptr) {
-        size_t offset_on_original_signal = offset / _axes_count * _impulse->raw_samples_per_frame;
-        size_t length_on_original_signal = length / _axes_count * _impulse->raw_samples_per_frame;
+        const size_t frame_size = _impulse->raw_samples_per_frame;
+        size_t offset_on_original_signal = offset / _axes_count * frame_size;
+        size_t length_on_original_signal = length / _axes_count * frame_size;
+        size_t end_on_original_signal = offset_on_original_signal + length_on_original_signal;
 
         size_t out_ptr_ix = 0;
 
-        for (size_t ix = offset_on_original_signal; ix < offset_on_original_signal + length_on_original_signal; ix += _impulse->raw_samples_per_frame) {
-            for (size_t axis_ix = 0; axis_ix < this->_axes_count; axis_ix++) {
-                int r = _original_signal->get_data(ix + _axes[axis_ix], 1, &out_ptr[out_ptr_ix++]);
-                if (r != 0) {
-                    return r;
+        // whole frames per get_data call, as many as fit the chunk
+        float chunk[CHUNK_SIZE];
+        size_t chunk_frames = CHUNK_SIZE / frame_size;
+        if (chunk_frames == 0) {
+            for (size_t ix = offset_on_original_signal; ix < end_on_original_signal; ix += frame_size) {
+                for (size_t axis_ix = 0; axis_ix < this->_axes_count; axis_ix++) {
+                    int r = _original_signal->get_data(ix + _axes[axis_ix], 1, &out_ptr[out_ptr_ix++]);
+                    if (r != 0) {
+                        return r;
+                    }
+                }
+            }
+            return 0;
+        }
+
+        for (size_t ix = offset_on_original_signal; ix < end_on_original_signal; ix += chunk_frames * frame_size) {
+            size_t frames = std::min(chunk_frames, (end_on_original_signal - ix) / frame_size);
+            int r = _original_signal->get_data(ix, frames * frame_size, chunk);
+            if (r != 0) {
+                return r;
+            }
+            for (size_t frame_ix = 0; frame_ix < frames; frame_ix++) {
+                for (size_t axis_ix = 0; axis_ix < this->_axes_count; axis_ix++) {
+                    out_ptr[out_ptr_ix++] = chunk[frame_ix * frame_size + _axes[axis_ix]];
                 }
             }
         }
@@ -86,6 +108,8 @@ public:
     }
 
 private:
+    static constexpr size_t CHUNK_SIZE = 64;    // floats on the stack per get_data call
+
     signal_t *_original_signal;
     EI_CLASSIFIER_DSP_AXES_INDEX_TYPE *_axes;
     size_t _axes_count;
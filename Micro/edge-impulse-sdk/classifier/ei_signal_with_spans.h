@@ -0,0 +1,113 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _EI_CLASSIFIER_SIGNAL_WITH_SPANS_H_
+#define _EI_CLASSIFIER_SIGNAL_WITH_SPANS_H_
+
+#include <algorithm>
+#include "edge-impulse-sdk/dsp/numpy_types.h"
+#include "edge-impulse-sdk/dsp/returntypes.hpp"
+
+#if !EIDSP_SIGNAL_C_FN_POINTER
+
+using namespace ei;
+
+/**
+ * Signal over samples already in memory as up to two read-only spans: the
+ * length0 samples at span0 followed by the length1 samples at span1 (a ring
+ * buffer that wraps; otherwise leave the second span empty). get_data copies
+ * a range straight out of the spans, so a DSP block that reads the whole
+ * window in one call gets it with one or two memcpy. Samples are
+ * multiplied by scale on the way out when it is not 1 (a unit conversion
+ * the impulse needs but the buffer does not hold). The spans must stay
+ * valid and unchanged while the impulse runs, and so must this object.
+ */
+class SignalWithSpans {
+public:
+    SignalWithSpans(const float *span0, size_t length0, const float *span1 = nullptr, size_t length1 = 0,
+                    float scale = 1.0f)
+    {
+        _span[0] = span0;
+        _span_length[0] = length0;
+        _span[1] = span1;
+        _span_length[1] = length1;
+        _scale = scale;
+    }
+
+    signal_t * get_signal() {
+        wrapped_signal.total_length = _span_length[0] + _span_length[1];
+#ifdef __MBED__
+        wrapped_signal.get_data = mbed::callback(this, &SignalWithSpans::get_data);
+#else
+        wrapped_signal.get_data = [this](size_t offset, size_t length, float *out_ptr) {
+            return this->get_data(offset, length, out_ptr);
+        };
+#endif
+        return &wrapped_signal;
+    }
+
+    int get_data(size_t offset, size_t length, float *out_ptr) {
+        if (offset + length > _span_length[0] + _span_length[1]) {
+            EIDSP_ERR(EIDSP_OUT_OF_BOUNDS);
+        }
+
+        for (size_t ix = 0; ix < 2 && length > 0; ix++) {
+            if (offset >= _span_length[ix]) {
+                offset -= _span_length[ix];
+                continue;
+            }
+            size_t n = std::min(length, _span_length[ix] - offset);
+            memcpy(out_ptr, _span[ix] + offset, n * sizeof(float));
+            if (_scale != 1.0f) {
+                for (size_t i = 0; i < n; i++) {
+                    out_ptr[i] *= _scale;
+                }
+            }
+            out_ptr += n;
+            length -= n;
+            offset = 0;
+        }
+        return EIDSP_OK;
+    }
+
+private:
+    const float *_span[2];
+    size_t _span_length[2];
+    float _scale;
+    signal_t wrapped_signal;
+};
+
+#endif // #if !EIDSP_SIGNAL_C_FN_POINTER
+
+#endif // _EI_CLASSIFIER_SIGNAL_WITH_SPANS_H_
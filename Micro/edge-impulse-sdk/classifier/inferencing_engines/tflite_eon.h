@@ -43,6 +43,72 @@
 #include "edge-impulse-sdk/classifier/ei_model_types.h"
 #include "edge-impulse-sdk/classifier/inferencing_engines/tflite_helper.h"
 #include "edge-impulse-sdk/classifier/ei_run_dsp.h"
+#include "edge-impulse-sdk/classifier/ei_planned_storage.h"
+#include "edge-impulse-sdk/dsp/ei_dsp_arena.h"
+
+// Tensor arena lent by the DSP arena (ei_dsp_arena.h) for the duration of
+// the graph, instead of its own static or heap buffer
+#ifndef EI_CLASSIFIER_SHARED_ARENA
+#define EI_CLASSIFIER_SHARED_ARENA 0
+#endif
+
+#if EI_CLASSIFIER_SHARED_ARENA && (defined(EI_CLASSIFIER_ALLOCATION_STATIC) || EI_DSP_ARENA_SIZE == 0)
+#error "EI_CLASSIFIER_SHARED_ARENA needs the heap tensor arena of the EON graph and EI_DSP_ARENA_SIZE > 0"
+#endif
+
+/**
+ * Tensor arena of a graph (model_init / model_reset): lent by the DSP arena,
+ * or from the heap
+ */
+static void *alloc_tensor_arena(size_t align, size_t size)
+{
+#if EI_CLASSIFIER_SHARED_ARENA
+    return ei_dsp_arena_lend(align, size);
+#else
+    return ei_aligned_calloc(align, size);
+#endif
+}
+
+static void free_tensor_arena(void *ptr)
+{
+#if EI_CLASSIFIER_SHARED_ARENA
+    ei_dsp_arena_return(ptr);
+#else
+    ei_aligned_free(ptr);
+#endif
+}
+
+/**
+ * Output tensor array of a graph: planned with the impulse, or from the heap
+ */
+static TfLiteTensor *alloc_output_tensors(size_t count)
+{
+#if EI_CLASSIFIER_PLANNED_STORAGE
+    return ei_planned_output_tensors(count);
+#else
+    return (TfLiteTensor*)ei_malloc(count * sizeof(TfLiteTensor));
+#endif
+}
+
+static void free_output_tensors(TfLiteTensor *outputs)
+{
+#if !EI_CLASSIFIER_PLANNED_STORAGE
+    ei_free(outputs);
+#endif
+}
+
+/**
+ * Float matrix for raw output ix: planned with the impulse, or from the heap
+ * (run_postprocessing frees it)
+ */
+static matrix_t *alloc_raw_output_matrix(size_t ix, size_t output_size)
+{
+#if EI_CLASSIFIER_PLANNED_STORAGE
+    return ei_planned_output_matrix(ix, output_size);
+#else
+    return new matrix_t(1, output_size);
+#endif
+}
 
 /**
  * Setup the TFLite runtime
@@ -66,7 +132,7 @@ static EI_IMPULSE_ERROR inference_tflite_setup(
     TfLiteTensor *outputs = *output_arg;
     ei_config_tflite_eon_graph_t *graph_config = (ei_config_tflite_eon_graph_t*)block_config->graph_config;
 
-    TfLiteStatus init_status = graph_config->model_init(ei_aligned_calloc);
+    TfLiteStatus init_status = graph_config->model_init(alloc_tensor_arena);
     if (init_status != kTfLiteOk) {
         ei_printf("Failed to initialize the model (error code %d)\n", init_status);
         return EI_IMPULSE_TFLITE_ARENA_ALLOC_FAILED;
@@ -148,7 +214,10 @@ EI_IMPULSE_ERROR run_nn_inference_from_dsp(
     TfLiteTensor *outputs;
 
     // allocate outputs
-    outputs = (TfLiteTensor*)ei_malloc(block_config->output_tensors_size * sizeof(TfLiteTensor));
+    outputs = alloc_output_tensors(block_config->output_tensors_size);
+    if (!outputs) {
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
 
     uint64_t ctx_start_us = ei_read_timer_us();
     ei_unique_ptr_t p_tensor_arena(nullptr, ei_aligned_free);
@@ -180,10 +249,10 @@ EI_IMPULSE_ERROR run_nn_inference_from_dsp(
         return output_res;
     }
 
-    if (graph_config->model_reset(ei_aligned_free) != kTfLiteOk) {
+    if (graph_config->model_reset(free_tensor_arena) != kTfLiteOk) {
         return EI_IMPULSE_TFLITE_ERROR;
     }
-    ei_free(outputs);
+    free_output_tensors(outputs);
 
     return EI_IMPULSE_OK;
 }
@@ -214,7 +283,10 @@ EI_IMPULSE_ERROR run_nn_inference(
     TfLiteTensor *outputs;
 
     // allocate outputs
-    outputs = (TfLiteTensor*)ei_malloc(block_config->output_tensors_size * sizeof(TfLiteTensor));
+    outputs = alloc_output_tensors(block_config->output_tensors_size);
+    if (!outputs) {
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
 
     uint64_t ctx_start_us = ei_read_timer_us();
     ei_unique_ptr_t p_tensor_arena(nullptr, ei_aligned_free);
@@ -258,15 +330,20 @@ EI_IMPULSE_ERROR run_nn_inference(
         for (int dim_num = 0; dim_num < output->dims->size; dim_num++) {
             output_size *= output->dims->data[dim_num];
         }
+#if EI_CLASSIFIER_PLANNED_STORAGE
+        if (!ei_planned_output_fits(learn_block_index + output_ix, output_size)) {
+            return EI_IMPULSE_INVALID_SIZE;
+        }
+#endif
         switch (output->type) {
             case kTfLiteFloat32: {
-                result->_raw_outputs[learn_block_index + output_ix].matrix = new matrix_t(1, output_size);
+                result->_raw_outputs[learn_block_index + output_ix].matrix = alloc_raw_output_matrix(learn_block_index + output_ix, output_size);
                 memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix->buffer, output->data.f, output->bytes);
                 break;
             }
             case kTfLiteInt8: {
                 if (block_config->dequantize_output) {
-                    result->_raw_outputs[learn_block_index + output_ix].matrix = new matrix_t(1, output_size);
+                    result->_raw_outputs[learn_block_index + output_ix].matrix = alloc_raw_output_matrix(learn_block_index + output_ix, output_size);
                     fill_output_matrix_from_tensor(output, result->_raw_outputs[learn_block_index + output_ix].matrix);
                 }
                 else {
@@ -277,7 +354,7 @@ EI_IMPULSE_ERROR run_nn_inference(
             }
             case kTfLiteUInt8: {
                 if (block_config->dequantize_output) {
-                    result->_raw_outputs[learn_block_index + output_ix].matrix = new matrix_t(1, output_size);
+                    result->_raw_outputs[learn_block_index + output_ix].matrix = alloc_raw_output_matrix(learn_block_index + output_ix, output_size);
                     fill_output_matrix_from_tensor(output, result->_raw_outputs[learn_block_index + output_ix].matrix);
                 }
                 else {
@@ -295,8 +372,8 @@ EI_IMPULSE_ERROR run_nn_inference(
         result->_raw_outputs[learn_block_index].blockId = block_config->block_id;
     }
 
-    graph_config->model_reset(ei_aligned_free);
-    ei_free(outputs);
+    graph_config->model_reset(free_tensor_arena);
+    free_output_tensors(outputs);
 
     if (run_res != EI_IMPULSE_OK) {
         return run_res;
@@ -305,6 +382,56 @@ EI_IMPULSE_ERROR run_nn_inference(
     return EI_IMPULSE_OK;
 }
 
+#if EI_CLASSIFIER_PLANNED_STORAGE && EI_CLASSIFIER_SHARED_ARENA
+/**
+ * Point the planned feature matrices at the graph's input tensor, so the DSP
+ * blocks write (and normalize) the features in place and
+ * fill_input_tensor_from_matrix has nothing to copy. The lent tensor arena
+ * starts at the same address every run, so the input tensor does too; the
+ * DSP arena keeps it out of the DSP temporaries and out of the zero-fill in
+ * model_init. Only for a float input fed by the DSP blocks in order, with no
+ * other learning block reading the features after the graph has overwritten
+ * them; otherwise they stay in the planned feature buffer.
+ */
+static EI_IMPULSE_ERROR plan_features_in_input_tensor(const ei_impulse_t *impulse)
+{
+    ei_planned_features_bind(nullptr);
+    ei_dsp_arena_keep(nullptr, 0);
+
+    if (impulse->learning_blocks_size != 1 || impulse->learning_blocks[0].infer_fn != &run_nn_inference) {
+        return EI_IMPULSE_OK;
+    }
+    const ei_learning_block_t &learn_block = impulse->learning_blocks[0];
+    if (learn_block.input_block_ids_size != impulse->dsp_blocks_size) {
+        return EI_IMPULSE_OK;
+    }
+    for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+        if (learn_block.input_block_ids[ix] != impulse->dsp_blocks[ix].blockId) {
+            return EI_IMPULSE_OK;
+        }
+    }
+
+    ei_learning_block_config_tflite_graph_t *block_config = (ei_learning_block_config_tflite_graph_t*)learn_block.config;
+    ei_config_tflite_eon_graph_t *graph_config = (ei_config_tflite_eon_graph_t*)block_config->graph_config;
+
+    if (graph_config->model_init(alloc_tensor_arena) != kTfLiteOk) {
+        return EI_IMPULSE_TFLITE_ARENA_ALLOC_FAILED;
+    }
+    TfLiteTensor input;
+    TfLiteStatus status = graph_config->model_input(0, &input);
+    graph_config->model_reset(free_tensor_arena);
+    if (status != kTfLiteOk) {
+        return EI_IMPULSE_TFLITE_ERROR;
+    }
+
+    if (input.type == kTfLiteFloat32 && input.bytes == ei_planned_storage.feature_count * sizeof(float) &&
+            ei_dsp_arena_keep(input.data.f, input.bytes)) {
+        ei_planned_features_bind(input.data.f);
+    }
+    return EI_IMPULSE_OK;
+}
+#endif // EI_CLASSIFIER_PLANNED_STORAGE && EI_CLASSIFIER_SHARED_ARENA
+
 #if EI_CLASSIFIER_QUANTIZATION_ENABLED == 1
 /**
  * Special function to run the classifier on images, only works on TFLite models (either interpreter or EON or for tensaiflow)
@@ -327,7 +454,10 @@ EI_IMPULSE_ERROR run_nn_inference_image_quantized(
     TfLiteTensor *outputs;
 
     // allocate outputs
-    outputs = (TfLiteTensor*)ei_malloc(block_config->output_tensors_size * sizeof(TfLiteTensor));
+    outputs = alloc_output_tensors(block_config->output_tensors_size);
+    if (!outputs) {
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
 
     ei_unique_ptr_t p_tensor_arena(nullptr, ei_aligned_free);
 
@@ -394,16 +524,21 @@ EI_IMPULSE_ERROR run_nn_inference_image_quantized(
         for (int dim_num = 0; dim_num < output->dims->size; dim_num++) {
             output_size *= output->dims->data[dim_num];
         }
+#if EI_CLASSIFIER_PLANNED_STORAGE
+        if (!ei_planned_output_fits(learn_block_index + output_ix, output_size)) {
+            return EI_IMPULSE_INVALID_SIZE;
+        }
+#endif
 
         switch (output->type) {
             case kTfLiteFloat32: {
-                result->_raw_outputs[learn_block_index + output_ix].matrix = new matrix_t(1, output_size);
+                result->_raw_outputs[learn_block_index + output_ix].matrix = alloc_raw_output_matrix(learn_block_index + output_ix, output_size);
                 memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix->buffer, output->data.f, output->bytes);
                 break;
             }
             case kTfLiteInt8: {
                 if (block_config->dequantize_output) {
-                    result->_raw_outputs[learn_block_index + output_ix].matrix = new matrix_t(1, output_size);
+                    result->_raw_outputs[learn_block_index + output_ix].matrix = alloc_raw_output_matrix(learn_block_index + output_ix, output_size);
                     fill_output_matrix_from_tensor(output, result->_raw_outputs[learn_block_index + output_ix].matrix);
                 }
                 else {
@@ -414,7 +549,7 @@ EI_IMPULSE_ERROR run_nn_inference_image_quantized(
             }
             case kTfLiteUInt8: {
                 if (block_config->dequantize_output) {
-                    result->_raw_outputs[learn_block_index + output_ix].matrix = new matrix_t(1, output_size);
+                    result->_raw_outputs[learn_block_index + output_ix].matrix = alloc_raw_output_matrix(learn_block_index + output_ix, output_size);
                     fill_output_matrix_from_tensor(output, result->_raw_outputs[learn_block_index + output_ix].matrix);
                 }
                 else {
@@ -432,8 +567,8 @@ EI_IMPULSE_ERROR run_nn_inference_image_quantized(
         result->_raw_outputs[learn_block_index].blockId = block_config->block_id;
     }
 
-    graph_config->model_reset(ei_aligned_free);
-    ei_free(outputs);
+    graph_config->model_reset(free_tensor_arena);
+    free_output_tensors(outputs);
 
     if (run_res != EI_IMPULSE_OK) {
         return run_res;
@@ -85,6 +85,11 @@ EI_IMPULSE_ERROR fill_input_tensor_from_matrix(
 
         switch (input->type) {
             case kTfLiteFloat32: {
+                // already there if the DSP block wrote into the input tensor
+                if (matrix->buffer == input->data.f + input_idx) {
+                    input_idx += matrix->rows * matrix->cols;
+                    break;
+                }
                 for (size_t ix = 0; ix < matrix->rows * matrix->cols; ix++) {
                     input->data.f[input_idx++] = matrix->buffer[ix];
                 }
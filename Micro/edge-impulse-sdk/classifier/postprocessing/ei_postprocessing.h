@@ -36,6 +36,7 @@
 #define EI_POSTPROCESSING_H
 
 #include "edge-impulse-sdk/classifier/ei_model_types.h"
+#include "edge-impulse-sdk/classifier/ei_planned_storage.h"
 
 #if EI_CLASSIFIER_CALIBRATION_ENABLED
 #include "edge-impulse-sdk/classifier/postprocessing/ei_performance_calibration.h"
@@ -123,8 +124,13 @@ extern "C" EI_IMPULSE_ERROR run_postprocessing(ei_impulse_handle_t *handle,
         }
     }
 
-    // free raw results
+    // free raw results (planned ones stay for the next run)
     for (size_t ix = 0; ix < impulse->output_tensors_size; ix++) {
+#if EI_CLASSIFIER_PLANNED_STORAGE
+        if (ei_planned_storage_owns(result->_raw_outputs[ix].matrix)) {
+            continue;
+        }
+#endif
         if (result->_raw_outputs[ix].matrix) {
             delete result->_raw_outputs[ix].matrix;
             result->_raw_outputs[ix].matrix = nullptr;
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2024 EdgeImpulse Inc.
+ *
+ * Generated by Edge Impulse and licensed under the applicable Edge Impulse
+ * Terms of Service. Community and Professional Terms of Service
+ * (https://edgeimpulse.com/legal/terms-of-service) or Enterprise Terms of
+ * Service (https://edgeimpulse.com/legal/enterprise-terms-of-service),
+ * according to your product plan subscription (the “License”).
+ *
+ * This software, documentation and other associated files (collectively referred
+ * to as the “Software”) is a single SDK variation generated by the Edge Impulse
+ * platform and requires an active paid Edge Impulse subscription to use this
+ * Software for any purpose.
+ *
+ * You may NOT use this Software unless you have an active Edge Impulse subscription
+ * that meets the eligibility requirements for the applicable License, subject to
+ * your full and continued compliance with the terms and conditions of the License,
+ * including without limitation any usage restrictions under the applicable License.
+ *
+ * If you do not have an active Edge Impulse product plan subscription, or if use
+ * of this Software exceeds the usage limitations of your Edge Impulse product plan
+ * subscription, you are not permitted to use this Software and must immediately
+ * delete and erase all copies of this Software within your control or possession.
+ * Edge Impulse reserves all rights and remedies available to enforce its rights.
+ *
+ * Unless required by applicable law or agreed to in writing, the Software is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language governing
+ * permissions, disclaimers and limitations under the License.
+ */
+#include "ei_dsp_arena.h"
+
+#include <string.h>
+
+#if EI_DSP_ARENA_SIZE > 0
+static uint8_t arena[EI_DSP_ARENA_SIZE] __attribute__((aligned(EI_DSP_ARENA_BASE_ALIGN)));
+#else
+static uint8_t *const arena = NULL;
+#endif
+
+static size_t arena_top = 0;
+static size_t arena_peak = 0;
+static size_t arena_overflows = 0;
+static size_t arena_lent_max = 0;
+static bool arena_lent = false;
+static size_t arena_kept = 0;
+
+void *ei_dsp_arena_alloc(size_t bytes)
+{
+    size_t size = (bytes + EI_DSP_ARENA_ALIGN - 1) & ~(size_t)(EI_DSP_ARENA_ALIGN - 1);
+    if (EI_DSP_ARENA_SIZE == 0) {
+        return NULL;
+    }
+    if (arena_lent || size > EI_DSP_ARENA_SIZE - arena_top) {
+        // the peak is what the arena would have needed
+        if (!arena_lent && arena_top + size > arena_peak) {
+            arena_peak = arena_top + size;
+        }
+        arena_overflows++;
+        return NULL;
+    }
+
+    void *ptr = arena + arena_top;
+    arena_top += size;
+    if (arena_top > arena_peak) {
+        arena_peak = arena_top;
+    }
+    return ptr;
+}
+
+void *ei_dsp_arena_calloc(size_t nitems, size_t size)
+{
+    void *ptr = ei_dsp_arena_alloc(nitems * size);
+    if (ptr) {
+        memset(ptr, 0, nitems * size);
+    }
+    return ptr;
+}
+
+size_t ei_dsp_arena_mark(void)
+{
+    return arena_top;
+}
+
+void ei_dsp_arena_release(size_t mark)
+{
+    if (mark < arena_top) {
+        arena_top = mark;
+    }
+}
+
+void *ei_dsp_arena_lend(size_t align, size_t size)
+{
+    if (EI_DSP_ARENA_SIZE == 0 || arena_lent || arena_top != arena_kept ||
+            size > EI_DSP_ARENA_SIZE || align > EI_DSP_ARENA_BASE_ALIGN) {
+        return NULL;
+    }
+
+    arena_lent = true;
+    if (size > arena_lent_max) {
+        arena_lent_max = size;
+    }
+    if (size > arena_peak) {
+        arena_peak = size;
+    }
+    if (size > arena_kept) {
+        memset(arena + arena_kept, 0, size - arena_kept);
+    }
+    return arena;
+}
+
+void ei_dsp_arena_return(void *ptr)
+{
+    if (ptr && ptr == (void *)arena) {
+        arena_lent = false;
+    }
+}
+
+bool ei_dsp_arena_keep(const void *ptr, size_t bytes)
+{
+    if (arena_lent || arena_top != arena_kept) {
+        return false;
+    }
+    arena_kept = 0;
+    arena_top = 0;
+    if (!ptr) {
+        return true;
+    }
+
+    const uint8_t *p = (const uint8_t *)ptr;
+    if (EI_DSP_ARENA_SIZE == 0 || p < arena || p + bytes > arena + EI_DSP_ARENA_SIZE) {
+        return false;
+    }
+    size_t end = (size_t)(p - arena) + bytes;
+    arena_kept = (end + EI_DSP_ARENA_ALIGN - 1) & ~(size_t)(EI_DSP_ARENA_ALIGN - 1);
+    if (arena_kept > EI_DSP_ARENA_SIZE) {
+        arena_kept = 0;
+        return false;
+    }
+    arena_top = arena_kept;
+    if (arena_top > arena_peak) {
+        arena_peak = arena_top;
+    }
+    return true;
+}
+
+void ei_dsp_arena_reset(void)
+{
+    arena_top = arena_kept;
+    arena_lent = false;
+}
+
+void ei_dsp_arena_reset_peak(void)
+{
+    arena_peak = arena_top;
+    arena_overflows = 0;
+    arena_lent_max = 0;
+}
+
+void ei_dsp_arena_get_stats(ei_dsp_arena_stats_t *stats)
+{
+    stats->capacity = EI_DSP_ARENA_SIZE;
+    stats->used = arena_top;
+    stats->peak = arena_peak;
+    stats->overflows = arena_overflows;
+    stats->lent = arena_lent_max;
+    stats->kept = arena_kept;
+}
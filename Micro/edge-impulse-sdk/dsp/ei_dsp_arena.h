@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2024 EdgeImpulse Inc.
+ *
+ * Generated by Edge Impulse and licensed under the applicable Edge Impulse
+ * Terms of Service. Community and Professional Terms of Service
+ * (https://edgeimpulse.com/legal/terms-of-service) or Enterprise Terms of
+ * Service (https://edgeimpulse.com/legal/enterprise-terms-of-service),
+ * according to your product plan subscription (the “License”).
+ *
+ * This software, documentation and other associated files (collectively referred
+ * to as the “Software”) is a single SDK variation generated by the Edge Impulse
+ * platform and requires an active paid Edge Impulse subscription to use this
+ * Software for any purpose.
+ *
+ * You may NOT use this Software unless you have an active Edge Impulse subscription
+ * that meets the eligibility requirements for the applicable License, subject to
+ * your full and continued compliance with the terms and conditions of the License,
+ * including without limitation any usage restrictions under the applicable License.
+ *
+ * If you do not have an active Edge Impulse product plan subscription, or if use
+ * of this Software exceeds the usage limitations of your Edge Impulse product plan
+ * subscription, you are not permitted to use this Software and must immediately
+ * delete and erase all copies of this Software within your control or possession.
+ * Edge Impulse reserves all rights and remedies available to enforce its rights.
+ *
+ * Unless required by applicable law or agreed to in writing, the Software is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language governing
+ * permissions, disclaimers and limitations under the License.
+ */
+#ifndef __EIDSPARENA__H__
+#define __EIDSPARENA__H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * DSP arena
+ *
+ * Linear (bump) allocator over a static buffer of EI_DSP_ARENA_SIZE bytes
+ * for DSP temporaries. An allocation moves a pointer, nothing is zeroed
+ * unless asked for (ei_dsp_arena_calloc) and nothing is freed one by one:
+ * a frame (ei::dsp_arena_frame, or ei_dsp_arena_mark / ei_dsp_arena_release)
+ * gives back everything allocated since it was opened, and process_impulse
+ * resets the arena before every run. The high-water mark is kept across
+ * runs, so after a representative run it is the exact arena size to
+ * configure.
+ *
+ * DSP code opts in (EI_DSP_ARENA_MATRIX in memory.hpp, or ei_dsp_arena_alloc
+ * and a heap fallback). When the arena is full, or EI_DSP_ARENA_SIZE is 0, allocations
+ * return nullptr and the caller falls back to the heap; full-arena fallbacks
+ * are counted as overflows. Used from the core that runs the impulse only,
+ * there is no locking.
+ *
+ * The DSP stage and the neural network never run at the same time, so the
+ * arena can also hold the graph's tensor arena (EI_CLASSIFIER_SHARED_ARENA
+ * in tflite_eon.h): ei_dsp_arena_lend hands out the whole buffer between
+ * model_init and model_reset, and one region covers the larger of the two.
+ * A lent block can keep a range (ei_dsp_arena_keep, the graph's input
+ * tensor) that the DSP stage writes into and the next lend does not zero.
+ */
+#ifndef EI_DSP_ARENA_SIZE
+#define EI_DSP_ARENA_SIZE 0         // bytes, 0: DSP temporaries come from the heap
+#endif
+
+#define EI_DSP_ARENA_ALIGN  8       // bytes, every allocation
+#define EI_DSP_ARENA_BASE_ALIGN 16  // bytes, the buffer (and a lent tensor arena)
+
+typedef struct {
+    size_t capacity;                // EI_DSP_ARENA_SIZE
+    size_t used;                    // bytes held right now
+    size_t peak;                    // high-water mark since the last ei_dsp_arena_reset_peak(), overflows included
+    size_t overflows;               // allocations that did not fit
+    size_t lent;                    // largest block lent (tensor arena), included in peak
+    size_t kept;                    // bytes held by ei_dsp_arena_keep, included in used
+} ei_dsp_arena_stats_t;
+
+/**
+ * Uninitialized block of bytes (rounded up to EI_DSP_ARENA_ALIGN), nullptr if
+ * it does not fit or the arena is disabled.
+ */
+void *ei_dsp_arena_alloc(size_t bytes);
+
+/**
+ * As ei_dsp_arena_alloc, zero-filled.
+ */
+void *ei_dsp_arena_calloc(size_t nitems, size_t size);
+
+/**
+ * Current top of the arena; ei_dsp_arena_release(mark) frees everything
+ * allocated after it.
+ */
+size_t ei_dsp_arena_mark(void);
+void ei_dsp_arena_release(size_t mark);
+
+/**
+ * Lends the start of the arena, zero-filled, for as long as the DSP stage is
+ * idle (same signature as ei_aligned_calloc, for the EON model_init).
+ * nullptr if DSP temporaries are held, the arena is already lent, or the
+ * block does not fit. Until ei_dsp_arena_return, DSP allocations fail
+ * (overflows).
+ */
+void *ei_dsp_arena_lend(size_t align, size_t size);
+void ei_dsp_arena_return(void *ptr);
+
+/**
+ * Keeps [ptr, ptr + bytes) of the lent block (and everything before it) out
+ * of the DSP temporaries, which start after it, and out of the zero-fill of
+ * the next lends, replacing the previous range. false (nothing kept) if the
+ * range is not in the arena, or the arena is lent or holds temporaries.
+ * ei_dsp_arena_keep(nullptr, 0) gives the range back.
+ */
+bool ei_dsp_arena_keep(const void *ptr, size_t bytes);
+
+/**
+ * Frees everything but the kept range, a lent block included (start of an
+ * impulse run). Keeps the peak.
+ */
+void ei_dsp_arena_reset(void);
+
+void ei_dsp_arena_reset_peak(void);
+
+void ei_dsp_arena_get_stats(ei_dsp_arena_stats_t *stats);
+
+#ifdef __cplusplus
+namespace ei {
+
+/**
+ * Scoped frame: everything allocated in the arena during its lifetime is
+ * released when it goes out of scope.
+ */
+class dsp_arena_frame {
+public:
+    dsp_arena_frame() : mark(ei_dsp_arena_mark()) { }
+    ~dsp_arena_frame() { ei_dsp_arena_release(mark); }
+
+private:
+    dsp_arena_frame(const dsp_arena_frame &) = delete;
+    dsp_arena_frame &operator=(const dsp_arena_frame &) = delete;
+
+    size_t mark;
+};
+
+} // namespace ei
+
+#endif // __cplusplus
+
+#endif  //!__EIDSPARENA__H__
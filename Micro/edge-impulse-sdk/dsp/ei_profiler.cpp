@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2024 EdgeImpulse Inc.
+ *
+ * Generated by Edge Impulse and licensed under the applicable Edge Impulse
+ * Terms of Service. Community and Professional Terms of Service
+ * (https://edgeimpulse.com/legal/terms-of-service) or Enterprise Terms of
+ * Service (https://edgeimpulse.com/legal/enterprise-terms-of-service),
+ * according to your product plan subscription (the “License”).
+ *
+ * This software, documentation and other associated files (collectively referred
+ * to as the “Software”) is a single SDK variation generated by the Edge Impulse
+ * platform and requires an active paid Edge Impulse subscription to use this
+ * Software for any purpose.
+ *
+ * You may NOT use this Software unless you have an active Edge Impulse subscription
+ * that meets the eligibility requirements for the applicable License, subject to
+ * your full and continued compliance with the terms and conditions of the License,
+ * including without limitation any usage restrictions under the applicable License.
+ *
+ * If you do not have an active Edge Impulse product plan subscription, or if use
+ * of this Software exceeds the usage limitations of your Edge Impulse product plan
+ * subscription, you are not permitted to use this Software and must immediately
+ * delete and erase all copies of this Software within your control or possession.
+ * Edge Impulse reserves all rights and remedies available to enforce its rights.
+ *
+ * Unless required by applicable law or agreed to in writing, the Software is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language governing
+ * permissions, disclaimers and limitations under the License.
+ */
+#include "ei_profiler.h"
+
+#if EI_PROFILER_ENABLED
+
+#include <string.h>
+
+static ei_profile_record_t profile_ring[EI_PROFILER_RING_SIZE];
+static size_t profile_next = 0;       // Slot of the next record
+static size_t profile_count = 0;
+static uint16_t profile_run = 0;
+static bool profile_active = false;
+
+static const char *stage_names[EI_PROFILE_STAGE_COUNT] = {
+    "impulse",
+    "dsp",
+    "signal_copy",
+    "scaling",
+    "wavelet_level",
+    "normalization",
+    "inference",
+    "node",
+    "postprocessing",
+};
+
+void ei_profiler_set_active(bool active)
+{
+    profile_active = active;
+}
+
+bool ei_profiler_active(void)
+{
+    return profile_active;
+}
+
+void ei_profiler_begin_run(void)
+{
+    profile_run++;
+}
+
+uint64_t ei_profiler_start(void)
+{
+    return profile_active ? ei_read_timer_us() : 0;
+}
+
+void ei_profiler_record(ei_profile_stage_t stage, uint32_t index, uint64_t start_us)
+{
+    if (!profile_active || start_us == 0) {
+        return;
+    }
+
+    ei_profile_record_t *record = &profile_ring[profile_next];
+    record->start_us = (uint32_t)start_us;
+    record->duration_us = (uint32_t)(ei_read_timer_us() - start_us);
+    record->run = profile_run;
+    record->stage = (uint8_t)stage;
+    record->index = (uint8_t)index;
+
+    profile_next = (profile_next + 1) % EI_PROFILER_RING_SIZE;
+    if (profile_count < EI_PROFILER_RING_SIZE) {
+        profile_count++;
+    }
+}
+
+size_t ei_profiler_count(void)
+{
+    return profile_count;
+}
+
+size_t ei_profiler_read(ei_profile_record_t *records, size_t max)
+{
+    size_t count = profile_count < max ? profile_count : max;
+    size_t first = (profile_next + EI_PROFILER_RING_SIZE - profile_count) % EI_PROFILER_RING_SIZE;
+    for (size_t i = 0; i < count; i++) {
+        records[i] = profile_ring[(first + i) % EI_PROFILER_RING_SIZE];
+    }
+    return count;
+}
+
+void ei_profiler_clear(void)
+{
+    profile_next = 0;
+    profile_count = 0;
+}
+
+const char *ei_profiler_stage_name(uint8_t stage)
+{
+    return stage < EI_PROFILE_STAGE_COUNT ? stage_names[stage] : "unknown";
+}
+
+void ei_profiler_dump_csv(void)
+{
+    ei_printf("run,stage,index,start_us,duration_us\n");
+    size_t first = (profile_next + EI_PROFILER_RING_SIZE - profile_count) % EI_PROFILER_RING_SIZE;
+    for (size_t i = 0; i < profile_count; i++) {
+        const ei_profile_record_t *r = &profile_ring[(first + i) % EI_PROFILER_RING_SIZE];
+        ei_printf("%u,%s,%u,%lu,%lu\n", (unsigned)r->run, ei_profiler_stage_name(r->stage),
+                  (unsigned)r->index, (unsigned long)r->start_us, (unsigned long)r->duration_us);
+    }
+}
+
+static void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+size_t ei_profiler_dump_binary(ei_profiler_write_fn write, void *ctx)
+{
+    uint8_t header[EI_PROFILER_HEADER_BYTES] = { 'E', 'I', 'P', 'R',
+                                                 EI_PROFILER_BINARY_VERSION, EI_PROFILER_RECORD_BYTES };
+    put_u16(header + 6, (uint16_t)profile_count);
+    size_t written = write(header, sizeof(header), ctx);
+    if (written != sizeof(header)) {
+        return written;
+    }
+
+    size_t first = (profile_next + EI_PROFILER_RING_SIZE - profile_count) % EI_PROFILER_RING_SIZE;
+    for (size_t i = 0; i < profile_count; i++) {
+        const ei_profile_record_t *r = &profile_ring[(first + i) % EI_PROFILER_RING_SIZE];
+        uint8_t bytes[EI_PROFILER_RECORD_BYTES];
+        put_u32(bytes, r->start_us);
+        put_u32(bytes + 4, r->duration_us);
+        put_u16(bytes + 8, r->run);
+        bytes[10] = r->stage;
+        bytes[11] = r->index;
+
+        size_t n = write(bytes, sizeof(bytes), ctx);
+        written += n;
+        if (n != sizeof(bytes)) {
+            break;
+        }
+    }
+    return written;
+}
+
+int ei_profiler_parse_binary(const uint8_t *data, size_t len, ei_profile_record_t *records, size_t max)
+{
+    if (len < EI_PROFILER_HEADER_BYTES || memcmp(data, "EIPR", 4) != 0 ||
+            data[4] != EI_PROFILER_BINARY_VERSION || data[5] != EI_PROFILER_RECORD_BYTES) {
+        return -1;
+    }
+    size_t count = get_u16(data + 6);
+    if (len < EI_PROFILER_HEADER_BYTES + count * EI_PROFILER_RECORD_BYTES) {
+        return -1;
+    }
+
+    const uint8_t *p = data + EI_PROFILER_HEADER_BYTES;
+    size_t stored = count < max ? count : max;
+    for (size_t i = 0; i < stored; i++, p += EI_PROFILER_RECORD_BYTES) {
+        records[i].start_us = get_u32(p);
+        records[i].duration_us = get_u32(p + 4);
+        records[i].run = get_u16(p + 8);
+        records[i].stage = p[10];
+        records[i].index = p[11];
+    }
+    return (int)stored;
+}
+
+#endif // EI_PROFILER_ENABLED
@@ -31,6 +31,8 @@
 #ifndef __EIPROFILER__H__
 #define __EIPROFILER__H__
 
+#include <stddef.h>
+#include <stdint.h>
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
 
 class EiProfiler {
@@ -53,4 +55,118 @@ private:
     uint64_t timestamp;
 };
 
+/**
+ * Stage profiler
+ *
+ * Records the start and duration of every stage of an impulse run (signal
+ * copy, scaling, each wavelet level, normalization, each EON graph node,
+ * postprocessing) in microseconds from ei_read_timer_us(), into a ring of
+ * EI_PROFILER_RING_SIZE records; once full, the oldest records are
+ * overwritten. Compiled in with EI_PROFILER_ENABLED=1 and off until
+ * ei_profiler_set_active(true). Records are written and read on the core
+ * that runs the impulse, there is no locking.
+ *
+ * Binary dump (ei_profiler_dump_binary), all fields little endian:
+ *   header  "EIPR", uint8 version (1), uint8 record size (12), uint16 count
+ *   record  uint32 start_us, uint32 duration_us, uint16 run, uint8 stage,
+ *           uint8 index; oldest first
+ */
+#ifndef EI_PROFILER_ENABLED
+#define EI_PROFILER_ENABLED 0
+#endif
+
+#ifndef EI_PROFILER_RING_SIZE
+#define EI_PROFILER_RING_SIZE 256
+#endif
+
+#define EI_PROFILER_BINARY_VERSION  1
+#define EI_PROFILER_HEADER_BYTES    8
+#define EI_PROFILER_RECORD_BYTES    12
+
+typedef enum {
+    EI_PROFILE_IMPULSE = 0,         // run_classifier
+    EI_PROFILE_DSP,                 // DSP blocks and data normalization
+    EI_PROFILE_SIGNAL_COPY,         // signal_t into the DSP input matrix
+    EI_PROFILE_SCALING,             // index 0: scale and filter, 1: mean removal
+    EI_PROFILE_WAVELET_LEVEL,       // index 1..N: DWT level and its detail band, N + 1: approximation band
+    EI_PROFILE_NORMALIZATION,       // data normalization
+    EI_PROFILE_INFERENCE,           // learning blocks, including tensor setup
+    EI_PROFILE_NODE,                // index: EON graph node (first node of a fused block)
+    EI_PROFILE_POSTPROCESSING,      // postprocessing blocks
+    EI_PROFILE_STAGE_COUNT
+} ei_profile_stage_t;
+
+typedef struct {
+    uint32_t start_us;              // Low 32 bits of ei_read_timer_us()
+    uint32_t duration_us;
+    uint16_t run;                   // Impulse run counter, wraps
+    uint8_t stage;                  // ei_profile_stage_t
+    uint8_t index;
+} ei_profile_record_t;
+
+/**
+ * Writes len bytes of a binary dump; returns the number written.
+ */
+typedef size_t (*ei_profiler_write_fn)(const void *data, size_t len, void *ctx);
+
+void ei_profiler_set_active(bool active);
+bool ei_profiler_active(void);
+
+/**
+ * Starts a new impulse run: later records carry the next run number.
+ */
+void ei_profiler_begin_run(void);
+
+/**
+ * Timestamp for ei_profiler_record(), 0 while inactive.
+ */
+uint64_t ei_profiler_start(void);
+
+/**
+ * Appends a record for stage, lasting from start_us until now.
+ */
+void ei_profiler_record(ei_profile_stage_t stage, uint32_t index, uint64_t start_us);
+
+/**
+ * Number of records held, at most EI_PROFILER_RING_SIZE.
+ */
+size_t ei_profiler_count(void);
+
+/**
+ * Copies up to max records, oldest first. Returns the number copied.
+ */
+size_t ei_profiler_read(ei_profile_record_t *records, size_t max);
+
+void ei_profiler_clear(void);
+
+const char *ei_profiler_stage_name(uint8_t stage);
+
+/**
+ * Prints the held records through ei_printf, one CSV line each after a
+ * "run,stage,index,start_us,duration_us" header.
+ */
+void ei_profiler_dump_csv(void);
+
+/**
+ * Writes the held records in the binary format above. Returns the number
+ * of bytes written.
+ */
+size_t ei_profiler_dump_binary(ei_profiler_write_fn write, void *ctx);
+
+/**
+ * Parses a binary dump. Returns the number of records stored in records
+ * (at most max), or -1 if data is not a complete dump.
+ */
+int ei_profiler_parse_binary(const uint8_t *data, size_t len, ei_profile_record_t *records, size_t max);
+
+#if EI_PROFILER_ENABLED
+#define EI_PROFILE_BEGIN_RUN()              ei_profiler_begin_run()
+#define EI_PROFILE_START(name)              uint64_t name = ei_profiler_start()
+#define EI_PROFILE_END(name, stage, index)  ei_profiler_record((stage), (index), (name))
+#else
+#define EI_PROFILE_BEGIN_RUN()
+#define EI_PROFILE_START(name)
+#define EI_PROFILE_END(name, stage, index)
+#endif
+
 #endif  //!__EIPROFILER__H__
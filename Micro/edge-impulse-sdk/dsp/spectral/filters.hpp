@@ -32,6 +32,7 @@
 #define _EIDSP_SPECTRAL_FILTERS_H_
 
 #include <math.h>
+#include <string.h>
 #include "../numpy.hpp"
 
 #ifndef M_PI
@@ -41,16 +42,172 @@
 namespace ei {
 namespace spectral {
 namespace filters {
+    /**
+     * Cascade of second order sections (biquads), transposed direct form II,
+     * in single precision throughout. Coefficients are designed once and the
+     * state is kept between calls, so a signal can be filtered in chunks of any
+     * size (down to one sample as it arrives) with the same result as in one
+     * go. Runs on arm_biquad_cascade_df2T_f32 when CMSIS-DSP is available.
+     *
+     * No pointers are held between calls; the object can be copied freely
+     * (which also copies the state).
+     */
+    class biquad_cascade {
+    public:
+        static constexpr int max_sections = 4;     // Butterworth order 8
+        static constexpr int coeffs_per_section = 5;
+
+        biquad_cascade() : sections(0) {
+            memset(coeffs, 0, sizeof(coeffs));
+            reset();
+        }
+
+        /**
+         * Design a Butterworth low or high pass filter (bilinear transform),
+         * one section per pole pair, and clear the state.
+         * @param highpass High pass if true, low pass otherwise
+         * @param filter_order Even filter order (between 2..8), odd orders are
+         *  rounded down
+         * @param sampling_freq Sample frequency of the signal
+         * @param cutoff_freq Cut-off frequency, below sampling_freq / 2
+         * @returns 0 if OK
+         */
+        int design_butterworth(bool highpass, int filter_order, float sampling_freq, float cutoff_freq)
+        {
+            int n_steps = filter_order / 2;
+            if (n_steps < 1 || n_steps > max_sections ||
+                    !(cutoff_freq > 0.0f) || !(cutoff_freq < sampling_freq / 2.0f)) {
+                EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+            }
+
+            const float pi = static_cast<float>(M_PI);
+            float a = tanf(pi * cutoff_freq / sampling_freq);
+            float a2 = a * a;
+
+            for (int ix = 0; ix < n_steps; ix++) {
+                float r = sinf(pi * (2.0f * ix + 1.0f) / (2.0f * filter_order));
+                float s = a2 + 2.0f * a * r + 1.0f;
+                float gain = highpass ? 1.0f / s : a2 / s;
+                float *c = coeffs + ix * coeffs_per_section;
+
+                c[0] = gain;
+                c[1] = highpass ? -2.0f * gain : 2.0f * gain;
+                c[2] = gain;
+                // Feedback terms are added, as in CMSIS-DSP
+                c[3] = 2.0f * (1.0f - a2) / s;
+                c[4] = -(a2 - 2.0f * a * r + 1.0f) / s;
+            }
+            sections = n_steps;
+            reset();
+            return EIDSP_OK;
+        }
+
+        /**
+         * Forget the signal seen so far (as if preceded by zeros).
+         */
+        void reset()
+        {
+            memset(state, 0, sizeof(state));
+        }
+
+        /**
+         * Filter size samples, continuing from the previous call. src and dest
+         * may be the same array.
+         */
+        void process(const float *src, float *dest, size_t size)
+        {
+#if EIDSP_USE_CMSIS_DSP
+            arm_biquad_cascade_df2T_instance_f32 instance;
+            instance.numStages = static_cast<uint8_t>(sections);
+            instance.pState = state;
+            instance.pCoeffs = coeffs;
+            arm_biquad_cascade_df2T_f32(&instance, src, dest, static_cast<uint32_t>(size));
+#else
+            for (size_t sx = 0; sx < size; sx++) {
+                dest[sx] = process(src[sx]);
+            }
+#endif
+        }
+
+        /**
+         * Filter one sample, continuing from the previous call.
+         */
+        float process(float x)
+        {
+            for (int i = 0; i < sections; i++) {
+                const float *c = coeffs + i * coeffs_per_section;
+                float *d = state + 2 * i;
+
+                float y = c[0] * x + d[0];
+                d[0] = c[1] * x + c[3] * y + d[1];
+                d[1] = c[2] * x + c[4] * y;
+                x = y;
+            }
+            return x;
+        }
+
+        int num_sections() const
+        {
+            return sections;
+        }
+
+    private:
+        int sections;
+        float coeffs[max_sections * coeffs_per_section];   // b0 b1 b2 a1 a2 per section
+        float state[max_sections * 2];
+    };
+
+    /**
+     * One-shot Butterworth filter behind butterworth_lowpass/highpass. Settings
+     * that biquad_cascade::design_butterworth() rejects keep the results of the
+     * previous, unchecked implementation: below order 2 the signal passes
+     * unchanged, and a cut-off at or past the edge of the band gives the
+     * limit of the response (unchanged when the whole band is in the pass
+     * band, zeros when it is all in the stop band).
+     * @returns 0 if OK, an error for orders above 8
+     */
+    static int butterworth_filter(
+        bool highpass,
+        int filter_order,
+        float sampling_freq,
+        float cutoff_freq,
+        const float *src,
+        float *dest,
+        size_t size)
+    {
+        bool all_pass = filter_order < 2 ||
+            (highpass ? !(cutoff_freq > 0.0f) : !(cutoff_freq < sampling_freq / 2.0f));
+        bool all_stop = highpass ? !(cutoff_freq < sampling_freq / 2.0f) : !(cutoff_freq > 0.0f);
+
+        if (all_pass) {
+            if (dest != src) {
+                memmove(dest, src, size * sizeof(float));
+            }
+            return EIDSP_OK;
+        }
+        if (all_stop && filter_order / 2 <= biquad_cascade::max_sections) {
+            memset(dest, 0, size * sizeof(float));
+            return EIDSP_OK;
+        }
+
+        biquad_cascade filter;
+        EI_TRY(filter.design_butterworth(highpass, filter_order, sampling_freq, cutoff_freq));
+        filter.process(src, dest, size);
+        return EIDSP_OK;
+    }
+
     /**
      * The Butterworth filter has maximally flat frequency response in the passband.
-     * @param filter_order Even filter order (between 2..8)
+     * @param filter_order Even filter order (between 2..8, below 2 passes the
+     *  signal through)
      * @param sampling_freq Sample frequency of the signal
      * @param cutoff_freq Cut-off frequency of the signal
      * @param src Source array
      * @param dest Destination array
      * @param size Size of both source and destination arrays
+     * @returns 0 if OK, see butterworth_filter()
      */
-    static void butterworth_lowpass(
+    static int butterworth_lowpass(
         int filter_order,
         float sampling_freq,
         float cutoff_freq,
@@ -58,55 +215,21 @@ namespace filters {
         float *dest,
         size_t size)
     {
-        int n_steps = filter_order / 2;
-        float a = tan(M_PI * cutoff_freq / sampling_freq);
-        float a2 = pow(a, 2);
-        float *A = (float*)ei_dsp_calloc(n_steps, sizeof(float));
-        float *d1 = (float*)ei_dsp_calloc(n_steps, sizeof(float));
-        float *d2 = (float*)ei_dsp_calloc(n_steps, sizeof(float));
-        float *w0 = (float*)ei_dsp_calloc(n_steps, sizeof(float));
-        float *w1 = (float*)ei_dsp_calloc(n_steps, sizeof(float));
-        float *w2 = (float*)ei_dsp_calloc(n_steps, sizeof(float));
-
-        // Calculate the filter parameters
-        for(int ix = 0; ix < n_steps; ix++) {
-            float r = sin(M_PI * ((2.0 * ix) + 1.0) / (2.0 * filter_order));
-            sampling_freq = a2 + (2.0 * a * r) + 1.0;
-            A[ix] = a2 / sampling_freq;
-            d1[ix] = 2.0 * (1 - a2) / sampling_freq;
-            d2[ix] = -(a2 - (2.0 * a * r) + 1.0) / sampling_freq;
-        }
-
-        // Apply the filter
-        for (size_t sx = 0; sx < size; sx++) {
-            dest[sx] = src[sx];
-
-            for (int i = 0; i < n_steps; i++) {
-                w0[i] = d1[i] * w1[i] + d2[i] * w2[i] + dest[sx];
-                dest[sx] = A[i] * (w0[i] + (2.0 * w1[i]) + w2[i]);
-                w2[i] = w1[i];
-                w1[i] = w0[i];
-            }
-        }
-
-        ei_dsp_free(A, n_steps*sizeof(float));
-        ei_dsp_free(d1, n_steps*sizeof(float));
-        ei_dsp_free(d2, n_steps*sizeof(float));
-        ei_dsp_free(w0, n_steps*sizeof(float));
-        ei_dsp_free(w1, n_steps*sizeof(float));
-        ei_dsp_free(w2, n_steps*sizeof(float));
+        return butterworth_filter(false, filter_order, sampling_freq, cutoff_freq, src, dest, size);
     }
 
     /**
      * The Butterworth filter has maximally flat frequency response in the passband.
-     * @param filter_order Even filter order (between 2..8)
+     * @param filter_order Even filter order (between 2..8, below 2 passes the
+     *  signal through)
      * @param sampling_freq Sample frequency of the signal
      * @param cutoff_freq Cut-off frequency of the signal
      * @param src Source array
      * @param dest Destination array
      * @param size Size of both source and destination arrays
+     * @returns 0 if OK, see butterworth_filter()
      */
-    static void butterworth_highpass(
+    static int butterworth_highpass(
         int filter_order,
         float sampling_freq,
         float cutoff_freq,
@@ -114,43 +237,7 @@ namespace filters {
         float *dest,
         size_t size)
     {
-        int n_steps = filter_order / 2;
-        float a = tan(M_PI * cutoff_freq / sampling_freq);
-        float a2 = pow(a, 2);
-        float *A = (float*)ei_dsp_calloc(n_steps, sizeof(float));
-        float *d1 = (float*)ei_dsp_calloc(n_steps, sizeof(float));
-        float *d2 = (float*)ei_dsp_calloc(n_steps, sizeof(float));
-        float *w0 = (float*)ei_dsp_calloc(n_steps, sizeof(float));
-        float *w1 = (float*)ei_dsp_calloc(n_steps, sizeof(float));
-        float *w2 = (float*)ei_dsp_calloc(n_steps, sizeof(float));
-
-        // Calculate the filter parameters
-        for (int ix = 0; ix < n_steps; ix++) {
-            float r = sin(M_PI * ((2.0 * ix) + 1.0) / (2.0 * filter_order));
-            sampling_freq = a2 + (2.0 * a * r) + 1.0;
-            A[ix] = 1.0f / sampling_freq;
-            d1[ix] = 2.0 * (1 - a2) / sampling_freq;
-            d2[ix] = -(a2 - (2.0 * a * r) + 1.0) / sampling_freq;
-        }
-
-        // Apply the filter
-        for (size_t sx = 0; sx < size; sx++) {
-            dest[sx] = src[sx];
-
-            for (int i = 0; i < n_steps; i++) {
-                w0[i] = d1[i] * w1[i] + d2[i] * w2[i] + dest[sx];
-                dest[sx] = A[i] * (w0[i] - (2.0 * w1[i]) + w2[i]);
-                w2[i] = w1[i];
-                w1[i] = w0[i];
-            }
-        }
-
-        ei_dsp_free(A, n_steps*sizeof(float));
-        ei_dsp_free(d1, n_steps*sizeof(float));
-        ei_dsp_free(d2, n_steps*sizeof(float));
-        ei_dsp_free(w0, n_steps*sizeof(float));
-        ei_dsp_free(w1, n_steps*sizeof(float));
-        ei_dsp_free(w2, n_steps*sizeof(float));
+        return butterworth_filter(true, filter_order, sampling_freq, cutoff_freq, src, dest, size);
     }
 
 } // namespace filters
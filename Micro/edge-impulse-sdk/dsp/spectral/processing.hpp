@@ -121,13 +121,13 @@ namespace processing {
         uint8_t filter_order)
     {
         for (size_t row = 0; row < matrix->rows; row++) {
-            filters::butterworth_lowpass(
+            EI_TRY(filters::butterworth_lowpass(
                 filter_order,
                 sampling_frequency,
                 filter_cutoff,
                 matrix->buffer + (row * matrix->cols),
                 matrix->buffer + (row * matrix->cols),
-                matrix->cols);
+                matrix->cols));
         }
 
         return EIDSP_OK;
@@ -150,13 +150,13 @@ namespace processing {
         uint8_t filter_order)
     {
         for (size_t row = 0; row < matrix->rows; row++) {
-            filters::butterworth_highpass(
+            EI_TRY(filters::butterworth_highpass(
                 filter_order,
                 sampling_frequency,
                 filter_cutoff,
                 matrix->buffer + (row * matrix->cols),
                 matrix->buffer + (row * matrix->cols),
-                matrix->cols);
+                matrix->cols));
         }
 
         return EIDSP_OK;
@@ -30,7 +30,10 @@
  */
 #pragma once
 
+#include <new>
 #include "edge-impulse-sdk/dsp/ei_vector.h"
+#include "edge-impulse-sdk/dsp/ei_profiler.h"
+#include "edge-impulse-sdk/dsp/ei_dsp_arena.h"
 
 #include "processing.hpp"
 #include "wavelet_coeff.hpp"
@@ -49,27 +52,348 @@ inline float dot(const float *x, const float *y, size_t sz)
     return sum;
 }
 
-inline void histo(const fvec &x, size_t nbins, fvec &h, bool normalize = false)
+/**
+ * Histogram of x over [min, max], the range of x. Lets callers that already know
+ * the range skip the min/max scan.
+ */
+inline void histo_range(
+    const float *x,
+    size_t n,
+    float min,
+    float max,
+    size_t nbins,
+    float *h,
+    bool normalize = false)
 {
-    float min = *std::min_element(x.begin(), x.end());
-    float max = *std::max_element(x.begin(), x.end());
     float step = (max - min) / nbins;
-    h.resize(nbins);
-    for (size_t i = 0; i < x.size(); i++) {
+    memset(h, 0, nbins * sizeof(float));
+    for (size_t i = 0; i < n; i++) {
         size_t bin = (x[i] - min) / step;
         if (bin >= nbins)
             bin = nbins - 1;
         h[bin]++;
     }
     if (normalize) {
-        float s = numpy::sum(h.data(), h.size());
+        float s = numpy::sum(h, nbins);
         for (size_t i = 0; i < nbins; i++) {
             h[i] /= s;
         }
     }
 }
 
+inline void histo(const float *x, size_t n, size_t nbins, float *h, bool normalize = false)
+{
+    float min = *std::min_element(x, x + n);
+    float max = *std::max_element(x, x + n);
+    histo_range(x, n, min, max, nbins, h, normalize);
+}
+
+inline void histo(const fvec &x, size_t nbins, fvec &h, bool normalize = false)
+{
+    h.resize(nbins);
+    histo(x.data(), x.size(), nbins, h.data(), normalize);
+}
+
+/**
+ * Index of a percentile in a sorted array of n values, same rounding as the
+ * reference implementation.
+ */
+inline size_t percentile_index(size_t n, float percentile)
+{
+    // adding 0.5 is a trick to get rounding out of C flooring behavior during cast
+    return (size_t) ((percentile * (n-1)) + 0.5);
+}
+
+/**
+ * Values at the given ranks (non-decreasing) as if x was sorted ascending, without
+ * sorting it. x is reordered in place. Each selection partitions x, so the ranks
+ * below and above it only search their side: k ranks cost O(n log k) on average
+ * instead of the O(n log n) of a full sort. The results are the exact order
+ * statistics, identical to reading a sorted copy.
+ */
+inline void select_ranks(float *x, size_t n, const size_t *ranks, size_t count, float *out)
+{
+    // x[lo, hi) holds exactly the order statistics lo .. hi-1
+    struct selector {
+        static void run(float *x, size_t lo, size_t hi, const size_t *ranks, size_t count, float *out)
+        {
+            if (count == 0) {
+                return;
+            }
+
+            size_t mid = count / 2;
+            size_t rank = ranks[mid];
+            assert(rank >= lo && rank < hi);
+            std::nth_element(x + lo, x + rank, x + hi);
+            out[mid] = x[rank];
+
+            // equal ranks (short inputs) resolve to the same element
+            size_t left = mid;
+            while (left > 0 && ranks[left - 1] == rank) {
+                out[--left] = x[rank];
+            }
+            size_t right = mid + 1;
+            while (right < count && ranks[right] == rank) {
+                out[right++] = x[rank];
+            }
+
+            run(x, lo, rank, ranks, left, out);
+            run(x, rank + 1, hi, ranks + right, count - right, out + right);
+        }
+    };
+
+    selector::run(x, 0, n, ranks, count, out);
+}
+
+// Builds generated for a single wavelet get its filter at compile time, and the DWT
+// runs the unrolled kernel below. EI_DSP_PARAMS_ALL builds keep the runtime lookup.
+#if EI_DSP_PARAMS_GENERATED && !EI_DSP_PARAMS_ALL
+#if EI_DSP_PARAMS_SPECTRAL_ANALYSIS_WAVELET_BIOR3P7
+#define EIDSP_WAVELET_FIXED_FILTER wavelet_bior3p7
+#endif
+#endif
+
+/**
+ * Unrolled low and high pass taps for one DWT output, filter being one of the
+ * wavelet_* structs in wavelet_coeff.hpp. Taps are read reversed (as get_filter does)
+ * and accumulated in the same order as dot(), so results are bit-identical to the
+ * runtime path. Zero taps, half of every bior high pass, are dropped at compile time.
+ */
+template <typename filter, size_t tap = 0, bool done = (tap == filter::length)>
+struct fixed_dwt_taps {
+    static inline void accumulate(const float *x, float &a, float &d)
+    {
+        constexpr float lo = filter::dec_lo(filter::length - 1 - tap);
+        constexpr float hi = filter::dec_hi(filter::length - 1 - tap);
+        if (lo != 0.0f) {
+            a += x[tap] * lo;
+        }
+        if (hi != 0.0f) {
+            d += x[tap] * hi;
+        }
+        fixed_dwt_taps<filter, tap + 1>::accumulate(x, a, d);
+    }
+};
+
+template <typename filter, size_t tap>
+struct fixed_dwt_taps<filter, tap, true> {
+    static inline void accumulate(const float *, float &, float &)
+    {
+    }
+};
+
+/**
+ * Low and high pass outputs for the nh samples at x. With a fixed filter h, g and nh
+ * describe the same filter and only the unrolled kernel runs.
+ */
+inline void dwt_filter_pair(
+    const float *x,
+    const float *h,
+    const float *g,
+    size_t nh,
+    float &a,
+    float &d)
+{
+#ifdef EIDSP_WAVELET_FIXED_FILTER
+    (void)h;
+    (void)g;
+    (void)nh;
+    a = 0.0f;
+    d = 0.0f;
+    fixed_dwt_taps<EIDSP_WAVELET_FIXED_FILTER>::accumulate(x, a, d);
+#else
+    a = dot(x, h, nh);
+    d = dot(x, g, nh);
+#endif
+}
+
+/**
+ * Everything the band statistics need besides the percentiles and the histogram.
+ * Central moments are sums, not yet divided by n.
+ */
+struct band_moments {
+    float mean;
+    float min;
+    float max;
+    float sum_squares; // raw, for the rms
+    float m2;
+    float m3;
+    float m4;
+    size_t zero_crossings;
+    size_t mean_crossings;
+};
+
+/**
+ * Fused replacement for numpy::mean/stdev/variance/rms/skew/kurtosis, the histogram
+ * range and the crossing counts, which walked each band once per statistic (several
+ * of them recomputing the mean). Two passes: sum, sum of squares and range, then the
+ * central moments and crossings once the mean is known. Raw power sums would allow a
+ * single pass but lose too much precision in float for the fourth moment.
+ *
+ * Both passes keep MOMENT_LANES independent accumulators so the loops vectorize on
+ * the host (SSE/NEON) and keep the Cortex-M33 FPU pipeline busy. Results match the
+ * numpy functions up to float summation order.
+ */
+inline void calculate_band_moments(const float *y, size_t n, band_moments &out)
+{
+    const size_t MOMENT_LANES = 4;
+    assert(n > 0);
+
+    float sum[MOMENT_LANES] = { 0 };
+    float sq[MOMENT_LANES] = { 0 };
+    float lo[MOMENT_LANES];
+    float hi[MOMENT_LANES];
+    for (size_t k = 0; k < MOMENT_LANES; k++) {
+        lo[k] = hi[k] = y[0];
+    }
+
+    size_t i = 0;
+    for (; i + MOMENT_LANES <= n; i += MOMENT_LANES) {
+        for (size_t k = 0; k < MOMENT_LANES; k++) {
+            float v = y[i + k];
+            sum[k] += v;
+            sq[k] += v * v;
+            lo[k] = v < lo[k] ? v : lo[k];
+            hi[k] = v > hi[k] ? v : hi[k];
+        }
+    }
+    for (; i < n; i++) {
+        float v = y[i];
+        sum[0] += v;
+        sq[0] += v * v;
+        lo[0] = v < lo[0] ? v : lo[0];
+        hi[0] = v > hi[0] ? v : hi[0];
+    }
+
+    out.min = lo[0];
+    out.max = hi[0];
+    for (size_t k = 1; k < MOMENT_LANES; k++) {
+        out.min = lo[k] < out.min ? lo[k] : out.min;
+        out.max = hi[k] > out.max ? hi[k] : out.max;
+    }
+    out.mean = ((sum[0] + sum[1]) + (sum[2] + sum[3])) / n;
+    out.sum_squares = (sq[0] + sq[1]) + (sq[2] + sq[3]);
+
+    const float mean = out.mean;
+    float m2[MOMENT_LANES] = { 0 };
+    float m3[MOMENT_LANES] = { 0 };
+    float m4[MOMENT_LANES] = { 0 };
+    size_t zc[MOMENT_LANES] = { 0 };
+    size_t mc[MOMENT_LANES] = { 0 };
+
+    // crossings compare against the previous sample, so the first one only
+    // contributes to the moments
+    float d0 = y[0] - mean;
+    m2[0] = d0 * d0;
+    m3[0] = m2[0] * d0;
+    m4[0] = m2[0] * m2[0];
+
+    i = 1;
+    for (; i + MOMENT_LANES <= n; i += MOMENT_LANES) {
+        for (size_t k = 0; k < MOMENT_LANES; k++) {
+            float v = y[i + k];
+            float prev = y[i + k - 1];
+            float d = v - mean;
+            float d2 = d * d;
+            m2[k] += d2;
+            m3[k] += d2 * d;
+            m4[k] += d2 * d2;
+            zc[k] += (v * prev < 0);
+            mc[k] += (d * (prev - mean) < 0);
+        }
+    }
+    for (; i < n; i++) {
+        float v = y[i];
+        float prev = y[i - 1];
+        float d = v - mean;
+        float d2 = d * d;
+        m2[0] += d2;
+        m3[0] += d2 * d;
+        m4[0] += d2 * d2;
+        zc[0] += (v * prev < 0);
+        mc[0] += (d * (prev - mean) < 0);
+    }
+
+    out.m2 = (m2[0] + m2[1]) + (m2[2] + m2[3]);
+    out.m3 = (m3[0] + m3[1]) + (m3[2] + m3[3]);
+    out.m4 = (m4[0] + m4[1]) + (m4[2] + m4[3]);
+    out.zero_crossings = (zc[0] + zc[1]) + (zc[2] + zc[3]);
+    out.mean_crossings = (mc[0] + mc[1]) + (mc[2] + mc[3]);
+}
+
+/**
+ * Copies the features of one axis to out. With a folded data normalization (the
+ * block config's feature_scale / feature_offset, offset = -mean * scale precomputed
+ * at export) every feature is normalized as it is written, one multiply-add, and the
+ * separate standard scaler pass over the output matrix is not needed.
+ */
+inline void write_features(
+    const fvec &features,
+    const ei_dsp_config_spectral_analysis_t *config,
+    size_t first,
+    float *out)
+{
+    const size_t n = features.size();
+    if (!config->feature_scale || !config->feature_offset) {
+        memcpy(out, features.data(), n * sizeof(float));
+        return;
+    }
+
+    const float *scale = config->feature_scale + first;
+    const float *offset = config->feature_offset + first;
+    for (size_t i = 0; i < n; i++) {
+        out[i] = features[i] * scale[i] + offset[i];
+    }
+}
+
+/**
+ * Scratch buffers for the wavelet features. Sized once for an input length, wavelet
+ * and level (see wavelet::prepare_workspace). The padded input, the level buffers
+ * and the statistics scratch are one block of scratch_size() floats, bound per
+ * window to the DSP arena or to `storage` (see wavelet::bind_scratch), after which
+ * extraction does not allocate.
+ */
+struct wavelet_workspace {
+    wavelet_workspace()
+        : input_len(0), wav(nullptr), level(0), padded_len(0), band_len(0), histogram_len(0),
+          padded(nullptr), a(nullptr), d(nullptr), selection(nullptr), histogram(nullptr)
+    {
+    }
+
+    bool matches(size_t input_len, const char *wav, int level) const
+    {
+        return this->input_len == input_len && this->level == level &&
+            this->wav != nullptr && strcmp(this->wav, wav) == 0;
+    }
+
+    size_t input_len;
+    const char *wav;
+    int level;
+
+    size_t scratch_size() const
+    {
+        return padded_len + 3 * band_len + histogram_len;
+    }
+
+    fvec h; // reversed decomposition filters
+    fvec g;
+    size_t padded_len;
+    size_t band_len; // coefficients of the largest band (level 1)
+    size_t histogram_len;
+
+    float *padded; // symmetric padded input of a level
+    float *a; // approximation, doubles as the next level's input
+    float *d; // detail
+    float *selection; // percentile scratch, reordered by select_ranks
+    float *histogram; // entropy scratch
+    fvec storage; // heap block for the scratch, allocated once if needed
+    fvec features;
+};
+
+class wavelet_stream;
+
 class wavelet {
+    friend class wavelet_stream;
 
     static constexpr size_t NUM_FEATHERS_PER_COMP = 14;
 
@@ -85,8 +409,35 @@ class wavelet {
         }
     }
 
-    static void find_filter(const char *wav, fvec &h, fvec &g)
+    template <size_t wave_size>
+    static void get_filter(const float (&wav)[2][wave_size], fvec &h, fvec &g)
     {
+        h.resize(wave_size);
+        g.resize(wave_size);
+        for (size_t i = 0; i < wave_size; i++) {
+            h[i] = wav[0][wave_size - i - 1];
+            g[i] = wav[1][wave_size - i - 1];
+        }
+    }
+
+    /**
+     * Reversed decomposition filters of wav. Returns false if the wavelet is unknown,
+     * or, in a fixed-filter build, is not the one compiled in.
+     */
+    static bool find_filter(const char *wav, fvec &h, fvec &g)
+    {
+#ifdef EIDSP_WAVELET_FIXED_FILTER
+        typedef EIDSP_WAVELET_FIXED_FILTER fixed;
+        if (strcmp(wav, fixed::name()) != 0) {
+            return false;
+        }
+        h.resize(fixed::length);
+        g.resize(fixed::length);
+        for (size_t i = 0; i < fixed::length; i++) {
+            h[i] = fixed::dec_lo(fixed::length - i - 1);
+            g[i] = fixed::dec_hi(fixed::length - i - 1);
+        }
+#else
         if (strcmp(wav, "bior1.3") == 0) get_filter<6>(bior1p3, h, g);
         else if (strcmp(wav, "bior1.5") == 0) get_filter<10>(bior1p5, h, g);
         else if (strcmp(wav, "bior2.2") == 0) get_filter<6>(bior2p2, h, g);
@@ -137,16 +488,26 @@ class wavelet {
         else if (strcmp(wav, "sym8") == 0) get_filter<16>(sym8, h, g);
         else if (strcmp(wav, "sym9") == 0) get_filter<18>(sym9, h, g);
         else if (strcmp(wav, "sym10") == 0) get_filter<20>(sym10, h, g);
-        else assert(0); // wavelet not in the list
+        else return false; // wavelet not in the list
+#endif
+        return true;
     }
 
-    static void calculate_entropy(const fvec &y, fvec &features)
+    static constexpr size_t ENTROPY_BINS = 100;
+    static constexpr size_t PERCENTILE_COUNT = 5;
+
+    static void calculate_entropy(
+        const float *y,
+        size_t n,
+        const band_moments &moments,
+        wavelet_workspace &ws,
+        fvec &features)
     {
-        fvec h;
-        histo(y, 100, h, true);
+        float *h = ws.histogram;
+        histo_range(y, n, moments.min, moments.max, ENTROPY_BINS, h, true);
         // entropy = -sum(prob * log(prob)
         float entropy = 0.0f;
-        for (size_t i = 0; i < h.size(); i++) {
+        for (size_t i = 0; i < ENTROPY_BINS; i++) {
             if (h[i] > 0.0f) {
                 entropy -= h[i] * log(h[i]);
             }
@@ -154,122 +515,141 @@ class wavelet {
         features.push_back(entropy);
     }
 
-    static float get_percentile_from_sorted(const fvec &sorted, float percentile)
+    static void calculate_statistics(
+        const float *y,
+        size_t n,
+        const band_moments &moments,
+        wavelet_workspace &ws,
+        fvec &features)
     {
-        // adding 0.5 is a trick to get rounding out of C flooring behavior during cast
-        size_t index = (size_t) ((percentile * (sorted.size()-1)) + 0.5);
-        return sorted[index];
+        // ascending, so the ranks are too; pushed in the reference order below
+        static const float percentiles[PERCENTILE_COUNT] = { 0.05f, 0.25f, 0.5f, 0.75f, 0.95f };
+        size_t ranks[PERCENTILE_COUNT];
+        float values[PERCENTILE_COUNT];
+        for (size_t i = 0; i < PERCENTILE_COUNT; i++) {
+            ranks[i] = percentile_index(n, percentiles[i]);
+        }
+
+        float *scratch = ws.selection;
+        memcpy(scratch, y, n * sizeof(float));
+        select_ranks(scratch, n, ranks, PERCENTILE_COUNT, values);
+        features.push_back(values[0]);
+        features.push_back(values[1]);
+        features.push_back(values[3]);
+        features.push_back(values[4]);
+        features.push_back(values[2]);
+
+        // same definitions as numpy::stdev, variance (n - 1), rms, skew and kurtosis
+        const float m2 = moments.m2 / n;
+        const float m3 = moments.m3 / n;
+        const float m4 = moments.m4 / n;
+        const float m2_cubed = sqrt(m2 * m2 * m2);
+        const float m2_squared = m2 * m2;
+
+        features.push_back(moments.mean);
+        features.push_back(sqrt(m2));
+        features.push_back(moments.m2 / (n - 1));
+        features.push_back(sqrt(moments.sum_squares / static_cast<float>(n)));
+        features.push_back(m2_cubed == 0.0f ? 0.0f : m3 / m2_cubed);
+        features.push_back(m2_squared == 0.0f ? -3.0f : (m4 / m2_squared) - 3.0f);
     }
 
-    static void calculate_statistics(const fvec &y, fvec &features, float mean)
+    static void calculate_crossings(size_t n, const band_moments &moments, fvec &features)
     {
-        fvec sorted = y;
-        std::sort(sorted.begin(), sorted.end());
-        features.push_back(get_percentile_from_sorted(sorted,0.05));
-        features.push_back(get_percentile_from_sorted(sorted,0.25));
-        features.push_back(get_percentile_from_sorted(sorted,0.75));
-        features.push_back(get_percentile_from_sorted(sorted,0.95));
-        features.push_back(get_percentile_from_sorted(sorted,0.5));
-
-        matrix_t x(1, y.size(), const_cast<float *>(y.data()));
-        matrix_t out(1, 1);
-
-        features.push_back(mean);
-        if (numpy::stdev(&x, &out) == EIDSP_OK)
-            features.push_back(out.get_row_ptr(0)[0]);
-        features.push_back(numpy::variance(const_cast<float *>(y.data()), y.size()));
-        if (numpy::rms(&x, &out) == EIDSP_OK)
-            features.push_back(out.get_row_ptr(0)[0]);
-        if (numpy::skew(&x, &out) == EIDSP_OK)
-            features.push_back(out.get_row_ptr(0)[0]);
-        if (numpy::kurtosis(&x, &out) == EIDSP_OK)
-            features.push_back(out.get_row_ptr(0)[0]);
-    }
-
-    static void calculate_crossings(const fvec &y, fvec &features, float mean)
+        features.push_back(moments.zero_crossings / (float)n);
+        features.push_back(moments.mean_crossings / (float)n);
+    }
+
+    /**
+     * Where a level's input goes in the padded buffer, after the left padding.
+     */
+    static float *padded_input(wavelet_workspace &ws)
     {
-        size_t zc = 0;
-        for (size_t i = 1; i < y.size(); i++) {
-            if (y[i] * y[i - 1] < 0) {
-                zc++;
-            }
-        }
-        features.push_back(zc / (float)y.size());
+        return ws.padded + ws.h.size() - 2;
+    }
 
-        size_t mc = 0;
-        for (size_t i = 1; i < y.size(); i++) {
-            if ((y[i] - mean) * (y[i - 1] - mean) < 0) {
-                mc++;
-            }
-        }
-        features.push_back(mc / (float)y.size());
+    /**
+     * One decomposition level. x may alias a, as the input is copied into the padded
+     * buffer first. Returns the number of coefficients written to a and d.
+     */
+    static size_t dwt(const float *x, size_t nx, wavelet_workspace &ws, float *a, float *d)
+    {
+        memcpy(padded_input(ws), x, nx * sizeof(float));
+        return dwt_padded(nx, ws, a, d);
     }
 
-    static void
-    dwt(const float *x, size_t nx, const float *h, const float *g, size_t nh, fvec &a, fvec &d)
+    /**
+     * As dwt, with the nx input samples already at padded_input(ws).
+     */
+    static size_t dwt_padded(size_t nx, wavelet_workspace &ws, float *a, float *d)
     {
+        const float *h = ws.h.data();
+        const float *g = ws.g.data();
+        const size_t nh = ws.h.size();
         assert(nh <= 20 && nh > 0 && nx > 0);
-        size_t nx_padded = nx + nh * 2 - 2;
-        fvec x_padded(nx_padded);
+        float *x_padded = ws.padded;
+        const float *x = padded_input(ws);
 
         // symmetric padding (default in PyWavelet)
         for (size_t i = 0; i < nh - 2; i++)
             x_padded[i] = x[nh - 3 - i];
-        for (size_t i = 0; i < nx; i++)
-            x_padded[i + nh - 2] = x[i];
         for (size_t i = 0; i < nh; i++)
             x_padded[i + nx + nh - 2] = x[nx - 1 - i];
 
         size_t ny = (nx + nh - 1) / 2;
-        a.resize(ny);
-        d.resize(ny);
 
         // decimate and filter
-        const float *xx = x_padded.data();
+        const float *xx = x_padded;
         for (size_t i = 0; i < ny; i++) {
-            a[i] = dot(xx + 2 * i, h, nh);
-            d[i] = dot(xx + 2 * i, g, nh);
+            dwt_filter_pair(xx + 2 * i, h, g, nh, a[i], d[i]);
         }
 
-        numpy::underflow_handling(d.data(), d.size());
-        numpy::underflow_handling(a.data(), a.size());
+        numpy::underflow_handling(d, ny);
+        numpy::underflow_handling(a, ny);
+        return ny;
     }
 
-    static void extract_features(fvec& y, fvec &features)
+    static void extract_features(const float *y, size_t n, wavelet_workspace &ws, fvec &features)
     {
-        matrix_t x(1, y.size(), const_cast<float *>(y.data()));
-        matrix_t out(1, 1);
-        if (numpy::mean(&x, &out) != EIDSP_OK)
-            assert(0);
-        float mean = out.get_row_ptr(0)[0];
+        band_moments moments;
+        calculate_band_moments(y, n, moments);
 
-        calculate_entropy(y, features);
-        calculate_crossings(y, features, mean);
-        calculate_statistics(y, features, mean);
+        calculate_entropy(y, n, moments, ws, features);
+        calculate_crossings(n, moments, features);
+        calculate_statistics(y, n, moments, ws, features);
     }
 
-    static void
-    wavedec_features(const float *x, int len, const char *wav, int level, fvec &features)
+    /**
+     * Features of all levels, with the len input samples already at padded_input(ws).
+     */
+    static void wavedec_features(int len, int level, wavelet_workspace &ws)
     {
         assert(level > 0 && level < 8);
 
-        fvec h;
-        fvec g;
-        find_filter(wav, h, g);
-
+        fvec &features = ws.features;
         features.clear();
-        fvec a;
-        fvec d;
-        dwt(x, len, h.data(), g.data(), h.size(), a, d);
-        extract_features(d, features);
+
+        EI_PROFILE_START(level_start_us);
+        size_t n = dwt_padded(len, ws, ws.a, ws.d);
+        extract_features(ws.d, n, ws, features);
+        EI_PROFILE_END(level_start_us, EI_PROFILE_WAVELET_LEVEL, 1);
 
         for (int l = 1; l < level; l++) {
-            dwt(a.data(), a.size(), h.data(), g.data(), h.size(), a, d);
-            extract_features(d, features);
+            EI_PROFILE_START(level_start_us);
+            n = dwt(ws.a, n, ws, ws.a, ws.d);
+            extract_features(ws.d, n, ws, features);
+            EI_PROFILE_END(level_start_us, EI_PROFILE_WAVELET_LEVEL, l + 1);
         }
 
-        extract_features(a, features);
+        EI_PROFILE_START(approximation_start_us);
+        extract_features(ws.a, n, ws, features);
 
+        reverse_bands(features, level);
+        EI_PROFILE_END(approximation_start_us, EI_PROFILE_WAVELET_LEVEL, level + 1);
+    }
+
+    static void reverse_bands(fvec &features, int level)
+    {
         for (int l = 0; l <= level / 2; l++) { // reverse order to match python results.
             for (int i = 0; i < (int)NUM_FEATHERS_PER_COMP; i++) {
                 std::swap(
@@ -279,43 +659,83 @@ class wavelet {
         }
     }
 
-    static int dwt_features(const float *x, int len, const char *wav, int level, fvec &features)
+    static bool check_min_size(int len, int level)
     {
-        assert(level <= 7);
-
-        assert(features.size() == 0); // make sure features is empty
-        features.reserve((level + 1) * NUM_FEATHERS_PER_COMP);
+        int min_size = 32 * (1 << level);
+        return (len >= min_size);
+    }
 
-        wavedec_features(x, len, wav, level, features);
+public:
+    /**
+     * Size all scratch buffers for an input of input_len samples (bind_scratch
+     * places them). A no-op when the workspace already matches.
+     */
+    static int prepare_workspace(wavelet_workspace &ws, size_t input_len, const char *wav, int level)
+    {
+        if (ws.matches(input_len, wav, level)) {
+            return EIDSP_OK;
+        }
 
-        return features.size();
+        if (!find_filter(wav, ws.h, ws.g)) {
+            EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+        }
+        const size_t nh = ws.h.size();
+        const size_t ny = (input_len + nh - 1) / 2; // largest band, level 1
+
+        ws.padded_len = input_len + nh * 2 - 2;
+        ws.band_len = ny;
+        ws.histogram_len = ENTROPY_BINS;
+        ws.padded = ws.a = ws.d = ws.selection = ws.histogram = nullptr;
+        ws.features.clear();
+        ws.features.reserve((level + 1) * NUM_FEATHERS_PER_COMP);
+
+        ws.input_len = input_len;
+        ws.wav = wav;
+        ws.level = level;
+        return EIDSP_OK;
     }
 
-    static bool check_min_size(int len, int level)
+    /**
+     * Point the scratch buffers at one block of ws.scratch_size() floats: the DSP
+     * arena if use_arena and it has room (given back with the caller's frame),
+     * otherwise ws.storage, which only allocates the first time.
+     */
+    static int bind_scratch(wavelet_workspace &ws, bool use_arena)
     {
-        int min_size = 32 * (1 << level);
-        return (len >= min_size);
+        const size_t size = ws.scratch_size();
+        float *scratch = use_arena ? (float*)ei_dsp_arena_alloc(size * sizeof(float)) : nullptr;
+        if (!scratch) {
+            if (ws.storage.size() < size) {
+                ws.storage.resize(size);
+            }
+            scratch = ws.storage.data();
+        }
+
+        ws.padded = scratch;
+        ws.a = ws.padded + ws.padded_len;
+        ws.d = ws.a + ws.band_len;
+        ws.selection = ws.d + ws.band_len;
+        ws.histogram = ws.selection + ws.band_len;
+        return EIDSP_OK;
     }
 
-public:
-    static int extract_wavelet_features(
-        matrix_t *input_matrix,
-        matrix_t *output_matrix,
+    /**
+     * Scale and filter in place, as configured.
+     */
+    static int scale_and_filter(
+        matrix_t *matrix,
         ei_dsp_config_spectral_analysis_t *config,
         const float sampling_freq)
     {
-        // transpose the matrix so we have one row per axis
-        numpy::transpose_in_place(input_matrix);
-
         // func tests for scale of 1 and does a no op in that case
-        EI_TRY(numpy::scale(input_matrix, config->scale_axes));
+        EI_TRY(numpy::scale(matrix, config->scale_axes));
 
         // apply filter, if enabled
         // "zero" order filter allowed.  will still remove unwanted fft bins later
         if (strcmp(config->filter_type, "low") == 0) {
             if (config->filter_order) {
                 EI_TRY(spectral::processing::butterworth_lowpass_filter(
-                    input_matrix,
+                    matrix,
                     sampling_freq,
                     config->filter_cutoff,
                     config->filter_order));
@@ -324,38 +744,258 @@ public:
         else if (strcmp(config->filter_type, "high") == 0) {
             if (config->filter_order) {
                 EI_TRY(spectral::processing::butterworth_highpass_filter(
-                    input_matrix,
+                    matrix,
                     sampling_freq,
                     config->filter_cutoff,
                     config->filter_order));
             }
         }
+        return EIDSP_OK;
+    }
+
+    /**
+     * Remove the mean of the data_size samples at padded_input(ws) and write the
+     * features of all levels to output + out_idx.
+     */
+    static int padded_input_features(
+        size_t data_size,
+        matrix_t *output_matrix,
+        size_t out_idx,
+        ei_dsp_config_spectral_analysis_t *config,
+        wavelet_workspace &ws)
+    {
+        // same as processing::subtract_mean, without the temporary mean matrix
+        EI_PROFILE_START(mean_start_us);
+        float mean;
+        matrix_t row_matrix(1, data_size, padded_input(ws));
+        matrix_t mean_matrix(1, 1, &mean);
+        EI_TRY(numpy::mean(&row_matrix, &mean_matrix));
+        EI_TRY(numpy::subtract(&row_matrix, mean));
+        EI_PROFILE_END(mean_start_us, EI_PROFILE_SCALING, 1);
+
+        assert(config->wavelet_level <= 7);
+        wavedec_features(data_size, config->wavelet_level, ws);
+
+        if (out_idx + ws.features.size() > output_matrix->rows * output_matrix->cols) {
+            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+        }
+        write_features(ws.features, config, out_idx, output_matrix->buffer + out_idx);
+        return EIDSP_OK;
+    }
+
+    /**
+     * Workspace of the one-shot extractions, reused for every window. Built in
+     * static storage and never destroyed, so it is not torn down after the
+     * allocator state; init_window_workspace sizes it before the first window.
+     */
+    static wavelet_workspace &window_workspace()
+    {
+        alignas(wavelet_workspace) static uint8_t ws_storage[sizeof(wavelet_workspace)];
+        static wavelet_workspace *ws_ptr = ::new (ws_storage) wavelet_workspace();
+        return *ws_ptr;
+    }
+
+    /**
+     * Size the one-shot workspace for windows of input_len samples (init_impulse,
+     * via ei_dsp_init_workspaces), so extraction does not allocate from the first
+     * window on. The scratch goes to ws.storage up front when it cannot fit the
+     * DSP arena at all.
+     */
+    static int init_window_workspace(size_t input_len, const char *wav, int level)
+    {
+        if (!check_min_size(input_len, level)) {
+            EIDSP_ERR(EIDSP_BUFFER_SIZE_MISMATCH);
+        }
+        wavelet_workspace &ws = window_workspace();
+        EI_TRY(prepare_workspace(ws, input_len, wav, level));
+
+        ei_dsp_arena_stats_t arena;
+        ei_dsp_arena_get_stats(&arena);
+        if (ws.scratch_size() * sizeof(float) > arena.capacity && ws.storage.size() < ws.scratch_size()) {
+            ws.storage.resize(ws.scratch_size());
+        }
+        return EIDSP_OK;
+    }
+
+    static int extract_wavelet_features(
+        matrix_t *input_matrix,
+        matrix_t *output_matrix,
+        ei_dsp_config_spectral_analysis_t *config,
+        const float sampling_freq)
+    {
+        wavelet_workspace &ws = window_workspace();
+
+        // the scratch buffers of this window, in the DSP arena when it is enabled
+        dsp_arena_frame frame;
+        bool bound = false;
+
+        EI_PROFILE_START(scale_start_us);
 
-        EI_TRY(processing::subtract_mean(input_matrix));
+        // transpose the matrix so we have one row per axis
+        numpy::transpose_in_place(input_matrix);
 
-        int out_idx = 0;
+        EI_TRY(scale_and_filter(input_matrix, config, sampling_freq));
+        EI_PROFILE_END(scale_start_us, EI_PROFILE_SCALING, 0);
+
+        size_t out_idx = 0;
         for (size_t row = 0; row < input_matrix->rows; row++) {
-            float *data_window = input_matrix->get_row_ptr(row);
             size_t data_size = input_matrix->cols;
 
             if (!check_min_size(data_size, config->wavelet_level))
                 EIDSP_ERR(EIDSP_BUFFER_SIZE_MISMATCH);
 
-            fvec features;
-            size_t num_features = dwt_features(
-                data_window,
-                data_size,
-                config->wavelet,
-                config->wavelet_level,
-                features);
-
-            assert(num_features == output_matrix->cols / input_matrix->rows);
-            for (size_t i = 0; i < num_features; i++) {
-                output_matrix->buffer[out_idx++] = features[i];
+            EI_TRY(prepare_workspace(ws, data_size, config->wavelet, config->wavelet_level));
+            if (!bound) {
+                EI_TRY(bind_scratch(ws, true));
+                bound = true;
             }
+            memcpy(padded_input(ws), input_matrix->get_row_ptr(row), data_size * sizeof(float));
+            EI_TRY(padded_input_features(data_size, output_matrix, out_idx, config, ws));
+            out_idx += ws.features.size();
+        }
+        return EIDSP_OK;
+    }
+
+    /**
+     * Single-axis window straight from the signal (its spans, or get_data) into the
+     * level 1 buffer, so there is no input matrix to fill and transpose. Same
+     * features as the matrix overload.
+     */
+    static int extract_wavelet_features(
+        signal_t *signal,
+        matrix_t *output_matrix,
+        ei_dsp_config_spectral_analysis_t *config,
+        const float sampling_freq)
+    {
+        const size_t data_size = signal->total_length;
+        if (config->axes != 1) {
+            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+        }
+        if (!check_min_size(data_size, config->wavelet_level))
+            EIDSP_ERR(EIDSP_BUFFER_SIZE_MISMATCH);
+
+        wavelet_workspace &ws = window_workspace();
+        dsp_arena_frame frame;
+        EI_TRY(prepare_workspace(ws, data_size, config->wavelet, config->wavelet_level));
+        EI_TRY(bind_scratch(ws, true));
+
+        EI_PROFILE_START(copy_start_us);
+        EI_TRY(signal->get_data(0, data_size, padded_input(ws)));
+        EI_PROFILE_END(copy_start_us, EI_PROFILE_SIGNAL_COPY, 0);
+
+        EI_PROFILE_START(scale_start_us);
+        matrix_t row_matrix(1, data_size, padded_input(ws));
+        EI_TRY(scale_and_filter(&row_matrix, config, sampling_freq));
+        EI_PROFILE_END(scale_start_us, EI_PROFILE_SCALING, 0);
+
+        return padded_input_features(data_size, output_matrix, 0, config, ws);
+    }
+};
+
+/**
+ * Sliding-window wavelet features for continuous inference.
+ *
+ * Keeps the scaled window between slices and, once it is full, runs every window
+ * through the same steps as extract_wavelet_features (filter, mean removal, DWT and
+ * band statistics) in a workspace sized at init(), so the features are identical to
+ * the one-shot path and no update allocates.
+ *
+ * The DWT coefficients are not carried over from the previous window: the one-shot
+ * path zeroes coefficients below 1e-7 after mean removal at every level, which is not
+ * linear in the window mean, so shifted coefficients drift from it (and flip the
+ * crossing and entropy features) whenever the coefficients are that small.
+ */
+class wavelet_stream {
+public:
+    wavelet_stream()
+        : window_size(0), window_filled(0), level(0)
+    {
+    }
+
+    int init(size_t window_size, const ei_dsp_config_spectral_analysis_t *config)
+    {
+        if (config->wavelet_level <= 0 || config->wavelet_level >= 8) {
+            EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+        }
+        if (!wavelet::check_min_size(window_size, config->wavelet_level)) {
+            EIDSP_ERR(EIDSP_BUFFER_SIZE_MISMATCH);
+        }
+
+        this->window_size = window_size;
+        this->level = config->wavelet_level;
+        EI_TRY(wavelet::prepare_workspace(ws, window_size, config->wavelet, config->wavelet_level));
+        // kept between updates, so not in the DSP arena
+        EI_TRY(wavelet::bind_scratch(ws, false));
+
+        window.assign(window_size, 0.0f);
+        reset();
+        return EIDSP_OK;
+    }
+
+    void reset()
+    {
+        window_filled = 0;
+    }
+
+    /**
+     * Append a slice to the window and, once the window is full, compute its features.
+     * @param signal Slice of samples (single axis)
+     * @param output_matrix Receives (level + 1) * 14 features
+     * @param config DSP block config, must match the one passed to init()
+     * @param sampling_freq Sampling frequency, only used when a filter is configured
+     * @param features_ready Set to true when output_matrix was written
+     */
+    int update(
+        signal_t *signal,
+        matrix_t *output_matrix,
+        ei_dsp_config_spectral_analysis_t *config,
+        const float sampling_freq,
+        bool *features_ready)
+    {
+        *features_ready = false;
+
+        const size_t n = signal->total_length;
+        if (n == 0 || n > window_size) {
+            EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+        }
+        if (output_matrix->rows * output_matrix->cols <
+            (size_t)(level + 1) * wavelet::NUM_FEATHERS_PER_COMP) {
+            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
         }
+
+        float *tail = window.data() + window_size - n;
+        memmove(window.data(), window.data() + n, (window_size - n) * sizeof(float));
+        EI_TRY(signal->get_data(0, n, tail));
+
+        // same per-sample scaling as the one-shot path, done once per sample
+        matrix_t tail_matrix(1, n, tail);
+        EI_TRY(numpy::scale(&tail_matrix, config->scale_axes));
+
+        window_filled = std::min(window_filled + n, window_size);
+        if (window_filled < window_size) {
+            return EIDSP_OK;
+        }
+
+        // the window is already scaled, the filter (if any) runs over all of it
+        ei_dsp_config_spectral_analysis_t unscaled = *config;
+        unscaled.scale_axes = 1.0f;
+
+        memcpy(wavelet::padded_input(ws), window.data(), window_size * sizeof(float));
+        matrix_t row_matrix(1, window_size, wavelet::padded_input(ws));
+        EI_TRY(wavelet::scale_and_filter(&row_matrix, &unscaled, sampling_freq));
+        EI_TRY(wavelet::padded_input_features(window_size, output_matrix, 0, config, ws));
+
+        *features_ready = true;
         return EIDSP_OK;
     }
+
+private:
+    size_t window_size;
+    size_t window_filled;
+    int level;
+
+    wavelet_workspace ws;
+    fvec window;
 };
 
 }
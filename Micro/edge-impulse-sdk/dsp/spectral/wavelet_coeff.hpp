@@ -81,10 +81,12 @@ static const std::array<std::array<float, 12>, 2> bior3p5 = {{
     {{-0.0, 0.0, -0.0, 0.0, -0.1767766952966369, 0.5303300858899106, -0.5303300858899106, 0.1767766952966369, -0.0, 0.0, -0.0, 0.0}}
 }};
 
-static const std::array<std::array<float, 16>, 2> bior3p7 = {{
-    {{0.0030210861012608843, -0.009063258303782653, -0.01683176542131064, 0.074663985074019, 0.03133297870736289, -0.301159125922835, -0.02649924094534547, 0.9516421218971786, 0.9516421218971786, -0.02649924094534547, -0.301159125922835, 0.03133297870736289, 0.074663985074019, -0.01683176542131064, -0.009063258303782653, 0.0030210861012608843}},
-    {{-0.0, 0.0, -0.0, 0.0, -0.0, 0.0, -0.1767766952966369, 0.5303300858899106, -0.5303300858899106, 0.1767766952966369, -0.0, 0.0, -0.0, 0.0, -0.0, 0.0}}
-}};
+// A plain constexpr array, unlike its neighbours, so that wavelet_bior3p7 below can
+// read its taps at compile time (C++11 std::array has no constexpr element access)
+constexpr float bior3p7[2][16] = {
+    {0.0030210861012608843, -0.009063258303782653, -0.01683176542131064, 0.074663985074019, 0.03133297870736289, -0.301159125922835, -0.02649924094534547, 0.9516421218971786, 0.9516421218971786, -0.02649924094534547, -0.301159125922835, 0.03133297870736289, 0.074663985074019, -0.01683176542131064, -0.009063258303782653, 0.0030210861012608843},
+    {-0.0, 0.0, -0.0, 0.0, -0.0, 0.0, -0.1767766952966369, 0.5303300858899106, -0.5303300858899106, 0.1767766952966369, -0.0, 0.0, -0.0, 0.0, -0.0, 0.0}
+};
 
 static const std::array<std::array<float, 20>, 2> bior3p9 = {{
     {{-0.0006797443727836989, 0.002039233118351097, 0.005060319219611981, -0.020618912641105536, -0.014112787930175844, 0.09913478249423216, 0.012300136269419315, -0.32019196836077857, 0.0020500227115698858, 0.9421257006782068, 0.9421257006782068, 0.0020500227115698858, -0.32019196836077857, 0.012300136269419315, 0.09913478249423216, -0.014112787930175844, -0.020618912641105536, 0.005060319219611981, 0.002039233118351097, -0.0006797443727836989}},
@@ -286,5 +288,17 @@ static const std::array<std::array<float, 20>, 2> sym10 = {{
     {{0.0004593294210046588, 5.7036083618494284e-05, -0.004593173585311828, -0.0008043589320165449, 0.02035493981231129, 0.005764912033581909, -0.04999497207737669, -0.0319900568824278, 0.03553674047381755, 0.38382676106708546, -0.7695100370211071, 0.47169066693843925, 0.07088053578324385, -0.15949427888491757, -0.011609893903711381, 0.0459272392310922, 0.0014653825813050513, -0.008641299277022422, -9.563267072289475e-05, 0.0007701598091144901}}
 }};
 
+
+/**
+ * Filters that can be fixed at build time (see EIDSP_WAVELET_FIXED_FILTER in wavelet.hpp),
+ * read straight from the tables above so that the unrolled DWT kernel sees immediates.
+ */
+struct wavelet_bior3p7 {
+    static constexpr size_t length = 16;
+    static const char *name() { return "bior3.7"; }
+    static constexpr float dec_lo(size_t i) { return bior3p7[0][i]; }
+    static constexpr float dec_hi(size_t i) { return bior3p7[1][i]; }
+};
+
 }
 }
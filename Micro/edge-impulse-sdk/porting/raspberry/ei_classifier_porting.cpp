@@ -77,19 +77,14 @@ void ei_putchar(char c)
 }
 
 /**
- *  Printf function uses vsnprintf and output using USB Serial
+ *  Printf function formats straight into stdio (USB Serial), without an
+ *  intermediate buffer that would be formatted a second time
  */
 __attribute__((weak)) void ei_printf(const char *format, ...) {
-    static char print_buf[1024] = { 0 };
-
     va_list args;
     va_start(args, format);
-    int r = vsnprintf(print_buf, sizeof(print_buf), format, args);
+    vprintf(format, args);
     va_end(args);
-
-    if (r > 0) {
-       printf(print_buf);
-    }
 }
 
 __attribute__((weak)) void ei_printf_float(float f) {
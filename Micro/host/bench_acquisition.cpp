@@ -0,0 +1,180 @@
+/* Acquisition benchmark (host only)
+ *
+ * 1. Block kernel: acquisition_decimate() on full DMA blocks against the
+ *    scalar sum / ADC_SAMPLES reference, checked for identical output and
+ *    timed against the previous path of 64 adc_read() calls per sample.
+ * 2. Fake ADC + DMA: drives acquisition_poll() from a 1 ms main loop for a
+ *    simulated hour and checks that every sample arrives exactly once, then
+ *    stalls the loop for longer than a block and checks that the overrun is
+ *    reported.
+ *
+ * The process exits with status 1 on the first failed check.
+ *
+ * Usage: bench_acquisition [iterations]   (default 20000 blocks)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "acquisition.h"
+#include "host_hal.h"
+
+#define BENCH_DEFAULT_ITERATIONS 20000
+#define BENCH_SAMPLE_RATE_HZ     100
+#define BENCH_OVERSAMPLE         64
+#define BENCH_RUN_S              3600
+#define BENCH_STALL_MS           500
+
+static uint16_t bench_raw[ACQ_BLOCK_CODES] __attribute__((aligned(4)));
+static uint32_t rng_state = 0x2545F491u;
+
+
+/* ========================================================================= */
+/* HELPERS                                                                   */
+/* ========================================================================= */
+
+static uint16_t next_code(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (uint16_t)(rng_state & 0x0FFF);
+}
+
+static void decimate_reference(const uint16_t *raw, size_t out_count, uint32_t factor, uint16_t *out) {
+    for (size_t k = 0; k < out_count; k++) {
+        uint32_t sum = 0;
+        for (uint32_t i = 0; i < factor; i++) {
+            sum += raw[k * factor + i];
+        }
+        out[k] = (uint16_t)(sum / factor);
+    }
+}
+
+
+/* ========================================================================= */
+/* BLOCK KERNEL                                                              */
+/* ========================================================================= */
+
+static bool bench_kernel(long iterations) {
+    const size_t out_count = ACQ_BLOCK_CODES / BENCH_OVERSAMPLE;
+    uint16_t ref[ACQ_BLOCK_CODES];
+    uint16_t out[ACQ_BLOCK_CODES];
+
+    for (int trial = 0; trial < 64; trial++) {
+        for (size_t i = 0; i < ACQ_BLOCK_CODES; i++) {
+            // include full-scale codes to exercise the largest sums
+            bench_raw[i] = (trial == 0) ? 4095 : next_code();
+        }
+        decimate_reference(bench_raw, out_count, BENCH_OVERSAMPLE, ref);
+        acquisition_decimate(bench_raw, out_count, BENCH_OVERSAMPLE, out);
+        if (memcmp(ref, out, out_count * sizeof(uint16_t)) != 0) {
+            fprintf(stderr, "Block kernel mismatch in trial %d\n", trial);
+            return false;
+        }
+    }
+
+    volatile uint32_t sink = 0;  // keeps the results alive
+    double start = host_wall_time_s();
+    for (long it = 0; it < iterations; it++) {
+        acquisition_decimate(bench_raw, out_count, BENCH_OVERSAMPLE, out);
+        sink += out[it % out_count];
+    }
+    double block_s = host_wall_time_s() - start;
+
+    // previous path: ADC_SAMPLES blocking adc_read() calls per output sample
+    start = host_wall_time_s();
+    for (long it = 0; it < iterations; it++) {
+        for (size_t k = 0; k < out_count; k++) {
+            uint32_t sum = 0;
+            for (int i = 0; i < BENCH_OVERSAMPLE; i++) {
+                sum += adc_read();
+            }
+            sink += sum / BENCH_OVERSAMPLE;
+        }
+    }
+    double poll_s = host_wall_time_s() - start;
+
+    double samples = (double)iterations * out_count;
+    printf("Averaging %d codes per sample (%zu samples per block, %ld blocks)\n",
+           BENCH_OVERSAMPLE, out_count, iterations);
+    printf("    adc_read() loop:  %8.2f ns/sample\n", poll_s * 1e9 / samples);
+    printf("    block kernel:     %8.2f ns/sample\n", block_s * 1e9 / samples);
+    return true;
+}
+
+
+/* ========================================================================= */
+/* FAKE ADC + DMA                                                            */
+/* ========================================================================= */
+
+static bool bench_stream(void) {
+    uint16_t codes[ACQ_BLOCK_CODES];
+    uint64_t first_index = 0;
+    uint64_t expected_index = 0;
+
+    if (!acquisition_start(BENCH_SAMPLE_RATE_HZ, BENCH_OVERSAMPLE)) {
+        fprintf(stderr, "acquisition_start failed\n");
+        return false;
+    }
+
+    double start = host_wall_time_s();
+    for (uint32_t ms = 0; ms < BENCH_RUN_S * 1000; ms++) {
+        size_t count;
+        while ((count = acquisition_poll(codes, ACQ_BLOCK_CODES, &first_index)) > 0) {
+            if (first_index != expected_index) {
+                fprintf(stderr, "Sample index %llu, expected %llu\n",
+                        (unsigned long long)first_index, (unsigned long long)expected_index);
+                return false;
+            }
+            expected_index += count;
+        }
+        sleep_ms(1);
+    }
+    double stream_s = host_wall_time_s() - start;
+
+    // the last block may still be filling
+    uint64_t due = (uint64_t)BENCH_RUN_S * BENCH_SAMPLE_RATE_HZ;
+    if (expected_index + acquisition_block_samples() < due || acquisition_overruns() != 0) {
+        fprintf(stderr, "Received %llu of %llu samples, %u overruns\n",
+                (unsigned long long)expected_index, (unsigned long long)due, acquisition_overruns());
+        return false;
+    }
+
+    // a stalled main loop loses blocks and must say so
+    sleep_ms(BENCH_STALL_MS);
+    acquisition_poll(codes, ACQ_BLOCK_CODES, &first_index);
+    if (acquisition_overruns() == 0) {
+        fprintf(stderr, "Stall of %d ms was not reported as an overrun\n", BENCH_STALL_MS);
+        return false;
+    }
+
+    printf("Fake ADC + DMA, %d s simulated from a 1 ms loop\n", BENCH_RUN_S);
+    printf("    samples:          %llu, none lost\n", (unsigned long long)expected_index);
+    printf("    wall time:        %8.3f s\n", stream_s);
+    printf("    %d ms stall:     %u blocks overrun\n", BENCH_STALL_MS, acquisition_overruns());
+    return true;
+}
+
+
+/* ========================================================================= */
+/* MAIN                                                                      */
+/* ========================================================================= */
+
+int main(int argc, char **argv) {
+    long iterations = argc > 1 ? strtol(argv[1], NULL, 10) : BENCH_DEFAULT_ITERATIONS;
+    if (iterations <= 0) {
+        iterations = BENCH_DEFAULT_ITERATIONS;
+    }
+
+    // mid-scale noise source, long enough for both parts
+    setenv("SEISMIC_HOST_DURATION_S", "100000", 0);
+    unsetenv("SEISMIC_ADC_FILE");
+    stdio_init_all();
+
+    if (!bench_kernel(iterations) || !bench_stream()) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,312 @@
+/* Alert engine check (host only)
+ *
+ * 1. Patterns: plays every level's pattern from a 1 ms loop and checks each
+ *    LED / buzzer edge against the pattern table, to within one tick, plus
+ *    the held alert LED, alert_clear(), the silenced buzzer and that a
+ *    lower level does not cut a critical pattern short.
+ * 2. Acquisition during alerts: runs the fake ADC + DMA and the alert engine
+ *    from one 1 ms loop (acquisition and alerting on the same core, the
+ *    worst case) and raises a critical alert every few seconds. Every
+ *    sample must arrive, in order, with no overrun. The same loop with the
+ *    previous sleep_ms() pattern is run for comparison and its losses are
+ *    reported.
+ *
+ * The process exits with status 1 on the first failed check.
+ *
+ * Usage: bench_alert [seconds]   (default 120 s of acquisition per loop)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "pico/stdlib.h"
+#include "acquisition.h"
+#include "alert.h"
+
+#define BENCH_DEFAULT_SECONDS   120
+#define BENCH_SAMPLE_RATE_HZ    100
+#define BENCH_OVERSAMPLE        64
+#define BENCH_ALERT_PERIOD_MS   3000
+
+// As main.cpp
+#define LED_BUILTIN         25
+#define LED_STATUS          15
+#define LED_ALERT           14
+#define BUZZER_PIN          16
+
+static const unsigned int output_pins[ALERT_OUTPUT_COUNT] = { LED_STATUS, LED_ALERT, BUZZER_PIN, LED_BUILTIN };
+
+typedef struct {
+    uint32_t t_ms;              // From the request
+    uint8_t outputs;            // ALERT_OUT_* on from t_ms
+} output_edge_t;
+
+
+/* ========================================================================= */
+/* HELPERS                                                                   */
+/* ========================================================================= */
+
+static uint8_t read_outputs(void) {
+    uint8_t outputs = 0;
+    for (int i = 0; i < ALERT_OUTPUT_COUNT; i++) {
+        outputs |= gpio_get(output_pins[i]) ? (uint8_t)(1u << i) : 0;
+    }
+    return outputs;
+}
+
+// Edges of the outputs from now for duration_ms, polled every ms like the
+// main loop
+static std::vector<output_edge_t> record_outputs(uint32_t duration_ms) {
+    std::vector<output_edge_t> edges;
+    uint8_t last = read_outputs();
+    for (uint32_t ms = 0; ms <= duration_ms; ms++) {
+        alert_poll();
+        uint8_t outputs = read_outputs();
+        if (outputs != last) {
+            edges.push_back({ ms, outputs });
+            last = outputs;
+        }
+        sleep_ms(1);
+    }
+    return edges;
+}
+
+// Edges the pattern table asks for, buzzer masked when silenced
+static std::vector<output_edge_t> expected_edges(const alert_pattern_t *pattern, bool silenced) {
+    std::vector<output_edge_t> edges;
+    uint32_t t_ms = 0;
+    uint8_t last = 0;
+    uint8_t mask = silenced ? (uint8_t)~ALERT_OUT_BUZZER : 0xFF;
+    for (uint8_t s = 0; s < pattern->segment_count; s++) {
+        const alert_segment_t *segment = &pattern->segments[s];
+        for (uint8_t b = 0; b < segment->count; b++) {
+            uint8_t phases[2] = { (uint8_t)(segment->outputs & mask), 0 };
+            uint16_t times[2] = { segment->on_ms, segment->off_ms };
+            for (int p = 0; p < 2; p++) {
+                if (phases[p] != last) {
+                    edges.push_back({ t_ms, phases[p] });
+                    last = phases[p];
+                }
+                t_ms += times[p];
+            }
+        }
+    }
+    if (pattern->hold != last) {
+        edges.push_back({ t_ms, pattern->hold });
+    }
+    return edges;
+}
+
+// Same outputs in the same order, each edge within one tick of its
+// scheduled time (plus the 1 ms poll either way)
+static bool compare_edges(const char *name, const std::vector<output_edge_t> &got,
+                          const std::vector<output_edge_t> &want) {
+    const uint32_t slack_ms = ALERT_TICK_US / 1000 + 1;
+    if (got.size() != want.size()) {
+        fprintf(stderr, "%s: %zu edges, expected %zu\n", name, got.size(), want.size());
+        return false;
+    }
+    for (size_t i = 0; i < got.size(); i++) {
+        if (got[i].outputs != want[i].outputs || got[i].t_ms + 1 < want[i].t_ms ||
+            got[i].t_ms > want[i].t_ms + slack_ms) {
+            fprintf(stderr, "%s: edge %zu is 0x%02x at %u ms, expected 0x%02x at %u ms\n", name, i,
+                    got[i].outputs, got[i].t_ms, want[i].outputs, want[i].t_ms);
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/* ========================================================================= */
+/* PATTERNS                                                                  */
+/* ========================================================================= */
+
+static bool check_patterns(void) {
+    static const char *names[DETECTION_LEVEL_COUNT] = { "none", "low", "high", "critical" };
+
+    for (int silenced = 0; silenced <= 1; silenced++) {
+        alert_set_silenced(silenced != 0);
+        for (int level = DETECTION_LOW; level < DETECTION_LEVEL_COUNT; level++) {
+            const alert_pattern_t *pattern = alert_pattern((detection_level_t)level);
+            alert_play((detection_level_t)level);
+            std::vector<output_edge_t> got = record_outputs(alert_pattern_ms(pattern) + 100);
+            if (!compare_edges(names[level], got, expected_edges(pattern, silenced != 0))) {
+                return false;
+            }
+            if (alert_active()) {
+                fprintf(stderr, "%s: still active after the pattern\n", names[level]);
+                return false;
+            }
+            alert_clear();
+            record_outputs(10);
+            if (read_outputs() != 0) {
+                fprintf(stderr, "%s: outputs 0x%02x left on after alert_clear()\n", names[level], read_outputs());
+                return false;
+            }
+        }
+    }
+    alert_set_silenced(false);
+
+    // A low alert in the middle of a critical one is ignored
+    const alert_pattern_t *critical = alert_pattern(DETECTION_CRITICAL);
+    alert_play(DETECTION_CRITICAL);
+    record_outputs(300);
+    alert_play(DETECTION_LOW);
+    std::vector<output_edge_t> rest = record_outputs(alert_pattern_ms(critical));
+    for (const output_edge_t &edge : rest) {
+        if (edge.outputs & ALERT_OUT_STATUS) {
+            fprintf(stderr, "A low alert interrupted the critical pattern\n");
+            return false;
+        }
+    }
+    alert_clear();
+    record_outputs(10);
+
+    // Button feedback runs next to an alert
+    alert_play(DETECTION_HIGH);
+    alert_feedback(false);
+    std::vector<output_edge_t> both = record_outputs(1000);
+    int feedback_blinks = 0;
+    uint8_t last = 0;
+    for (const output_edge_t &edge : both) {
+        feedback_blinks += (edge.outputs & ALERT_OUT_FEEDBACK) && !(last & ALERT_OUT_FEEDBACK);
+        last = edge.outputs;
+    }
+    if (feedback_blinks != 3) {
+        fprintf(stderr, "Feedback blinked %d times next to an alert, expected 3\n", feedback_blinks);
+        return false;
+    }
+    record_outputs(1500);
+    alert_clear();
+    record_outputs(10);
+
+    printf("Patterns (tick %d ms)\n", ALERT_TICK_US / 1000);
+    for (int level = DETECTION_LOW; level < DETECTION_LEVEL_COUNT; level++) {
+        const alert_pattern_t *pattern = alert_pattern((detection_level_t)level);
+        printf("    %-9s %5u ms, %zu edges as in the table\n", names[level],
+               alert_pattern_ms(pattern), expected_edges(pattern, false).size());
+    }
+    return true;
+}
+
+
+/* ========================================================================= */
+/* ACQUISITION DURING ALERTS                                                 */
+/* ========================================================================= */
+
+// The previous alert_critical(): LED and buzzer toggled between sleeps
+static void blocking_critical(void) {
+    for (int i = 0; i < 10; i++) {
+        gpio_put(LED_ALERT, 1);
+        sleep_ms(50);
+        gpio_put(LED_ALERT, 0);
+        sleep_ms(50);
+    }
+    for (int i = 0; i < 5; i++) {
+        gpio_put(BUZZER_PIN, 1);
+        sleep_ms(100);
+        gpio_put(BUZZER_PIN, 0);
+        sleep_ms(100);
+    }
+    gpio_put(LED_ALERT, 1);
+}
+
+typedef struct {
+    uint64_t samples;
+    uint64_t lost;
+    uint32_t overruns;
+    uint32_t alerts;
+} stream_result_t;
+
+static stream_result_t stream_with_alerts(uint32_t seconds, bool blocking) {
+    uint16_t codes[ACQ_BLOCK_CODES];
+    uint64_t first_index = 0;
+    uint64_t expected_index = 0;
+    stream_result_t result = { 0, 0, 0, 0 };
+    uint32_t overruns_before = acquisition_overruns();
+
+    // Restarting resets the sample index, as after boot
+    acquisition_start(BENCH_SAMPLE_RATE_HZ, BENCH_OVERSAMPLE);
+    const uint64_t start_us = time_us_64();
+    const uint64_t end_us = start_us + seconds * 1000000ULL;
+    uint64_t next_alert_us = start_us + BENCH_ALERT_PERIOD_MS * 500ULL;
+
+    while (time_us_64() < end_us) {
+        size_t count;
+        while ((count = acquisition_poll(codes, ACQ_BLOCK_CODES, &first_index)) > 0) {
+            if (first_index > expected_index) {
+                result.lost += first_index - expected_index;
+            }
+            expected_index = first_index + count;
+            result.samples += count;
+        }
+
+        if (time_us_64() >= next_alert_us) {
+            next_alert_us += BENCH_ALERT_PERIOD_MS * 1000ULL;
+            if (blocking) {
+                blocking_critical();
+            } else {
+                alert_play(DETECTION_CRITICAL);
+            }
+            result.alerts++;
+        }
+        alert_poll();
+        sleep_ms(1);
+    }
+
+    result.overruns = acquisition_overruns() - overruns_before;
+    alert_clear();
+    return result;
+}
+
+static bool check_stream(uint32_t seconds) {
+    stream_result_t engine = stream_with_alerts(seconds, false);
+    stream_result_t blocking = stream_with_alerts(seconds, true);
+
+    printf("Acquisition and alerts in one 1 ms loop, %u s, critical alert every %d ms\n",
+           seconds, BENCH_ALERT_PERIOD_MS);
+    printf("    alert engine:     %llu samples, %llu lost, %u overruns (%u alerts)\n",
+           (unsigned long long)engine.samples, (unsigned long long)engine.lost, engine.overruns, engine.alerts);
+    printf("    sleep_ms pattern: %llu samples, %llu lost, %u overruns (%u alerts)\n",
+           (unsigned long long)blocking.samples, (unsigned long long)blocking.lost, blocking.overruns, blocking.alerts);
+
+    // the last block may still be filling
+    uint64_t due = (uint64_t)seconds * BENCH_SAMPLE_RATE_HZ;
+    if (engine.lost != 0 || engine.overruns != 0 || engine.samples + acquisition_block_samples() < due) {
+        fprintf(stderr, "Samples were lost during alerts\n");
+        return false;
+    }
+    return true;
+}
+
+
+/* ========================================================================= */
+/* MAIN                                                                      */
+/* ========================================================================= */
+
+int main(int argc, char **argv) {
+    long seconds = argc > 1 ? strtol(argv[1], NULL, 10) : BENCH_DEFAULT_SECONDS;
+    if (seconds <= 0) {
+        seconds = BENCH_DEFAULT_SECONDS;
+    }
+
+    // mid-scale noise source, long enough for every part
+    setenv("SEISMIC_HOST_DURATION_S", "100000", 0);
+    unsetenv("SEISMIC_ADC_FILE");
+    stdio_init_all();
+
+    for (int i = 0; i < ALERT_OUTPUT_COUNT; i++) {
+        gpio_init(output_pins[i]);
+        gpio_set_dir(output_pins[i], GPIO_OUT);
+    }
+    if (!alert_init(LED_STATUS, LED_ALERT, BUZZER_PIN, LED_BUILTIN)) {
+        fprintf(stderr, "alert_init failed\n");
+        return 1;
+    }
+
+    if (!check_patterns() || !check_stream((uint32_t)seconds)) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,129 @@
+/* Heap allocations of the inference path (host only)
+ *
+ * Counts every allocation the SDK makes (heap_counters.h: the porting
+ * layer's ei_malloc, ei_calloc and ei_free and the global operator new /
+ * delete). Runs the whole impulse (run_classifier) on synthetic windows:
+ *
+ * 1. Warm-up: the first runs report what they allocate (init_impulse sizes
+ *    the DSP workspaces, so nothing with EI_CLASSIFIER_PLANNED_STORAGE).
+ * 2. Steady state: every later run must not allocate or free anything
+ *    (with EI_CLASSIFIER_PLANNED_STORAGE; otherwise the counts are only
+ *    reported).
+ * 3. DSP arena: high-water mark of the DSP temporaries and, with
+ *    EI_CLASSIFIER_SHARED_ARENA, of the tensor arena it lends to the graph
+ *    over all runs, the EI_DSP_ARENA_SIZE to configure, and how many
+ *    temporaries did not fit.
+ *
+ * The process exits with status 1 if a planned build allocates in the
+ * steady state, a DSP temporary did not fit the arena or the impulse fails.
+ *
+ * Usage: bench_allocations [windows]   (default 1000 steady-state runs)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "model-parameters/model_metadata.h"
+#include "edge-impulse-sdk/dsp/ei_dsp_arena.h"
+#include "model_windows.h"
+#include "heap_counters.h"
+
+#define BENCH_DEFAULT_WINDOWS   1000
+#define BENCH_WARMUP_WINDOWS    4
+#define BENCH_SEED              0x6A09E667u
+
+#ifndef EI_CLASSIFIER_PLANNED_STORAGE
+#define EI_CLASSIFIER_PLANNED_STORAGE 0
+#endif
+
+
+/* ========================================================================= */
+/* RUNS                                                                      */
+/* ========================================================================= */
+
+// Counters over `windows` runs of the impulse
+static bool run_windows(uint32_t *state, long windows, heap_counters_t *out) {
+    float window[MODEL_WINDOW_SAMPLES];
+    float probs[MODEL_WINDOW_LABELS];
+    heap_counters_t total = { 0, 0, 0 };
+
+    for (long w = 0; w < windows; w++) {
+        model_windows_synthetic(state, window);
+
+        heap_counters_reset();
+        bool ok = model_windows_classify(window, probs);
+        heap_counters_t run = heap_counters;
+        if (!ok) {
+            fprintf(stderr, "run_classifier failed on window %ld\n", w);
+            return false;
+        }
+        total.allocations += run.allocations;
+        total.frees += run.frees;
+        total.bytes += run.bytes;
+    }
+    *out = total;
+    return true;
+}
+
+static void print_counters(const char *name, long windows, const heap_counters_t *c) {
+    printf("    %-13s %5ld runs  %8zu allocations  %8zu frees  %10zu bytes  (%.1f allocations per run)\n",
+           name, windows, c->allocations, c->frees, c->bytes,
+           windows > 0 ? (double)c->allocations / windows : 0.0);
+}
+
+
+/* ========================================================================= */
+/* MAIN                                                                      */
+/* ========================================================================= */
+
+int main(int argc, char **argv) {
+    long windows = argc > 1 ? strtol(argv[1], NULL, 10) : BENCH_DEFAULT_WINDOWS;
+    if (windows <= 0) {
+        windows = BENCH_DEFAULT_WINDOWS;
+    }
+
+    heap_counters_reset();
+    if (!model_windows_init()) {
+        fprintf(stderr, "Failed to initialize the impulse\n");
+        return 1;
+    }
+    heap_counters_t init = heap_counters;
+
+    uint32_t state = BENCH_SEED;
+    heap_counters_t warmup, steady;
+    if (!run_windows(&state, BENCH_WARMUP_WINDOWS, &warmup) || !run_windows(&state, windows, &steady)) {
+        return 1;
+    }
+
+    printf("Heap use of run_classifier (%s)\n",
+           EI_CLASSIFIER_PLANNED_STORAGE ? "planned storage" : "heap storage");
+    print_counters("init", 0, &init);
+    print_counters("warm-up", BENCH_WARMUP_WINDOWS, &warmup);
+    print_counters("steady state", windows, &steady);
+
+    ei_dsp_arena_stats_t arena;
+    ei_dsp_arena_get_stats(&arena);
+    if (arena.capacity > 0) {
+        printf("DSP arena: peak %zu of %zu bytes, %zu overflows\n", arena.peak, arena.capacity, arena.overflows);
+        if (arena.lent > 0) {
+            printf("    tensor arena lent to the graph: %zu bytes\n", arena.lent);
+        }
+        if (arena.kept > 0) {
+            printf("    features written into the input tensor: %zu bytes kept\n", arena.kept);
+        }
+    }
+    else {
+        printf("DSP arena: disabled (EI_DSP_ARENA_SIZE=0)\n");
+    }
+
+    if (EI_CLASSIFIER_PLANNED_STORAGE && (steady.allocations != 0 || steady.frees != 0)) {
+        fprintf(stderr, "FAIL: run_classifier allocated in the steady state\n");
+        return 1;
+    }
+    if (arena.overflows != 0) {
+        fprintf(stderr, "FAIL: DSP temporaries did not fit the arena, raise EI_DSP_ARENA_SIZE to %zu or more\n",
+                arena.peak);
+        return 1;
+    }
+    return 0;
+}
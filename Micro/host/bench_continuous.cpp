@@ -0,0 +1,210 @@
+/* Continuous (sliced) inference check (host only)
+ *
+ * Feeds a synthetic trace (STEAD counts, windows with and without events
+ * back to back) to run_classifier_continuous in slices, the sliding wavelet
+ * window of ei_run_dsp.h (spectral::wavelet_stream), and checks it against
+ * the batch path on the same windows:
+ *
+ * 1. Equivalence: for slices of 1, 7, 8, 100, 125, 250, 333 and 1000
+ *    samples, no window before the first MODEL_WINDOW_SAMPLES samples, then
+ *    on every slice the features and class probabilities must equal
+ *    model_windows_features() / model_windows_classify() on the window
+ *    ending at that slice, exactly (the stream runs each window through the
+ *    same steps as the batch path).
+ * 2. Heap: once the window is full, no call may allocate or free anything
+ *    (heap_counters.h; with EI_CLASSIFIER_PLANNED_STORAGE, otherwise the
+ *    counts are only reported).
+ * 3. Latency: time per slice and per classified window of the continuous
+ *    path against run_classifier on the same windows.
+ *
+ * The process exits with status 1 on the first failed check.
+ *
+ * Usage: bench_continuous [samples]   (default 6000 samples per slice size)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include "model_windows.h"
+#include "heap_counters.h"
+#include "host_hal.h"
+
+#define BENCH_DEFAULT_SAMPLES   6000
+#define BENCH_SEED              0xBB67AE85u
+
+#ifndef EI_CLASSIFIER_PLANNED_STORAGE
+#define EI_CLASSIFIER_PLANNED_STORAGE 0
+#endif
+
+static const size_t slice_sizes[] = { 1, 7, 8, 100, 125, 250, 333, 1000 };
+
+typedef struct {
+    size_t slices;
+    size_t windows;             // Slices that classified a window
+    float feature_error;        // Largest relative difference, must be 0
+    float prob_error;
+    heap_counters_t heap;       // Once the window is full
+} slice_run_t;
+
+
+/* ========================================================================= */
+/* HELPERS                                                                   */
+/* ========================================================================= */
+
+static float relative_error(float value, float reference) {
+    return fabsf(value - reference) / (1.0f + fabsf(reference));
+}
+
+static float max_error(const float *values, const float *reference, size_t count) {
+    float error = 0.0f;
+    for (size_t i = 0; i < count; i++) {
+        float e = relative_error(values[i], reference[i]);
+        error = e > error ? e : error;
+    }
+    return error;
+}
+
+// Back-to-back synthetic windows in STEAD counts, the scale the model knows
+static std::vector<float> make_trace(size_t samples) {
+    std::vector<float> trace((samples / MODEL_WINDOW_SAMPLES + 1) * MODEL_WINDOW_SAMPLES);
+    uint32_t state = BENCH_SEED;
+    for (size_t i = 0; i < trace.size(); i += MODEL_WINDOW_SAMPLES) {
+        model_windows_synthetic_scaled(&state, MODEL_WINDOW_COUNTS, &trace[i]);
+    }
+    trace.resize(samples);
+    return trace;
+}
+
+
+/* ========================================================================= */
+/* EQUIVALENCE                                                               */
+/* ========================================================================= */
+
+static bool check_slices(const std::vector<float> &trace, size_t slice, slice_run_t *run) {
+    float features[MODEL_WINDOW_FEATURES], probs[MODEL_WINDOW_LABELS];
+    float ref_features[MODEL_WINDOW_FEATURES], ref_probs[MODEL_WINDOW_LABELS];
+    *run = (slice_run_t){ 0, 0, 0.0f, 0.0f, { 0, 0, 0 } };
+
+    model_windows_continuous_init();
+    for (size_t end = slice; end <= trace.size(); end += slice) {
+        bool ready;
+        heap_counters_reset();
+        bool ok = model_windows_continuous(&trace[end - slice], slice, features, probs, &ready);
+        heap_counters_t call = heap_counters;
+        if (!ok) {
+            fprintf(stderr, "slice %zu: run_classifier_continuous failed at sample %zu\n", slice, end);
+            return false;
+        }
+        run->slices++;
+        if (ready != (end >= MODEL_WINDOW_SAMPLES)) {
+            fprintf(stderr, "slice %zu: window %s at sample %zu\n", slice, ready ? "classified" : "missing", end);
+            return false;
+        }
+        if (!ready) {
+            continue;
+        }
+
+        // The call that fills the window sets the stream up, count from the next
+        if (run->windows > 0) {
+            run->heap.allocations += call.allocations;
+            run->heap.frees += call.frees;
+            run->heap.bytes += call.bytes;
+        }
+        run->windows++;
+
+        const float *window = &trace[end - MODEL_WINDOW_SAMPLES];
+        if (!model_windows_features(window, ref_features) || !model_windows_classify(window, ref_probs)) {
+            fprintf(stderr, "slice %zu: batch path failed at sample %zu\n", slice, end);
+            return false;
+        }
+        float feature_error = max_error(features, ref_features, MODEL_WINDOW_FEATURES);
+        float prob_error = max_error(probs, ref_probs, MODEL_WINDOW_LABELS);
+        if (feature_error != 0.0f || prob_error != 0.0f) {
+            fprintf(stderr, "slice %zu: window ending at sample %zu differs from the batch path "
+                    "(features %.2e, probabilities %.2e)\n", slice, end, (double)feature_error, (double)prob_error);
+            return false;
+        }
+        run->feature_error = feature_error > run->feature_error ? feature_error : run->feature_error;
+        run->prob_error = prob_error > run->prob_error ? prob_error : run->prob_error;
+    }
+    return true;
+}
+
+
+/* ========================================================================= */
+/* LATENCY                                                                   */
+/* ========================================================================= */
+
+// Seconds for all slices of the trace through the continuous path
+static double time_continuous(const std::vector<float> &trace, size_t slice) {
+    float features[MODEL_WINDOW_FEATURES], probs[MODEL_WINDOW_LABELS];
+    bool ready;
+    model_windows_continuous_init();
+    double t0 = host_wall_time_s();
+    for (size_t end = slice; end <= trace.size(); end += slice) {
+        model_windows_continuous(&trace[end - slice], slice, features, probs, &ready);
+    }
+    return host_wall_time_s() - t0;
+}
+
+// Seconds for run_classifier on the windows the continuous path classifies
+static double time_batch(const std::vector<float> &trace, size_t slice) {
+    float probs[MODEL_WINDOW_LABELS];
+    double t0 = host_wall_time_s();
+    for (size_t end = slice; end <= trace.size(); end += slice) {
+        if (end >= MODEL_WINDOW_SAMPLES) {
+            model_windows_classify(&trace[end - MODEL_WINDOW_SAMPLES], probs);
+        }
+    }
+    return host_wall_time_s() - t0;
+}
+
+
+/* ========================================================================= */
+/* MAIN                                                                      */
+/* ========================================================================= */
+
+int main(int argc, char **argv) {
+    long samples = argc > 1 ? strtol(argv[1], NULL, 10) : BENCH_DEFAULT_SAMPLES;
+    if (samples < 2 * MODEL_WINDOW_SAMPLES) {
+        fprintf(stderr, "Usage: %s [samples]   (at least %d)\n", argv[0], 2 * MODEL_WINDOW_SAMPLES);
+        return 1;
+    }
+    if (!model_windows_init()) {
+        fprintf(stderr, "Failed to initialize the impulse\n");
+        return 1;
+    }
+    std::vector<float> trace = make_trace((size_t)samples);
+    const size_t sizes = sizeof(slice_sizes) / sizeof(slice_sizes[0]);
+
+    printf("Continuous vs batch (%ld samples, %s)\n", samples,
+           EI_CLASSIFIER_PLANNED_STORAGE ? "planned storage" : "heap storage");
+    printf("    %5s  %7s  %7s  %9s  %9s  %11s  %10s  %10s  %7s\n", "slice", "slices", "windows",
+           "features", "probs", "allocations", "us/slice", "us/window", "batch");
+
+    bool allocated = false;
+    for (size_t i = 0; i < sizes; i++) {
+        size_t slice = slice_sizes[i];
+        slice_run_t run;
+        if (!check_slices(trace, slice, &run)) {
+            fprintf(stderr, "FAIL: continuous features differ from the batch path\n");
+            return 1;
+        }
+        allocated = allocated || run.heap.allocations != 0 || run.heap.frees != 0;
+
+        double continuous_s = time_continuous(trace, slice);
+        double batch_s = time_batch(trace, slice);
+        printf("    %5zu  %7zu  %7zu  %9.2e  %9.2e  %11zu  %10.2f  %10.2f  %7.2f\n", slice, run.slices,
+               run.windows, (double)run.feature_error, (double)run.prob_error, run.heap.allocations,
+               continuous_s * 1e6 / run.slices, continuous_s * 1e6 / run.windows, batch_s * 1e6 / run.windows);
+    }
+    printf("    (features, probs: largest relative error; us/window: continuous time per classified\n"
+           "     window; batch: run_classifier per window)\n");
+
+    if (EI_CLASSIFIER_PLANNED_STORAGE && allocated) {
+        fprintf(stderr, "FAIL: run_classifier_continuous allocated once the window was full\n");
+        return 1;
+    }
+    return 0;
+}
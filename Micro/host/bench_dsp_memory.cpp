@@ -0,0 +1,139 @@
+/* Tracked DSP memory of the wavelet path (host only)
+ *
+ * Built with EIDSP_TRACK_ALLOCATIONS (EIDSP_PRINT_ALLOCATIONS off), so every
+ * DSP matrix and ei_dsp_malloc / ei_dsp_free updates ei_memory_in_use and
+ * ei_memory_peak_use. Runs synthetic windows through:
+ *
+ * 1. The DSP block alone (the wavelet features).
+ * 2. The whole impulse (run_classifier).
+ *
+ * init_impulse sizes the wavelet workspace, so no call may allocate: every
+ * call of each path is counted (heap_counters.h, as bench_allocations) and
+ * must not allocate or free anything, and after the first window the
+ * tracked memory in use must be back where it was and the peak must not
+ * grow.
+ *
+ * The process exits with status 1 if a call allocates, either tracked
+ * counter grows after the first window or the impulse fails.
+ *
+ * Usage: bench_dsp_memory [windows]   (default 1000 windows per path)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "edge-impulse-sdk/dsp/memory.hpp"
+#include "model_windows.h"
+#include "heap_counters.h"
+
+#define BENCH_DEFAULT_WINDOWS   1000
+#define BENCH_SEED              0x3C6EF372u
+
+#if !EIDSP_TRACK_ALLOCATIONS
+#error "bench_dsp_memory needs EIDSP_TRACK_ALLOCATIONS=1"
+#endif
+
+typedef bool (*window_fn_t)(const float *window);
+
+struct tracked_t {
+    size_t in_use;
+    size_t peak;
+};
+
+
+/* ========================================================================= */
+/* PATHS                                                                     */
+/* ========================================================================= */
+
+static bool run_features(const float *window) {
+    float features[MODEL_WINDOW_FEATURES];
+    return model_windows_features(window, features);
+}
+
+static bool run_impulse(const float *window) {
+    float probs[MODEL_WINDOW_LABELS];
+    return model_windows_classify(window, probs);
+}
+
+static tracked_t tracked_now(void) {
+    tracked_t now = { ei_memory_in_use, ei_memory_peak_use };
+    return now;
+}
+
+// Runs `windows` windows through fn, counting the heap use of every call;
+// the tracked counters after the first one are the reference for the rest
+static bool check_path(const char *name, window_fn_t fn, long windows) {
+    float window[MODEL_WINDOW_SAMPLES];
+    uint32_t state = BENCH_SEED;
+    tracked_t before = tracked_now();
+    tracked_t first = before;
+    size_t growths = 0;
+    size_t allocating_calls = 0;
+    heap_counters_t total = { 0, 0, 0 };
+
+    for (long w = 0; w < windows; w++) {
+        model_windows_synthetic(&state, window);
+        heap_counters_reset();
+        bool ok = fn(window);
+        heap_counters_t call = heap_counters;
+        if (!ok) {
+            fprintf(stderr, "%s failed on window %ld\n", name, w);
+            return false;
+        }
+
+        if (call.allocations != 0 || call.frees != 0) {
+            if (allocating_calls == 0) {
+                fprintf(stderr, "%s: window %ld: %zu allocations, %zu frees, %zu bytes\n",
+                        name, w, call.allocations, call.frees, call.bytes);
+            }
+            allocating_calls++;
+            total.allocations += call.allocations;
+            total.frees += call.frees;
+            total.bytes += call.bytes;
+        }
+
+        tracked_t now = tracked_now();
+        if (w == 0) {
+            first = now;
+        }
+        else if (now.in_use > first.in_use || now.peak > first.peak) {
+            if (growths == 0) {
+                fprintf(stderr, "%s: window %ld: in use %zu bytes, peak %zu bytes (first window: %zu, %zu)\n",
+                        name, w, now.in_use, now.peak, first.in_use, first.peak);
+            }
+            growths++;
+            first = now;
+        }
+    }
+
+    printf("    %-15s %5ld windows  in use %6zu -> %6zu bytes  peak %6zu -> %6zu bytes  %zu growths\n",
+           name, windows, before.in_use, ei_memory_in_use, before.peak, ei_memory_peak_use, growths);
+    printf("    %-15s %5ld windows  %zu allocations  %zu frees  %zu bytes  (%zu calls allocated)\n",
+           "", windows, total.allocations, total.frees, total.bytes, allocating_calls);
+    return growths == 0 && allocating_calls == 0;
+}
+
+
+/* ========================================================================= */
+/* MAIN                                                                      */
+/* ========================================================================= */
+
+int main(int argc, char **argv) {
+    long windows = argc > 1 ? strtol(argv[1], NULL, 10) : BENCH_DEFAULT_WINDOWS;
+    if (windows <= 0) {
+        windows = BENCH_DEFAULT_WINDOWS;
+    }
+
+    if (!model_windows_init()) {
+        fprintf(stderr, "Failed to initialize the impulse\n");
+        return 1;
+    }
+
+    printf("Tracked DSP memory (EIDSP_TRACK_ALLOCATIONS) and heap use per call, none after init\n");
+    bool ok = check_path("DSP block", run_features, windows);
+    ok = check_path("run_classifier", run_impulse, windows) && ok;
+    if (!ok) {
+        fprintf(stderr, "FAIL: a call allocated, or tracked DSP memory grew after the first window\n");
+        return 1;
+    }
+    return 0;
+}
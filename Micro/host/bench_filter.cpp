@@ -0,0 +1,300 @@
+/* Butterworth filter benchmark (host only)
+ *
+ * Compares ei::spectral::filters::biquad_cascade with the previous
+ * butterworth_lowpass/highpass, which designed the filter and allocated six
+ * arrays on every call and mixed double constants into the inner loop
+ * (reproduced below as the reference).
+ *
+ * 1. Response: both paths on a 1000-sample window, for low and high pass of
+ *    orders 2..8, must agree to within single-precision rounding.
+ * 2. Degenerate settings: butterworth_lowpass/highpass below order 2, or
+ *    with the cut-off at or past either edge of the band, must not fail and
+ *    must keep the previous results: the signal unchanged, or zeros when the
+ *    whole band is in the stop band (within tolerance of the previous path
+ *    at the band edges, where it was still stable).
+ * 3. Streaming: the window fed in chunks of 1..64 samples (and one sample at
+ *    a time) must give bit-identical output to one call over the window.
+ * 4. Timing: previous path per window vs. one designed filter per window
+ *    (reset) vs. streaming a stride of new samples per window.
+ *
+ * The process exits with status 1 on the first failed check.
+ *
+ * Usage: bench_filter [iterations]   (default 20000 windows)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "edge-impulse-sdk/dsp/spectral/filters.hpp"
+#include "host_hal.h"
+
+#define BENCH_DEFAULT_ITERATIONS 20000
+#define BENCH_WINDOW             1000
+#define BENCH_STRIDE             250
+#define BENCH_SAMPLE_RATE_HZ     100.0f
+#define BENCH_ORDER              4
+#define BENCH_TOLERANCE          1e-4f   // Relative to the signal peak
+
+using ei::spectral::filters::biquad_cascade;
+
+static float signal_in[BENCH_WINDOW];
+static uint32_t rng_state = 0x6D2B79F5u;
+
+
+/* ========================================================================= */
+/* HELPERS                                                                   */
+/* ========================================================================= */
+
+static float next_float(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (float)(rng_state & 0xFFFFFF) / (float)0x800000 - 1.0f;
+}
+
+// Previous implementation, low pass or high pass
+static void butterworth_reference(bool highpass, int filter_order, float sampling_freq,
+                                  float cutoff_freq, const float *src, float *dest, size_t size) {
+    int n_steps = filter_order / 2;
+    float a = tan(M_PI * cutoff_freq / sampling_freq);
+    float a2 = pow(a, 2);
+    float *A = (float*)ei_dsp_calloc(n_steps, sizeof(float));
+    float *d1 = (float*)ei_dsp_calloc(n_steps, sizeof(float));
+    float *d2 = (float*)ei_dsp_calloc(n_steps, sizeof(float));
+    float *w0 = (float*)ei_dsp_calloc(n_steps, sizeof(float));
+    float *w1 = (float*)ei_dsp_calloc(n_steps, sizeof(float));
+    float *w2 = (float*)ei_dsp_calloc(n_steps, sizeof(float));
+
+    for (int ix = 0; ix < n_steps; ix++) {
+        float r = sin(M_PI * ((2.0 * ix) + 1.0) / (2.0 * filter_order));
+        sampling_freq = a2 + (2.0 * a * r) + 1.0;
+        A[ix] = highpass ? 1.0f / sampling_freq : a2 / sampling_freq;
+        d1[ix] = 2.0 * (1 - a2) / sampling_freq;
+        d2[ix] = -(a2 - (2.0 * a * r) + 1.0) / sampling_freq;
+    }
+
+    for (size_t sx = 0; sx < size; sx++) {
+        dest[sx] = src[sx];
+        for (int i = 0; i < n_steps; i++) {
+            w0[i] = d1[i] * w1[i] + d2[i] * w2[i] + dest[sx];
+            dest[sx] = highpass ? A[i] * (w0[i] - (2.0 * w1[i]) + w2[i])
+                                : A[i] * (w0[i] + (2.0 * w1[i]) + w2[i]);
+            w2[i] = w1[i];
+            w1[i] = w0[i];
+        }
+    }
+
+    ei_dsp_free(A, n_steps*sizeof(float));
+    ei_dsp_free(d1, n_steps*sizeof(float));
+    ei_dsp_free(d2, n_steps*sizeof(float));
+    ei_dsp_free(w0, n_steps*sizeof(float));
+    ei_dsp_free(w1, n_steps*sizeof(float));
+    ei_dsp_free(w2, n_steps*sizeof(float));
+}
+
+
+/* ========================================================================= */
+/* CHECKS                                                                    */
+/* ========================================================================= */
+
+static bool check_response(void) {
+    float ref[BENCH_WINDOW];
+    float out[BENCH_WINDOW];
+    float worst = 0.0f;
+
+    for (int highpass = 0; highpass < 2; highpass++) {
+        for (int order = 2; order <= 8; order += 2) {
+            float cutoff = highpass ? 1.0f : 10.0f;
+            butterworth_reference(highpass, order, BENCH_SAMPLE_RATE_HZ, cutoff, signal_in, ref, BENCH_WINDOW);
+
+            biquad_cascade filter;
+            if (filter.design_butterworth(highpass, order, BENCH_SAMPLE_RATE_HZ, cutoff) != ei::EIDSP_OK) {
+                fprintf(stderr, "Design failed (highpass=%d, order=%d)\n", highpass, order);
+                return false;
+            }
+            filter.process(signal_in, out, BENCH_WINDOW);
+
+            float peak = 0.0f;
+            float err = 0.0f;
+            for (size_t i = 0; i < BENCH_WINDOW; i++) {
+                peak = fmaxf(peak, fabsf(ref[i]));
+                err = fmaxf(err, fabsf(ref[i] - out[i]));
+            }
+            if (err > BENCH_TOLERANCE * peak) {
+                fprintf(stderr, "Response differs (highpass=%d, order=%d): %g of peak %g\n",
+                        highpass, order, err, peak);
+                return false;
+            }
+            worst = fmaxf(worst, err / peak);
+        }
+    }
+
+    biquad_cascade filter;
+    if (filter.design_butterworth(false, 10, BENCH_SAMPLE_RATE_HZ, 10.0f) == ei::EIDSP_OK ||
+            filter.design_butterworth(false, 4, BENCH_SAMPLE_RATE_HZ, 60.0f) == ei::EIDSP_OK) {
+        fprintf(stderr, "Invalid design parameters were accepted\n");
+        return false;
+    }
+
+    printf("Butterworth orders 2..8, low and high pass, vs. previous path\n");
+    printf("    max difference:   %.2e of peak\n", worst);
+    return true;
+}
+
+struct degenerate_case_t {
+    bool highpass;
+    int order;
+    float cutoff;
+    bool all_pass;          // else all stop
+    bool compare;           // previous path is stable here
+};
+
+static bool check_degenerate(void) {
+    static const degenerate_case_t cases[] = {
+        { false, 0, 10.0f,                        true,  true  },
+        { false, 1, 10.0f,                        true,  true  },
+        { true,  1, 1.0f,                         true,  true  },
+        { false, 4, BENCH_SAMPLE_RATE_HZ / 2.0f,  true,  true  },
+        { false, 4, BENCH_SAMPLE_RATE_HZ,         true,  false },
+        { true,  4, 0.0f,                         true,  false },
+        { false, 4, 0.0f,                         false, true  },
+        { true,  4, BENCH_SAMPLE_RATE_HZ / 2.0f,  false, true  },
+        { true,  4, BENCH_SAMPLE_RATE_HZ,         false, false },
+    };
+    float ref[BENCH_WINDOW];
+    float out[BENCH_WINDOW];
+    float peak = 0.0f;
+    for (size_t i = 0; i < BENCH_WINDOW; i++) {
+        peak = fmaxf(peak, fabsf(signal_in[i]));
+    }
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        const degenerate_case_t *t = &cases[c];
+        int ret = t->highpass
+            ? ei::spectral::filters::butterworth_highpass(t->order, BENCH_SAMPLE_RATE_HZ, t->cutoff,
+                                                          signal_in, out, BENCH_WINDOW)
+            : ei::spectral::filters::butterworth_lowpass(t->order, BENCH_SAMPLE_RATE_HZ, t->cutoff,
+                                                         signal_in, out, BENCH_WINDOW);
+        bool as_expected = ret == ei::EIDSP_OK;
+        float err = 0.0f;
+        for (size_t i = 0; i < BENCH_WINDOW; i++) {
+            as_expected = as_expected && out[i] == (t->all_pass ? signal_in[i] : 0.0f);
+        }
+        if (t->compare) {
+            butterworth_reference(t->highpass, t->order, BENCH_SAMPLE_RATE_HZ, t->cutoff,
+                                  signal_in, ref, BENCH_WINDOW);
+            for (size_t i = 0; i < BENCH_WINDOW; i++) {
+                err = fmaxf(err, fabsf(ref[i] - out[i]));
+            }
+        }
+        if (!as_expected || !(err <= BENCH_TOLERANCE * peak)) {
+            fprintf(stderr, "Degenerate %s pass (order=%d, cut-off=%g Hz): status %d, "
+                            "%g of peak from the previous path\n", t->highpass ? "high" : "low", t->order, t->cutoff, ret, err / peak);
+            return false;
+        }
+    }
+
+    printf("Order below 2 and cut-offs at the band edges: previous results kept\n");
+    return true;
+}
+
+static bool check_streaming(void) {
+    float whole[BENCH_WINDOW];
+    float chunked[BENCH_WINDOW];
+
+    biquad_cascade filter;
+    filter.design_butterworth(true, BENCH_ORDER, BENCH_SAMPLE_RATE_HZ, 1.0f);
+    filter.process(signal_in, whole, BENCH_WINDOW);
+
+    for (size_t chunk = 1; chunk <= 64; chunk++) {
+        filter.reset();
+        for (size_t i = 0; i < BENCH_WINDOW; i += chunk) {
+            size_t n = (BENCH_WINDOW - i < chunk) ? BENCH_WINDOW - i : chunk;
+            filter.process(signal_in + i, chunked + i, n);
+        }
+        if (memcmp(whole, chunked, sizeof(whole)) != 0) {
+            fprintf(stderr, "Chunks of %zu samples differ from one call\n", chunk);
+            return false;
+        }
+    }
+
+    filter.reset();
+    for (size_t i = 0; i < BENCH_WINDOW; i++) {
+        chunked[i] = filter.process(signal_in[i]);
+    }
+    if (memcmp(whole, chunked, sizeof(whole)) != 0) {
+        fprintf(stderr, "Per-sample filtering differs from one call\n");
+        return false;
+    }
+
+    printf("Streaming in chunks of 1..64 samples: bit-identical to one call\n");
+    return true;
+}
+
+
+/* ========================================================================= */
+/* TIMING                                                                    */
+/* ========================================================================= */
+
+static void bench_timing(long iterations) {
+    float out[BENCH_WINDOW];
+    volatile float sink = 0.0f;  // keeps the results alive
+
+    double start = host_wall_time_s();
+    for (long it = 0; it < iterations; it++) {
+        butterworth_reference(true, BENCH_ORDER, BENCH_SAMPLE_RATE_HZ, 1.0f, signal_in, out, BENCH_WINDOW);
+        sink += out[it % BENCH_WINDOW];
+    }
+    double reference_s = host_wall_time_s() - start;
+
+    biquad_cascade filter;
+    filter.design_butterworth(true, BENCH_ORDER, BENCH_SAMPLE_RATE_HZ, 1.0f);
+    start = host_wall_time_s();
+    for (long it = 0; it < iterations; it++) {
+        filter.reset();
+        filter.process(signal_in, out, BENCH_WINDOW);
+        sink += out[it % BENCH_WINDOW];
+    }
+    double window_s = host_wall_time_s() - start;
+
+    // overlapping windows: only the new samples of each window are filtered
+    start = host_wall_time_s();
+    for (long it = 0; it < iterations; it++) {
+        size_t offset = (it * BENCH_STRIDE) % BENCH_WINDOW;
+        filter.process(signal_in + offset, out, BENCH_STRIDE);
+        sink += out[it % BENCH_STRIDE];
+    }
+    double stream_s = host_wall_time_s() - start;
+
+    printf("High pass order %d, %d-sample window, stride %d (%ld windows)\n",
+           BENCH_ORDER, BENCH_WINDOW, BENCH_STRIDE, iterations);
+    printf("    previous path:    %8.2f us/window\n", reference_s * 1e6 / iterations);
+    printf("    biquad_cascade:   %8.2f us/window\n", window_s * 1e6 / iterations);
+    printf("    streaming:        %8.2f us/window\n", stream_s * 1e6 / iterations);
+}
+
+
+/* ========================================================================= */
+/* MAIN                                                                      */
+/* ========================================================================= */
+
+int main(int argc, char **argv) {
+    long iterations = argc > 1 ? strtol(argv[1], NULL, 10) : BENCH_DEFAULT_ITERATIONS;
+    if (iterations <= 0) {
+        iterations = BENCH_DEFAULT_ITERATIONS;
+    }
+
+    // slow drift + 5 Hz tone + noise, in geophone velocity units
+    for (size_t i = 0; i < BENCH_WINDOW; i++) {
+        float t = (float)i / BENCH_SAMPLE_RATE_HZ;
+        signal_in[i] = 1e-3f * (0.5f + 0.2f * t / 10.0f + sinf(2.0f * (float)M_PI * 5.0f * t)
+                                + 0.3f * next_float());
+    }
+
+    if (!check_response() || !check_degenerate() || !check_streaming()) {
+        return 1;
+    }
+    bench_timing(iterations);
+    return 0;
+}
@@ -0,0 +1,242 @@
+/* Fused EON graph benchmark (host only)
+ *
+ * tflite_learn_815551_95_compiled.cpp runs its depthwise-separable block
+ * (DEPTHWISE_CONV_2D -> MUL -> ADD -> CONV_2D) as one tiled kernel and skips
+ * the RESHAPE nodes, whose outputs share their input's arena offset. This
+ * file includes the generated source to also run the graph node by node
+ * through the TFLM kernels (the unfused path) on the same tensors.
+ *
+ * 1. Accuracy: on synthetic windows, the block output and the class
+ *    probabilities of both paths must agree to within BENCH_TOLERANCE (they
+ *    are bit-identical unless the compiler contracts multiply-adds
+ *    differently in the two paths).
+ * 2. Arena: the fused kernel must be enabled and no persistent buffer may
+ *    spill out of tensor_arena.
+ * 3. Timing: time per invoke of each path, and of the block alone.
+ *
+ * The process exits with status 1 on the first failed check.
+ *
+ * Usage: bench_fused [windows] [iterations]
+ *        (default 1000 synthetic windows, 20000 timed invokes)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "edge-impulse-sdk/classifier/ei_aligned_malloc.h"
+#include "model_windows.h"
+#include "host_hal.h"
+
+#include "tflite-model/tflite_learn_815551_95_compiled.cpp"
+
+#define BENCH_DEFAULT_WINDOWS    1000
+#define BENCH_DEFAULT_ITERATIONS 20000
+#define BENCH_SEED               0x85EBCA6Bu
+#define BENCH_TOLERANCE          1e-5f
+
+#define NODE_COUNT (sizeof(tflNodes) / sizeof(tflNodes[0]))
+
+
+/* ========================================================================= */
+/* HELPERS                                                                   */
+/* ========================================================================= */
+
+static void set_input(const float *features) {
+    memcpy(eval_tensor_floats(in_tensor_indices[0]), features, MODEL_WINDOW_FEATURES * sizeof(float));
+}
+
+static bool invoke_nodes(size_t first, size_t last) {
+    for (size_t i = first; i < last; i++) {
+        ResetTensors();
+        if (registrations[used_ops[i]].invoke(&ctx, &tflNodes[i]) != kTfLiteOk) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool invoke_unfused(void) {
+    return invoke_nodes(0, NODE_COUNT);
+}
+
+static size_t block_output(void) {
+    return tflNodes[fused_separable.first_node + 3].outputs->data[0];
+}
+
+static float max_difference(const float *a, const float *b, size_t count) {
+    float diff = 0.0f;
+    for (size_t k = 0; k < count; k++) {
+        diff = fmaxf(diff, fabsf(a[k] - b[k]));
+    }
+    return diff;
+}
+
+
+/* ========================================================================= */
+/* ACCURACY                                                                  */
+/* ========================================================================= */
+
+static bool bench_accuracy(long windows) {
+    const size_t block_count = tensorData[block_output()].bytes / sizeof(float);
+    float *block_fused = (float*)malloc(block_count * sizeof(float));
+    float probs_fused[MODEL_WINDOW_LABELS];
+    float window[MODEL_WINDOW_SAMPLES];
+    float features[MODEL_WINDOW_FEATURES];
+    uint32_t state = BENCH_SEED;
+    float block_diff = 0.0f, probs_diff = 0.0f;
+    long identical = 0;
+
+    for (long w = 0; w < windows; w++) {
+        model_windows_synthetic(&state, window);
+        if (!model_windows_features(window, features)) {
+            fprintf(stderr, "FAIL: DSP block on window %ld\n", w);
+            free(block_fused);
+            return false;
+        }
+
+        set_input(features);
+        if (tflite_learn_815551_95_invoke() != kTfLiteOk) {
+            fprintf(stderr, "FAIL: fused invoke on window %ld\n", w);
+            free(block_fused);
+            return false;
+        }
+        memcpy(block_fused, eval_tensor_floats(block_output()), block_count * sizeof(float));
+        memcpy(probs_fused, eval_tensor_floats(out_tensor_indices[0]), sizeof(probs_fused));
+
+        set_input(features);
+        if (!invoke_unfused()) {
+            fprintf(stderr, "FAIL: unfused invoke on window %ld\n", w);
+            free(block_fused);
+            return false;
+        }
+        const float *block = eval_tensor_floats(block_output());
+        const float *probs = eval_tensor_floats(out_tensor_indices[0]);
+        block_diff = fmaxf(block_diff, max_difference(block_fused, block, block_count));
+        probs_diff = fmaxf(probs_diff, max_difference(probs_fused, probs, MODEL_WINDOW_LABELS));
+        identical += memcmp(block_fused, block, block_count * sizeof(float)) == 0 &&
+                     memcmp(probs_fused, probs, sizeof(probs_fused)) == 0;
+    }
+    free(block_fused);
+
+    printf("Fused vs. node-by-node (%ld windows)\n", windows);
+    printf("    bit-identical:     %ld / %ld\n", identical, windows);
+    printf("    block max |diff|:  %g\n", block_diff);
+    printf("    probs max |diff|:  %g\n", probs_diff);
+    if (block_diff > BENCH_TOLERANCE || probs_diff > BENCH_TOLERANCE) {
+        fprintf(stderr, "FAIL: fused path differs by more than %g\n", BENCH_TOLERANCE);
+        return false;
+    }
+    return true;
+}
+
+
+/* ========================================================================= */
+/* ARENA                                                                     */
+/* ========================================================================= */
+
+static bool bench_arena(void) {
+    size_t activations = 0;
+    for (size_t t = 0; t < sizeof(tensorData) / sizeof(tensorData[0]); t++) {
+        if (tensorData[t].allocation_type == kTfLiteArenaRw) {
+            size_t end = (uintptr_t)tensorData[t].data + tensorData[t].bytes;
+            activations = end > activations ? end : activations;
+        }
+    }
+    size_t persistent = (size_t)(tensor_arena + kTensorArenaSize - current_location);
+
+    printf("Arena: %d bytes, activations %zu, persistent %zu, overflow buffers %zu\n",
+           kTensorArenaSize, activations, persistent, overflow_buffers_ix);
+    printf("Fused block: nodes %zu-%zu, %d x %d -> %d channels\n",
+           fused_separable.first_node, fused_separable.first_node + 3,
+           fused_separable.width, fused_separable.channels, fused_separable.out_channels);
+
+    if (!fused_separable.enabled) {
+        fprintf(stderr, "FAIL: depthwise-separable block not fused\n");
+        return false;
+    }
+    if (overflow_buffers_ix != 0) {
+        fprintf(stderr, "FAIL: persistent buffers do not fit in tensor_arena\n");
+        return false;
+    }
+    return true;
+}
+
+
+/* ========================================================================= */
+/* TIMING                                                                    */
+/* ========================================================================= */
+
+static void bench_timing(long iterations) {
+    float window[MODEL_WINDOW_SAMPLES];
+    float features[MODEL_WINDOW_FEATURES];
+    volatile float sink = 0.0f;  // keeps the results alive
+    uint32_t state = BENCH_SEED;
+    const size_t first = fused_separable.first_node;
+
+    model_windows_synthetic(&state, window);
+    model_windows_features(window, features);
+
+    double start = host_wall_time_s();
+    for (long it = 0; it < iterations; it++) {
+        set_input(features);
+        invoke_unfused();
+        sink += eval_tensor_floats(out_tensor_indices[0])[0];
+    }
+    double unfused_s = host_wall_time_s() - start;
+
+    start = host_wall_time_s();
+    for (long it = 0; it < iterations; it++) {
+        set_input(features);
+        tflite_learn_815551_95_invoke();
+        sink += eval_tensor_floats(out_tensor_indices[0])[0];
+    }
+    double fused_s = host_wall_time_s() - start;
+
+    // block alone, on the last window's block input
+    start = host_wall_time_s();
+    for (long it = 0; it < iterations; it++) {
+        invoke_nodes(first, first + 4);
+    }
+    double block_unfused_s = host_wall_time_s() - start;
+
+    start = host_wall_time_s();
+    for (long it = 0; it < iterations; it++) {
+        invoke_fused_separable();
+    }
+    double block_fused_s = host_wall_time_s() - start;
+    sink += eval_tensor_floats(block_output())[0];
+
+    printf("Latency (%ld invokes, reference kernels)\n", iterations);
+    printf("    graph, node by node:  %8.2f us/window\n", unfused_s * 1e6 / iterations);
+    printf("    graph, fused:         %8.2f us/window\n", fused_s * 1e6 / iterations);
+    printf("    block, node by node:  %8.2f us/window\n", block_unfused_s * 1e6 / iterations);
+    printf("    block, fused:         %8.2f us/window\n", block_fused_s * 1e6 / iterations);
+}
+
+
+/* ========================================================================= */
+/* MAIN                                                                      */
+/* ========================================================================= */
+
+int main(int argc, char **argv) {
+    long windows = argc > 1 ? strtol(argv[1], NULL, 10) : BENCH_DEFAULT_WINDOWS;
+    long iterations = argc > 2 ? strtol(argv[2], NULL, 10) : BENCH_DEFAULT_ITERATIONS;
+    if (windows <= 0) {
+        windows = BENCH_DEFAULT_WINDOWS;
+    }
+    if (iterations <= 0) {
+        iterations = BENCH_DEFAULT_ITERATIONS;
+    }
+
+    if (!model_windows_init() || tflite_learn_815551_95_init(ei_aligned_calloc) != kTfLiteOk) {
+        fprintf(stderr, "Failed to initialize the graph\n");
+        return 1;
+    }
+
+    if (!bench_arena() || !bench_accuracy(windows)) {
+        return 1;
+    }
+    bench_timing(iterations);
+    return 0;
+}
@@ -0,0 +1,469 @@
+/* DSP and inference kernel benchmark suite (host only)
+ *
+ * Times every kernel the impulse runs, plus the SDK helpers around it, on
+ * the same windows: synthetic windows (host/model_windows.h) and, if given,
+ * every window of a recorded ADC trace (SEISMIC_ADC_FILE format).
+ *
+ *   wavelet_dsp          the impulse's DSP block (raw wavelet features)
+ *   normalization        separate standard scaler pass over the 56 features
+ *   wavelet_dsp_folded   the DSP block with the normalization folded into
+ *                        its feature writer, as the impulse runs it
+ *   run_classifier       the whole impulse
+ *   numpy_*              numpy:: statistics on one 1000-sample window
+ *   rfft_4096            numpy::rfft, window zero-padded to 4096 points
+ *   butterworth_highpass design and filter one window (order 4, 0.5 Hz)
+ *   biquad_cascade       filter one window with a designed, running cascade
+ *
+ * Each latency sample times a batch of calls, sized so that a sample spans
+ * at least BENCH_MIN_SAMPLE_US; the per-call latency is the sample time
+ * divided by the batch. The summary lists calls per second, samples per
+ * second (window samples, or features for normalization, read) and mean /
+ * p50 / p90 / p99 / max latency.
+ *
+ * Results are also written as CSV (one line per kernel and window set) for
+ * comparison between builds. With a baseline CSV from an earlier run, the
+ * process exits with status 1 if any kernel's p50 latency grew by more than
+ * the tolerance (BENCH_TOLERANCE, or SEISMIC_BENCH_TOLERANCE as a fraction)
+ * and by more than BENCH_MIN_REGRESSION_US. It also exits with status 1 if a
+ * kernel fails.
+ *
+ * Usage: bench_kernels [trace.txt|-] [samples] [results.csv|-] [baseline.csv]
+ *        (default 2000 latency samples per kernel and window set)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include "edge-impulse-sdk/dsp/numpy.hpp"
+#include "edge-impulse-sdk/dsp/spectral/filters.hpp"
+#include "model_windows.h"
+#include "host_hal.h"
+
+#define BENCH_DEFAULT_SAMPLES   2000
+#define BENCH_SYNTHETIC_WINDOWS 64
+#define BENCH_SEED              0x27D4EB2Fu
+#define BENCH_MIN_SAMPLE_US     20.0
+#define BENCH_TOLERANCE         0.25
+#define BENCH_MIN_REGRESSION_US 0.5
+#define BENCH_SAMPLE_RATE_HZ    100.0f
+#define BENCH_FFT_POINTS        4096
+#define BENCH_MAX_RESULTS       64
+
+using namespace ei;
+using namespace ei::spectral;
+
+struct window_set_t {
+    const char *name;
+    float *windows;         // count x MODEL_WINDOW_SAMPLES
+    float *features;        // count x MODEL_WINDOW_FEATURES, from the DSP block
+    size_t count;
+};
+
+struct kernel_t {
+    const char *name;
+    bool (*run)(const window_set_t *set, size_t w);
+    size_t input_samples;   // values read per call, for samples/s
+};
+
+struct result_t {
+    char kernel[32];
+    char set[32];
+    size_t calls;
+    size_t batch;
+    double mean_us;
+    double p50_us;
+    double p90_us;
+    double p99_us;
+    double max_us;
+    double calls_per_s;
+    double samples_per_s;
+};
+
+static float scratch_features[MODEL_WINDOW_FEATURES];
+static float scratch_window[MODEL_WINDOW_SAMPLES];
+static fft_complex_t scratch_fft[BENCH_FFT_POINTS / 2 + 1];
+static filters::biquad_cascade running_filter;
+static volatile float sink;     // keeps the results alive
+
+static result_t results[BENCH_MAX_RESULTS];
+static size_t result_count;
+
+
+/* ========================================================================= */
+/* HELPERS                                                                   */
+/* ========================================================================= */
+
+static float *window_at(const window_set_t *set, size_t w) {
+    return set->windows + w * MODEL_WINDOW_SAMPLES;
+}
+
+typedef int (*numpy_stat_fn)(matrix_t *input_matrix, matrix_t *output_matrix);
+
+static bool run_stat(numpy_stat_fn stat, const window_set_t *set, size_t w) {
+    float value;
+    matrix_t input(1, MODEL_WINDOW_SAMPLES, window_at(set, w));
+    matrix_t output(1, 1, &value);
+    if (stat(&input, &output) != EIDSP_OK) {
+        return false;
+    }
+    sink = value;
+    return true;
+}
+
+
+/* ========================================================================= */
+/* KERNELS                                                                   */
+/* ========================================================================= */
+
+static bool run_wavelet_dsp(const window_set_t *set, size_t w) {
+    return model_windows_dsp(window_at(set, w), scratch_features);
+}
+
+static bool run_wavelet_dsp_folded(const window_set_t *set, size_t w) {
+    return model_windows_features(window_at(set, w), scratch_features);
+}
+
+// includes copying the 56 raw features into place
+static bool run_normalization(const window_set_t *set, size_t w) {
+    memcpy(scratch_features, set->features + w * MODEL_WINDOW_FEATURES, sizeof(scratch_features));
+    return model_windows_normalize(scratch_features);
+}
+
+static bool run_classifier_window(const window_set_t *set, size_t w) {
+    float probs[MODEL_WINDOW_LABELS];
+    if (!model_windows_classify(window_at(set, w), probs)) {
+        return false;
+    }
+    sink = probs[0];
+    return true;
+}
+
+static bool run_mean(const window_set_t *set, size_t w) {
+    return run_stat(numpy::mean, set, w);
+}
+
+static bool run_stdev(const window_set_t *set, size_t w) {
+    return run_stat(numpy::stdev, set, w);
+}
+
+static bool run_skew(const window_set_t *set, size_t w) {
+    return run_stat(numpy::skew, set, w);
+}
+
+static bool run_kurtosis(const window_set_t *set, size_t w) {
+    return run_stat(numpy::kurtosis, set, w);
+}
+
+static bool run_rms(const window_set_t *set, size_t w) {
+    return run_stat(numpy::rms, set, w);
+}
+
+static bool run_min(const window_set_t *set, size_t w) {
+    return run_stat(numpy::min, set, w);
+}
+
+static bool run_max(const window_set_t *set, size_t w) {
+    return run_stat(numpy::max, set, w);
+}
+
+static bool run_rfft(const window_set_t *set, size_t w) {
+    if (numpy::rfft(window_at(set, w), MODEL_WINDOW_SAMPLES, scratch_fft,
+                    BENCH_FFT_POINTS / 2 + 1, BENCH_FFT_POINTS) != EIDSP_OK) {
+        return false;
+    }
+    sink = scratch_fft[1].r;
+    return true;
+}
+
+static bool run_butterworth(const window_set_t *set, size_t w) {
+    if (filters::butterworth_highpass(4, BENCH_SAMPLE_RATE_HZ, 0.5f, window_at(set, w),
+                                      scratch_window, MODEL_WINDOW_SAMPLES) != EIDSP_OK) {
+        return false;
+    }
+    sink = scratch_window[MODEL_WINDOW_SAMPLES - 1];
+    return true;
+}
+
+static bool run_biquad(const window_set_t *set, size_t w) {
+    running_filter.process(window_at(set, w), scratch_window, MODEL_WINDOW_SAMPLES);
+    sink = scratch_window[MODEL_WINDOW_SAMPLES - 1];
+    return true;
+}
+
+static const kernel_t kernels[] = {
+    { "wavelet_dsp",          run_wavelet_dsp,         MODEL_WINDOW_SAMPLES },
+    { "normalization",        run_normalization,       MODEL_WINDOW_FEATURES },
+    { "wavelet_dsp_folded",   run_wavelet_dsp_folded,  MODEL_WINDOW_SAMPLES },
+    { "run_classifier",       run_classifier_window,   MODEL_WINDOW_SAMPLES },
+    { "numpy_mean",           run_mean,                MODEL_WINDOW_SAMPLES },
+    { "numpy_stdev",          run_stdev,               MODEL_WINDOW_SAMPLES },
+    { "numpy_skew",           run_skew,                MODEL_WINDOW_SAMPLES },
+    { "numpy_kurtosis",       run_kurtosis,            MODEL_WINDOW_SAMPLES },
+    { "numpy_rms",            run_rms,                 MODEL_WINDOW_SAMPLES },
+    { "numpy_min",            run_min,                 MODEL_WINDOW_SAMPLES },
+    { "numpy_max",            run_max,                 MODEL_WINDOW_SAMPLES },
+    { "rfft_4096",            run_rfft,                MODEL_WINDOW_SAMPLES },
+    { "butterworth_highpass", run_butterworth,         MODEL_WINDOW_SAMPLES },
+    { "biquad_cascade",       run_biquad,              MODEL_WINDOW_SAMPLES },
+};
+#define BENCH_KERNEL_COUNT (sizeof(kernels) / sizeof(kernels[0]))
+
+
+/* ========================================================================= */
+/* WINDOW SETS                                                               */
+/* ========================================================================= */
+
+static bool prepare_set(window_set_t *set) {
+    set->features = (float*)malloc(set->count * MODEL_WINDOW_FEATURES * sizeof(float));
+    if (!set->features) {
+        fprintf(stderr, "Out of memory for %s\n", set->name);
+        return false;
+    }
+    for (size_t w = 0; w < set->count; w++) {
+        if (!model_windows_dsp(window_at(set, w), set->features + w * MODEL_WINDOW_FEATURES)) {
+            fprintf(stderr, "FAIL: DSP block on %s window %zu\n", set->name, w);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool synthetic_set(window_set_t *set) {
+    set->name = "synthetic";
+    set->count = BENCH_SYNTHETIC_WINDOWS;
+    set->windows = (float*)malloc(set->count * MODEL_WINDOW_SAMPLES * sizeof(float));
+    if (!set->windows) {
+        fprintf(stderr, "Out of memory for %s\n", set->name);
+        return false;
+    }
+    uint32_t state = BENCH_SEED;
+    for (size_t w = 0; w < set->count; w++) {
+        model_windows_synthetic(&state, window_at(set, w));
+    }
+    return prepare_set(set);
+}
+
+// Windows of a recorded trace, one every MODEL_WINDOW_STRIDE samples
+static bool trace_set(const char *path, window_set_t *set) {
+    float *samples = NULL;
+    size_t count = model_windows_load_trace(path, &samples);
+    if (count < MODEL_WINDOW_SAMPLES) {
+        fprintf(stderr, "%s holds fewer than %d samples\n", path, MODEL_WINDOW_SAMPLES);
+        free(samples);
+        return false;
+    }
+
+    set->name = "trace";
+    set->count = (count - MODEL_WINDOW_SAMPLES) / MODEL_WINDOW_STRIDE + 1;
+    set->windows = (float*)malloc(set->count * MODEL_WINDOW_SAMPLES * sizeof(float));
+    if (!set->windows) {
+        fprintf(stderr, "Out of memory for %s\n", set->name);
+        free(samples);
+        return false;
+    }
+    for (size_t w = 0; w < set->count; w++) {
+        memcpy(window_at(set, w), samples + w * MODEL_WINDOW_STRIDE, MODEL_WINDOW_SAMPLES * sizeof(float));
+    }
+    free(samples);
+    return prepare_set(set);
+}
+
+
+/* ========================================================================= */
+/* TIMING                                                                    */
+/* ========================================================================= */
+
+static double percentile(const double *sorted, size_t n, double p) {
+    size_t rank = (size_t)ceil(p * n);
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+static bool bench_kernel(const kernel_t *kernel, const window_set_t *set, long samples, result_t *result) {
+    // warm up on every window and size the batch
+    double start = host_wall_time_s();
+    for (size_t w = 0; w < set->count; w++) {
+        if (!kernel->run(set, w)) {
+            fprintf(stderr, "FAIL: %s on %s window %zu\n", kernel->name, set->name, w);
+            return false;
+        }
+    }
+    double call_us = (host_wall_time_s() - start) * 1e6 / set->count;
+    size_t batch = call_us >= BENCH_MIN_SAMPLE_US ? 1 : (size_t)ceil(BENCH_MIN_SAMPLE_US / call_us);
+
+    double *latencies = (double*)malloc(samples * sizeof(double));
+    if (!latencies) {
+        fprintf(stderr, "Out of memory for %ld samples\n", samples);
+        return false;
+    }
+
+    size_t w = 0;
+    double total_s = 0.0;
+    for (long s = 0; s < samples; s++) {
+        start = host_wall_time_s();
+        for (size_t b = 0; b < batch; b++) {
+            kernel->run(set, w);
+            w = w + 1 < set->count ? w + 1 : 0;
+        }
+        double elapsed_s = host_wall_time_s() - start;
+        total_s += elapsed_s;
+        latencies[s] = elapsed_s * 1e6 / batch;
+    }
+    std::sort(latencies, latencies + samples);
+
+    snprintf(result->kernel, sizeof(result->kernel), "%s", kernel->name);
+    snprintf(result->set, sizeof(result->set), "%s", set->name);
+    result->calls = (size_t)samples * batch;
+    result->batch = batch;
+    result->mean_us = total_s * 1e6 / result->calls;
+    result->p50_us = percentile(latencies, samples, 0.50);
+    result->p90_us = percentile(latencies, samples, 0.90);
+    result->p99_us = percentile(latencies, samples, 0.99);
+    result->max_us = latencies[samples - 1];
+    result->calls_per_s = result->calls / total_s;
+    result->samples_per_s = result->calls_per_s * kernel->input_samples;
+    free(latencies);
+    return true;
+}
+
+static bool bench_set(const window_set_t *set, long samples) {
+    printf("%s windows (%zu), %ld latency samples per kernel\n", set->name, set->count, samples);
+    printf("    %-22s %12s %12s %9s %9s %9s %9s %9s\n",
+           "kernel", "calls/s", "samples/s", "mean us", "p50 us", "p90 us", "p99 us", "max us");
+
+    for (size_t k = 0; k < BENCH_KERNEL_COUNT; k++) {
+        if (result_count == BENCH_MAX_RESULTS) {
+            fprintf(stderr, "Too many results\n");
+            return false;
+        }
+        result_t *r = &results[result_count];
+        if (!bench_kernel(&kernels[k], set, samples, r)) {
+            return false;
+        }
+        result_count++;
+        printf("    %-22s %12.0f %12.3g %9.2f %9.2f %9.2f %9.2f %9.2f\n",
+               r->kernel, r->calls_per_s, r->samples_per_s,
+               r->mean_us, r->p50_us, r->p90_us, r->p99_us, r->max_us);
+    }
+    return true;
+}
+
+
+/* ========================================================================= */
+/* RESULTS                                                                   */
+/* ========================================================================= */
+
+#define BENCH_CSV_HEADER "kernel,set,calls,batch,mean_us,p50_us,p90_us,p99_us,max_us,calls_per_s,samples_per_s"
+
+static bool write_results(const char *path) {
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "Cannot write %s\n", path);
+        return false;
+    }
+    fprintf(file, "%s\n", BENCH_CSV_HEADER);
+    for (size_t i = 0; i < result_count; i++) {
+        const result_t *r = &results[i];
+        fprintf(file, "%s,%s,%zu,%zu,%.4f,%.4f,%.4f,%.4f,%.4f,%.1f,%.1f\n",
+                r->kernel, r->set, r->calls, r->batch, r->mean_us, r->p50_us,
+                r->p90_us, r->p99_us, r->max_us, r->calls_per_s, r->samples_per_s);
+    }
+    fclose(file);
+    printf("Wrote %s\n", path);
+    return true;
+}
+
+// Compares the p50 latencies with a CSV written by an earlier run
+static bool check_baseline(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return false;
+    }
+
+    double tolerance = BENCH_TOLERANCE;
+    const char *env = getenv("SEISMIC_BENCH_TOLERANCE");
+    if (env) {
+        tolerance = atof(env);
+    }
+
+    char line[256];
+    size_t compared = 0, regressions = 0;
+    printf("Baseline %s (p50, tolerance %.0f %%)\n", path, tolerance * 100.0);
+    while (fgets(line, sizeof(line), file)) {
+        char kernel[32], set[32];
+        size_t calls, batch;
+        double mean_us, p50_us;
+        if (sscanf(line, "%31[^,],%31[^,],%zu,%zu,%lf,%lf", kernel, set, &calls, &batch, &mean_us, &p50_us) != 6) {
+            continue;   // header or foreign line
+        }
+        for (size_t i = 0; i < result_count; i++) {
+            const result_t *r = &results[i];
+            if (strcmp(r->kernel, kernel) != 0 || strcmp(r->set, set) != 0) {
+                continue;
+            }
+            compared++;
+            bool regressed = r->p50_us > p50_us * (1.0 + tolerance) &&
+                             r->p50_us - p50_us > BENCH_MIN_REGRESSION_US;
+            regressions += regressed;
+            printf("    %-22s %-10s %9.2f -> %9.2f us  %+7.1f %%%s\n", kernel, set, p50_us, r->p50_us,
+                   p50_us > 0.0 ? 100.0 * (r->p50_us / p50_us - 1.0) : 0.0, regressed ? "  REGRESSION" : "");
+        }
+    }
+    fclose(file);
+
+    if (compared == 0) {
+        fprintf(stderr, "FAIL: %s has no kernel in common with this run\n", path);
+        return false;
+    }
+    if (regressions > 0) {
+        fprintf(stderr, "FAIL: %zu of %zu kernels regressed\n", regressions, compared);
+        return false;
+    }
+    return true;
+}
+
+
+/* ========================================================================= */
+/* MAIN                                                                      */
+/* ========================================================================= */
+
+int main(int argc, char **argv) {
+    const char *trace_path = argc > 1 && strcmp(argv[1], "-") != 0 ? argv[1] : NULL;
+    long samples = argc > 2 ? strtol(argv[2], NULL, 10) : BENCH_DEFAULT_SAMPLES;
+    const char *results_path = argc > 3 && strcmp(argv[3], "-") != 0 ? argv[3] : NULL;
+    const char *baseline_path = argc > 4 ? argv[4] : NULL;
+    if (samples <= 0) {
+        samples = BENCH_DEFAULT_SAMPLES;
+    }
+
+    if (!model_windows_init() ||
+            running_filter.design_butterworth(true, 4, BENCH_SAMPLE_RATE_HZ, 0.5f) != EIDSP_OK) {
+        fprintf(stderr, "Failed to initialize the kernels\n");
+        return 1;
+    }
+
+    window_set_t synthetic, trace;
+    if (!synthetic_set(&synthetic) || !bench_set(&synthetic, samples)) {
+        return 1;
+    }
+    if (trace_path && (!trace_set(trace_path, &trace) || !bench_set(&trace, samples))) {
+        return 1;
+    }
+
+    if (results_path && !write_results(results_path)) {
+        return 1;
+    }
+    if (baseline_path && !check_baseline(baseline_path)) {
+        return 1;
+    }
+
+    free(synthetic.windows);
+    free(synthetic.features);
+    if (trace_path) {
+        free(trace.windows);
+        free(trace.features);
+    }
+    return 0;
+}
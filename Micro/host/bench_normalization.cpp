@@ -0,0 +1,244 @@
+/* Folded data normalization check (host only)
+ *
+ * The standard scaler of the impulse (z = (x - mean) * scale, one pass over
+ * the 56 features after the DSP block) is folded into the wavelet feature
+ * writer as z = x * scale + offset, with offset = -mean * scale in
+ * model_variables.h. This compares the folded path with the previous one,
+ * DSP block and then the separate scaler pass:
+ *
+ * 1. Table: every offset against -mean * scale computed in double.
+ * 2. Features: largest difference of the normalized features, in scaler
+ *    units, on synthetic windows and, if given, every window of a recorded
+ *    ADC trace (SEISMIC_ADC_FILE format).
+ * 3. Scores: both feature vectors through the float graph, largest
+ *    difference of the earthquake probability and top-1 agreement.
+ * 4. Latency: DSP block plus scaler pass vs. the folded DSP block.
+ *
+ * The process exits with status 1 if a difference exceeds its limit or the
+ * normalization is not folded in this build.
+ *
+ * Usage: bench_normalization [trace.txt|-] [windows] [iterations]
+ *        (default 1000 synthetic windows, 2000 timed windows)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "model_windows.h"
+#include "host_hal.h"
+
+#define BENCH_DEFAULT_WINDOWS    1000
+#define BENCH_DEFAULT_ITERATIONS 2000
+#define BENCH_SEED               0x2545F491u
+// offset table vs. -mean * scale: the table was folded from the exported
+// doubles, the check only sees mean and scale rounded to float
+#define BENCH_MAX_OFFSET_ULPS    2.0
+#define BENCH_MAX_FEATURE_ERROR  1e-4       // scaler units (features are ~N(0, 1))
+#define BENCH_MAX_PROB_ERROR     1e-4
+
+struct bench_stats_t {
+    const char *name;
+    size_t windows;
+    size_t agree;
+    double feature_error_max;
+    size_t feature_error_index;
+    double prob_error_max;
+};
+
+
+/* ========================================================================= */
+/* HELPERS                                                                   */
+/* ========================================================================= */
+
+static bool reference_features(const float *window, float *features) {
+    return model_windows_dsp(window, features) && model_windows_normalize(features);
+}
+
+
+/* ========================================================================= */
+/* TABLE                                                                     */
+/* ========================================================================= */
+
+static bool check_table(void) {
+    const float *mean, *scale, *folded_scale, *folded_offset;
+    model_windows_scaler(&mean, &scale, &folded_scale, &folded_offset);
+    if (!folded_scale || !folded_offset) {
+        fprintf(stderr, "Data normalization is not folded (EI_CLASSIFIER_DATA_NORMALIZATION_FOLDED=0)\n");
+        return false;
+    }
+
+    double worst_ulps = 0.0;
+    for (size_t i = 0; i < MODEL_WINDOW_FEATURES; i++) {
+        if (folded_scale[i] != scale[i]) {
+            fprintf(stderr, "Feature %zu: folded scale %g, scaler %g\n", i, folded_scale[i], scale[i]);
+            return false;
+        }
+        double want = -(double)mean[i] * (double)scale[i];
+        double ulp = (double)nextafterf(fabsf((float)want), INFINITY) - fabs((double)(float)want);
+        double ulps = ulp > 0.0 ? fabs((double)folded_offset[i] - want) / ulp : 0.0;
+        if (ulps > BENCH_MAX_OFFSET_ULPS) {
+            fprintf(stderr, "Feature %zu: offset %.9g, -mean * scale %.9g (%.1f ulp)\n",
+                    i, folded_offset[i], want, ulps);
+            return false;
+        }
+        worst_ulps = fmax(worst_ulps, ulps);
+    }
+    printf("Offset table: %d features within %.2f ulp of -mean * scale\n", MODEL_WINDOW_FEATURES, worst_ulps);
+    return true;
+}
+
+
+/* ========================================================================= */
+/* FEATURES AND SCORES                                                       */
+/* ========================================================================= */
+
+static bool compare_window(const float *window, bench_stats_t *stats) {
+    float reference[MODEL_WINDOW_FEATURES], folded[MODEL_WINDOW_FEATURES];
+    float p_reference[MODEL_WINDOW_LABELS], p_folded[MODEL_WINDOW_LABELS];
+
+    if (!reference_features(window, reference) || !model_windows_features(window, folded) ||
+            !model_windows_float(reference, p_reference) || !model_windows_float(folded, p_folded)) {
+        fprintf(stderr, "%s window %zu: DSP block or inference failed\n", stats->name, stats->windows);
+        return false;
+    }
+
+    for (size_t i = 0; i < MODEL_WINDOW_FEATURES; i++) {
+        double error = fabs((double)folded[i] - (double)reference[i]);
+        if (error > stats->feature_error_max) {
+            stats->feature_error_max = error;
+            stats->feature_error_index = i;
+        }
+    }
+    double prob_error = fabs((double)p_folded[MODEL_WINDOW_EARTHQUAKE] -
+                             (double)p_reference[MODEL_WINDOW_EARTHQUAKE]);
+    stats->prob_error_max = fmax(stats->prob_error_max, prob_error);
+    stats->agree += model_windows_top1(p_folded) == model_windows_top1(p_reference);
+    stats->windows++;
+    return true;
+}
+
+static bool print_stats(const bench_stats_t *stats) {
+    if (stats->windows == 0) {
+        return true;
+    }
+    printf("%-18s %6zu windows  |dz| max %.3g (feature %zu)  |dp| max %.3g  agree %6.2f %%\n",
+           stats->name, stats->windows, stats->feature_error_max, stats->feature_error_index,
+           stats->prob_error_max, 100.0 * stats->agree / stats->windows);
+    if (stats->feature_error_max > BENCH_MAX_FEATURE_ERROR || stats->prob_error_max > BENCH_MAX_PROB_ERROR) {
+        fprintf(stderr, "%s: folded normalization differs from the scaler pass\n", stats->name);
+        return false;
+    }
+    return true;
+}
+
+
+/* ========================================================================= */
+/* TIMING                                                                    */
+/* ========================================================================= */
+
+static void bench_timing(long iterations) {
+    float *windows = (float*)malloc(iterations * MODEL_WINDOW_SAMPLES * sizeof(float));
+    float features[MODEL_WINDOW_FEATURES];
+    volatile float sink = 0.0f;  // keeps the results alive
+    uint32_t state = BENCH_SEED;
+    if (!windows) {
+        fprintf(stderr, "Out of memory for %ld timing windows\n", iterations);
+        return;
+    }
+    for (long w = 0; w < iterations; w++) {
+        model_windows_synthetic(&state, windows + w * MODEL_WINDOW_SAMPLES);
+    }
+
+    double start = host_wall_time_s();
+    for (long w = 0; w < iterations; w++) {
+        model_windows_dsp(windows + w * MODEL_WINDOW_SAMPLES, features);
+        sink += features[0];
+    }
+    double dsp_s = host_wall_time_s() - start;
+
+    start = host_wall_time_s();
+    for (long w = 0; w < iterations; w++) {
+        model_windows_normalize(features);
+        sink += features[0];
+    }
+    double scaler_s = host_wall_time_s() - start;
+
+    start = host_wall_time_s();
+    for (long w = 0; w < iterations; w++) {
+        model_windows_features(windows + w * MODEL_WINDOW_SAMPLES, features);
+        sink += features[0];
+    }
+    double folded_s = host_wall_time_s() - start;
+    (void)sink;
+    free(windows);
+
+    printf("Latency per window (%ld windows)\n", iterations);
+    printf("    DSP block + scaler pass  %8.2f us  (scaler %.3f us)\n",
+           1e6 * (dsp_s + scaler_s) / iterations, 1e6 * scaler_s / iterations);
+    printf("    folded DSP block         %8.2f us\n", 1e6 * folded_s / iterations);
+}
+
+
+/* ========================================================================= */
+/* MAIN                                                                      */
+/* ========================================================================= */
+
+int main(int argc, char **argv) {
+    const char *trace_path = argc > 1 && strcmp(argv[1], "-") != 0 ? argv[1] : NULL;
+    long windows = argc > 2 ? strtol(argv[2], NULL, 10) : BENCH_DEFAULT_WINDOWS;
+    long iterations = argc > 3 ? strtol(argv[3], NULL, 10) : BENCH_DEFAULT_ITERATIONS;
+    if (windows < 0) {
+        windows = BENCH_DEFAULT_WINDOWS;
+    }
+    if (iterations <= 0) {
+        iterations = BENCH_DEFAULT_ITERATIONS;
+    }
+
+    if (!model_windows_init() || !model_windows_float_init()) {
+        fprintf(stderr, "Failed to initialize the impulse\n");
+        return 1;
+    }
+    if (!check_table()) {
+        return 1;
+    }
+
+    bench_stats_t event = { "synthetic event", 0, 0, 0.0, 0, 0.0 };
+    bench_stats_t noise = { "synthetic noise", 0, 0, 0.0, 0, 0.0 };
+    bench_stats_t trace = { "recorded trace", 0, 0, 0.0, 0, 0.0 };
+
+    float window[MODEL_WINDOW_SAMPLES];
+    uint32_t state = BENCH_SEED;
+    for (long w = 0; w < windows; w++) {
+        bool has_event = model_windows_synthetic(&state, window);
+        if (!compare_window(window, has_event ? &event : &noise)) {
+            return 1;
+        }
+    }
+
+    if (trace_path) {
+        float *samples = NULL;
+        size_t count = model_windows_load_trace(trace_path, &samples);
+        if (count == 0) {
+            return 1;
+        }
+        for (size_t end = MODEL_WINDOW_SAMPLES; end <= count; end += MODEL_WINDOW_STRIDE) {
+            if (!compare_window(samples + end - MODEL_WINDOW_SAMPLES, &trace)) {
+                free(samples);
+                return 1;
+            }
+        }
+        free(samples);
+    }
+
+    printf("Folded vs. separate normalization (features, float graph scores)\n");
+    bool ok = print_stats(&event);
+    ok = print_stats(&noise) && ok;
+    ok = print_stats(&trace) && ok;
+    if (!ok) {
+        return 1;
+    }
+
+    bench_timing(iterations);
+    return 0;
+}
@@ -0,0 +1,184 @@
+/* Percentile kernel benchmark (host only)
+ *
+ * Compares the selection based percentiles used by the wavelet statistics
+ * (ei::spectral::select_ranks) with the previous path that sorted a copy of
+ * every coefficient band. Bands have the lengths produced by the deployed
+ * block (1000-sample window, bior3.7, level 3), and include runs of exact
+ * zeros as left behind by underflow_handling.
+ *
+ * Every trial checks that both paths return bit-identical values; the
+ * process exits with status 1 on the first mismatch.
+ *
+ * The same goes for the DWT filter: in builds that fix it at compile time
+ * (EIDSP_WAVELET_FIXED_FILTER, bior3.7 for the deployed impulse), the
+ * unrolled kernel must match the generic dot() over the same taps at every
+ * output position of BENCH_FILTER_WINDOWS windows.
+ *
+ * Usage: bench_percentile [iterations]   (default 20000)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include "model-parameters/model_metadata.h"
+#include "edge-impulse-sdk/dsp/spectral/wavelet.hpp"
+#include "host_hal.h"
+
+#define BENCH_DEFAULT_ITERATIONS 20000
+#define BENCH_PERCENTILE_COUNT   5
+#define BENCH_SET_COUNT          64
+#define BENCH_FILTER_WINDOWS     20
+#define BENCH_WINDOW             1000
+
+static const float percentiles[BENCH_PERCENTILE_COUNT] = { 0.05f, 0.25f, 0.5f, 0.75f, 0.95f };
+
+// detail bands of levels 1-3 and the final approximation
+static const size_t band_lengths[] = { 507, 261, 138, 138 };
+#define BENCH_BAND_COUNT (sizeof(band_lengths) / sizeof(band_lengths[0]))
+
+static uint32_t rng_state = 0x9E3779B9u;
+
+
+/* ========================================================================= */
+/* HELPERS                                                                   */
+/* ========================================================================= */
+
+static float next_float(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (float)(rng_state & 0xFFFFFF) / (float)0x800000 - 1.0f;
+}
+
+static void fill_band(float *band, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        // sum of uniforms for a rough bell shape, ~10% exact zeros
+        float v = next_float() + next_float() + next_float();
+        band[i] = (rng_state % 10 == 0) ? 0.0f : v * 1e-3f;
+    }
+}
+
+static void percentiles_sort(const float *band, size_t n, float *scratch, float *out) {
+    memcpy(scratch, band, n * sizeof(float));
+    std::sort(scratch, scratch + n);
+    for (size_t i = 0; i < BENCH_PERCENTILE_COUNT; i++) {
+        out[i] = scratch[ei::spectral::percentile_index(n, percentiles[i])];
+    }
+}
+
+static void percentiles_select(const float *band, size_t n, float *scratch, float *out) {
+    size_t ranks[BENCH_PERCENTILE_COUNT];
+    for (size_t i = 0; i < BENCH_PERCENTILE_COUNT; i++) {
+        ranks[i] = ei::spectral::percentile_index(n, percentiles[i]);
+    }
+    memcpy(scratch, band, n * sizeof(float));
+    ei::spectral::select_ranks(scratch, n, ranks, BENCH_PERCENTILE_COUNT, out);
+}
+
+
+/* ========================================================================= */
+/* FIXED FILTER                                                              */
+/* ========================================================================= */
+
+static bool check_fixed_filter(void) {
+#ifdef EIDSP_WAVELET_FIXED_FILTER
+    typedef ei::spectral::EIDSP_WAVELET_FIXED_FILTER fixed;
+    float h[fixed::length], g[fixed::length];
+    float window[BENCH_WINDOW];
+    for (size_t i = 0; i < fixed::length; i++) {
+        h[i] = fixed::dec_lo(fixed::length - i - 1);
+        g[i] = fixed::dec_hi(fixed::length - i - 1);
+    }
+
+    for (size_t w = 0; w < BENCH_FILTER_WINDOWS; w++) {
+        fill_band(window, BENCH_WINDOW);
+        for (size_t i = 0; i + fixed::length <= BENCH_WINDOW; i++) {
+            float a = 0.0f, d = 0.0f;
+            ei::spectral::fixed_dwt_taps<fixed>::accumulate(window + i, a, d);
+            float a_ref = ei::spectral::dot(window + i, h, fixed::length);
+            float d_ref = ei::spectral::dot(window + i, g, fixed::length);
+            if (memcmp(&a, &a_ref, sizeof(a)) != 0 || memcmp(&d, &d_ref, sizeof(d)) != 0) {
+                fprintf(stderr, "Fixed %s kernel differs in window %zu at sample %zu\n", fixed::name(), w, i);
+                return false;
+            }
+        }
+    }
+    printf("Fixed %s DWT kernel (%d windows), results bit-identical to dot()\n",
+           fixed::name(), BENCH_FILTER_WINDOWS);
+#else
+    printf("Wavelet filter looked up at runtime, no fixed DWT kernel to check\n");
+#endif
+    return true;
+}
+
+/* ========================================================================= */
+/* MAIN                                                                      */
+/* ========================================================================= */
+
+int main(int argc, char **argv) {
+    long iterations = argc > 1 ? strtol(argv[1], NULL, 10) : BENCH_DEFAULT_ITERATIONS;
+    if (iterations <= 0) {
+        iterations = BENCH_DEFAULT_ITERATIONS;
+    }
+
+    size_t max_len = *std::max_element(band_lengths, band_lengths + BENCH_BAND_COUNT);
+    float *sets = (float *)malloc(BENCH_SET_COUNT * BENCH_BAND_COUNT * max_len * sizeof(float));
+    float *scratch = (float *)malloc(max_len * sizeof(float));
+    if (!sets || !scratch) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    for (size_t s = 0; s < BENCH_SET_COUNT * BENCH_BAND_COUNT; s++) {
+        fill_band(sets + s * max_len, band_lengths[s % BENCH_BAND_COUNT]);
+    }
+
+    // correctness: both paths on every band, compared bit for bit
+    for (size_t s = 0; s < BENCH_SET_COUNT * BENCH_BAND_COUNT; s++) {
+        const float *band = sets + s * max_len;
+        size_t n = band_lengths[s % BENCH_BAND_COUNT];
+        float ref[BENCH_PERCENTILE_COUNT];
+        float sel[BENCH_PERCENTILE_COUNT];
+        percentiles_sort(band, n, scratch, ref);
+        percentiles_select(band, n, scratch, sel);
+        if (memcmp(ref, sel, sizeof(ref)) != 0) {
+            fprintf(stderr, "Mismatch in band %zu (n=%zu)\n", s, n);
+            return 1;
+        }
+    }
+
+    if (!check_fixed_filter()) {
+        return 1;
+    }
+
+    // timing: one iteration is the four bands of one window
+    volatile float sink = 0.0f; // keeps the results alive
+    float out[BENCH_PERCENTILE_COUNT];
+    double elapsed[2];
+    for (int path = 0; path < 2; path++) {
+        double start = host_wall_time_s();
+        for (long it = 0; it < iterations; it++) {
+            const float *set = sets + (it % BENCH_SET_COUNT) * BENCH_BAND_COUNT * max_len;
+            for (size_t b = 0; b < BENCH_BAND_COUNT; b++) {
+                if (path == 0) {
+                    percentiles_sort(set + b * max_len, band_lengths[b], scratch, out);
+                } else {
+                    percentiles_select(set + b * max_len, band_lengths[b], scratch, out);
+                }
+                sink += out[0];
+            }
+        }
+        elapsed[path] = host_wall_time_s() - start;
+    }
+
+    printf("Percentiles per window (%zu bands, %ld iterations), results bit-identical\n",
+           (size_t)BENCH_BAND_COUNT, iterations);
+    printf("    sort:       %8.2f us\n", elapsed[0] * 1e6 / iterations);
+    printf("    selection:  %8.2f us\n", elapsed[1] * 1e6 / iterations);
+    printf("    speed-up:   %8.2fx\n", elapsed[1] > 0.0 ? elapsed[0] / elapsed[1] : 0.0);
+
+    free(sets);
+    free(scratch);
+    return 0;
+}
@@ -0,0 +1,294 @@
+/* Stage profiler benchmark (host only)
+ *
+ * Runs run_classifier() on synthetic windows with the stage profiler
+ * (edge-impulse-sdk/dsp/ei_profiler.h) active and reports where the time
+ * goes, per stage, wavelet level and EON graph node.
+ *
+ * 1. Records: every run must record each stage once (one record per wavelet
+ *    level and per executed graph node), and the nested stages must fit in
+ *    their parent (nodes in inference, DSP stages in dsp, all in impulse).
+ * 2. Ring: after more than EI_PROFILER_RING_SIZE records the ring holds the
+ *    newest ones, oldest first; the binary dump must parse back to the same
+ *    records.
+ * 3. Overhead: run_classifier() time with the profiler active vs. inactive.
+ *
+ * The process exits with status 1 on the first failed check.
+ *
+ * Usage: bench_profiler [windows] [dump.bin]
+ *        (default 200 windows; dump.bin receives the binary dump of the ring)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "edge-impulse-sdk/dsp/ei_profiler.h"
+#include "model_windows.h"
+#include "host_hal.h"
+
+#define BENCH_DEFAULT_WINDOWS 200
+#define BENCH_SEED            0xC2B2AE35u
+#define BENCH_MAX_INDEX       32
+
+#if !EI_PROFILER_ENABLED
+#error "bench_profiler needs EI_PROFILER_ENABLED=1 (host/host.cmake)"
+#endif
+
+struct stage_stats_t {
+    size_t count;
+    double sum_us;
+    uint32_t max_us;
+};
+
+static stage_stats_t stats[EI_PROFILE_STAGE_COUNT][BENCH_MAX_INDEX];
+static float window[MODEL_WINDOW_SAMPLES];
+static size_t records_per_run;
+
+
+/* ========================================================================= */
+/* HELPERS                                                                   */
+/* ========================================================================= */
+
+static bool classify(const float *samples) {
+    float probs[MODEL_WINDOW_LABELS];
+    return model_windows_classify(samples, probs);
+}
+
+static size_t write_buffer(const void *data, size_t len, void *ctx) {
+    std::vector<uint8_t> *buffer = (std::vector<uint8_t>*)ctx;
+    buffer->insert(buffer->end(), (const uint8_t*)data, (const uint8_t*)data + len);
+    return len;
+}
+
+static size_t write_file(const void *data, size_t len, void *ctx) {
+    return fwrite(data, 1, len, (FILE*)ctx);
+}
+
+// Records one run is expected to produce, from the wavelet bands and graph
+// nodes the first run recorded
+static size_t expected_records(size_t wavelet_bands, size_t node_records) {
+    // impulse, dsp, signal copy, 2 x scaling, levels + approximation,
+    // normalization, inference, nodes, postprocessing
+    return 1 + 1 + 1 + 2 + wavelet_bands + 1 + 1 + node_records + 1;
+}
+
+
+/* ========================================================================= */
+/* RECORDS                                                                   */
+/* ========================================================================= */
+
+// Checks the records of one run and adds them to the statistics
+static bool check_run(const ei_profile_record_t *records, size_t count, size_t expected) {
+    uint32_t total[EI_PROFILE_STAGE_COUNT] = { 0 };
+    size_t seen[EI_PROFILE_STAGE_COUNT] = { 0 };
+
+    for (size_t i = 0; i < count; i++) {
+        const ei_profile_record_t *r = &records[i];
+        if (r->stage >= EI_PROFILE_STAGE_COUNT || r->index >= BENCH_MAX_INDEX || r->run != records[0].run) {
+            fprintf(stderr, "FAIL: unexpected record (run %u, stage %u, index %u)\n",
+                    (unsigned)r->run, (unsigned)r->stage, (unsigned)r->index);
+            return false;
+        }
+        stage_stats_t *s = &stats[r->stage][r->index];
+        s->count++;
+        s->sum_us += r->duration_us;
+        s->max_us = r->duration_us > s->max_us ? r->duration_us : s->max_us;
+        total[r->stage] += r->duration_us;
+        seen[r->stage]++;
+    }
+
+    if (count != expected) {
+        fprintf(stderr, "FAIL: run %u recorded %zu stages, expected %zu\n",
+                (unsigned)records[0].run, count, expected);
+        return false;
+    }
+    for (int stage = 0; stage < EI_PROFILE_STAGE_COUNT; stage++) {
+        if (seen[stage] == 0) {
+            fprintf(stderr, "FAIL: run %u has no %s record\n",
+                    (unsigned)records[0].run, ei_profiler_stage_name(stage));
+            return false;
+        }
+    }
+
+    uint32_t dsp_parts = total[EI_PROFILE_SIGNAL_COPY] + total[EI_PROFILE_SCALING] +
+                         total[EI_PROFILE_WAVELET_LEVEL] + total[EI_PROFILE_NORMALIZATION];
+    if (dsp_parts > total[EI_PROFILE_DSP] ||
+            total[EI_PROFILE_NODE] > total[EI_PROFILE_INFERENCE] ||
+            total[EI_PROFILE_DSP] + total[EI_PROFILE_INFERENCE] + total[EI_PROFILE_POSTPROCESSING] >
+                total[EI_PROFILE_IMPULSE]) {
+        fprintf(stderr, "FAIL: run %u has nested stages longer than their parent\n",
+                (unsigned)records[0].run);
+        return false;
+    }
+    return true;
+}
+
+static bool bench_records(long windows) {
+    ei_profile_record_t records[EI_PROFILER_RING_SIZE];
+    uint32_t state = BENCH_SEED;
+
+    for (long w = 0; w < windows; w++) {
+        model_windows_synthetic(&state, window);
+        ei_profiler_clear();
+        if (!classify(window)) {
+            fprintf(stderr, "FAIL: run_classifier on window %ld\n", w);
+            return false;
+        }
+
+        size_t count = ei_profiler_read(records, EI_PROFILER_RING_SIZE);
+        if (w == 0) {
+            size_t bands = 0, nodes = 0;
+            for (size_t i = 0; i < count; i++) {
+                bands += records[i].stage == EI_PROFILE_WAVELET_LEVEL;
+                nodes += records[i].stage == EI_PROFILE_NODE;
+            }
+            records_per_run = expected_records(bands, nodes);
+        }
+        if (!check_run(records, count, records_per_run)) {
+            return false;
+        }
+    }
+
+    printf("Stage timings (%ld windows, us)\n", windows);
+    printf("    %-16s %5s %10s %10s\n", "stage", "index", "mean", "max");
+    for (int stage = 0; stage < EI_PROFILE_STAGE_COUNT; stage++) {
+        for (int index = 0; index < BENCH_MAX_INDEX; index++) {
+            const stage_stats_t *s = &stats[stage][index];
+            if (s->count > 0) {
+                printf("    %-16s %5d %10.2f %10u\n", ei_profiler_stage_name(stage), index,
+                       s->sum_us / s->count, (unsigned)s->max_us);
+            }
+        }
+    }
+    printf("    %zu records per run\n", records_per_run);
+    return true;
+}
+
+
+/* ========================================================================= */
+/* RING                                                                      */
+/* ========================================================================= */
+
+static bool bench_ring(const char *dump_path) {
+    static ei_profile_record_t records[EI_PROFILER_RING_SIZE];
+    static ei_profile_record_t parsed[EI_PROFILER_RING_SIZE];
+    uint32_t state = BENCH_SEED;
+
+    // enough runs to wrap the ring twice
+    const size_t runs = 2 * EI_PROFILER_RING_SIZE / records_per_run + 1;
+    ei_profiler_clear();
+    for (size_t r = 0; r < runs; r++) {
+        model_windows_synthetic(&state, window);
+        if (!classify(window)) {
+            fprintf(stderr, "FAIL: run_classifier\n");
+            return false;
+        }
+    }
+
+    size_t count = ei_profiler_read(records, EI_PROFILER_RING_SIZE);
+    if (count != EI_PROFILER_RING_SIZE) {
+        fprintf(stderr, "FAIL: ring holds %zu records, expected %d\n", count, EI_PROFILER_RING_SIZE);
+        return false;
+    }
+    for (size_t i = 1; i < count; i++) {
+        uint16_t step = (uint16_t)(records[i].run - records[i - 1].run);
+        if (step > 1) {
+            fprintf(stderr, "FAIL: ring records out of order at %zu\n", i);
+            return false;
+        }
+    }
+    // the newest record closes the last run
+    if (records[count - 1].stage != EI_PROFILE_IMPULSE) {
+        fprintf(stderr, "FAIL: newest record is %s, expected impulse\n",
+                ei_profiler_stage_name(records[count - 1].stage));
+        return false;
+    }
+
+    std::vector<uint8_t> dump;
+    size_t bytes = ei_profiler_dump_binary(write_buffer, &dump);
+    int parsed_count = ei_profiler_parse_binary(dump.data(), dump.size(), parsed, EI_PROFILER_RING_SIZE);
+    if (bytes != EI_PROFILER_HEADER_BYTES + count * EI_PROFILER_RECORD_BYTES || parsed_count != (int)count) {
+        fprintf(stderr, "FAIL: binary dump of %zu bytes parsed to %d records\n", bytes, parsed_count);
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (parsed[i].start_us != records[i].start_us || parsed[i].duration_us != records[i].duration_us ||
+                parsed[i].run != records[i].run || parsed[i].stage != records[i].stage ||
+                parsed[i].index != records[i].index) {
+            fprintf(stderr, "FAIL: binary dump differs at record %zu\n", i);
+            return false;
+        }
+    }
+    if (ei_profiler_parse_binary(dump.data(), dump.size() - 1, parsed, EI_PROFILER_RING_SIZE) != -1) {
+        fprintf(stderr, "FAIL: truncated dump was accepted\n");
+        return false;
+    }
+
+    printf("Ring: %zu runs, %zu records held, binary dump %zu bytes\n", runs, count, bytes);
+
+    if (dump_path) {
+        FILE *file = fopen(dump_path, "wb");
+        if (!file || ei_profiler_dump_binary(write_file, file) != bytes) {
+            fprintf(stderr, "FAIL: cannot write %s\n", dump_path);
+            if (file) {
+                fclose(file);
+            }
+            return false;
+        }
+        fclose(file);
+        printf("Wrote %s\n", dump_path);
+    }
+    return true;
+}
+
+
+/* ========================================================================= */
+/* OVERHEAD                                                                  */
+/* ========================================================================= */
+
+static double time_runs(long windows) {
+    uint32_t state = BENCH_SEED;
+    double start = host_wall_time_s();
+    for (long w = 0; w < windows; w++) {
+        model_windows_synthetic(&state, window);
+        classify(window);
+        ei_profiler_clear();
+    }
+    return (host_wall_time_s() - start) * 1e6 / windows;
+}
+
+static void bench_overhead(long windows) {
+    ei_profiler_set_active(false);
+    double inactive_us = time_runs(windows);
+    ei_profiler_set_active(true);
+    double active_us = time_runs(windows);
+
+    printf("run_classifier (incl. synthetic window)\n");
+    printf("    profiler inactive: %8.2f us/window\n", inactive_us);
+    printf("    profiler active:   %8.2f us/window\n", active_us);
+}
+
+
+/* ========================================================================= */
+/* MAIN                                                                      */
+/* ========================================================================= */
+
+int main(int argc, char **argv) {
+    long windows = argc > 1 ? strtol(argv[1], NULL, 10) : BENCH_DEFAULT_WINDOWS;
+    const char *dump_path = argc > 2 ? argv[2] : NULL;
+    if (windows <= 0) {
+        windows = BENCH_DEFAULT_WINDOWS;
+    }
+
+    if (!model_windows_init()) {
+        fprintf(stderr, "Failed to initialize the impulse\n");
+        return 1;
+    }
+    ei_profiler_set_active(true);
+
+    if (!bench_records(windows) || !bench_ring(dump_path)) {
+        return 1;
+    }
+    bench_overhead(windows);
+    return 0;
+}
@@ -0,0 +1,299 @@
+/* STA/LTA trigger check (host only)
+ *
+ * Drives trigger_push() with the main.cpp settings (trigger.h defaults at
+ * 100 Hz, 1000-sample windows, stride 250, hold of one window) on synthetic
+ * Gaussian noise around the ADC mid-scale offset, with and without a step
+ * in amplitude (the event).
+ *
+ * 1. Noise: no onset over an hour, no window before the ring is full, then
+ *    a heartbeat window exactly every heartbeat samples.
+ * 2. Steps at random phases: the ratio crosses on_ratio within the STA
+ *    length of the step, the onset window comes exactly lead samples after
+ *    the crossing (and nothing before it), ACTIVE windows follow every
+ *    stride, the trigger releases on the first sample below off_ratio and
+ *    not before, ACTIVE windows stop hold samples after the release and the
+ *    heartbeat resumes one period after the last window. Run with the
+ *    default lead and with lead 0 (the window ending at the onset sample).
+ * 3. Onset latency: event samples in the onset window and step-to-window
+ *    delay for both leads, against the first window of the plain stride
+ *    schedule holding at least lead samples of the event. The delayed
+ *    onset window must still come sooner on average.
+ * 4. Cost of trigger_push() per sample.
+ *
+ * The process exits with status 1 on the first failed check.
+ *
+ * Usage: bench_trigger [steps]   (default 500 steps per lead)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include "trigger.h"
+#include "host_hal.h"
+
+#define BENCH_DEFAULT_STEPS     500
+#define BENCH_RATE_HZ           100
+#define BENCH_WINDOW            1000        // As WINDOW_SIZE
+#define BENCH_STRIDE            250         // As INFERENCE_STRIDE
+#define BENCH_OFFSET            2048.0f     // ADC mid-scale
+#define BENCH_NOISE             4.0f        // Noise sigma, ADC codes
+#define BENCH_EVENT_GAIN        10.0f       // Amplitude during the event
+#define BENCH_EVENT_S           20          // Event length
+#define BENCH_QUIET_S           60          // After the event, per step
+#define BENCH_NOISE_S           3600        // Check 1
+#define BENCH_TIMING_SAMPLES    10000000
+
+static uint32_t rng_state = 0x9E3779B9u;
+
+typedef struct {
+    uint32_t sample;
+    trigger_window_t window;
+} window_event_t;
+
+typedef struct {
+    double event_samples;       // Sum over the steps
+    double delay;               // Step to window end, sum
+    uint32_t delay_max;
+} latency_t;
+
+
+/* ========================================================================= */
+/* HELPERS                                                                   */
+/* ========================================================================= */
+
+static float rand_uniform(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return ((float)(rng_state >> 8) + 0.5f) / 16777216.0f;
+}
+
+static float rand_gauss(void) {
+    return sqrtf(-2.0f * logf(rand_uniform())) * cosf(6.2831853f * rand_uniform());
+}
+
+static void init_trigger(trigger_t *trigger, uint32_t lead) {
+    trigger_init(trigger, (uint32_t)(TRIGGER_STA_S * BENCH_RATE_HZ), (uint32_t)(TRIGGER_LTA_S * BENCH_RATE_HZ),
+                 TRIGGER_ON_RATIO, TRIGGER_OFF_RATIO, BENCH_STRIDE,
+                 (uint32_t)(TRIGGER_HEARTBEAT_S * BENCH_RATE_HZ), BENCH_WINDOW, lead);
+}
+
+static void fail(const char *what, uint32_t step, uint32_t sample) {
+    fprintf(stderr, "FAIL: %s (step %u, sample %u)\n", what, step, sample);
+    exit(1);
+}
+
+static void add_latency(latency_t *latency, uint32_t event_samples, uint32_t delay) {
+    latency->event_samples += event_samples;
+    latency->delay += delay;
+    latency->delay_max = delay > latency->delay_max ? delay : latency->delay_max;
+}
+
+
+/* ========================================================================= */
+/* NOISE                                                                     */
+/* ========================================================================= */
+
+static void check_noise(void) {
+    trigger_t trigger;
+    init_trigger(&trigger, (uint32_t)(TRIGGER_ONSET_LEAD_S * BENCH_RATE_HZ));
+
+    uint32_t samples = BENCH_NOISE_S * BENCH_RATE_HZ;
+    uint32_t expected = (trigger.heartbeat > BENCH_WINDOW ? trigger.heartbeat : BENCH_WINDOW) - 1;
+    uint32_t windows = 0;
+    float ratio_max = 0.0f;
+    for (uint32_t i = 0; i < samples; i++) {
+        trigger_window_t window = trigger_push(&trigger, BENCH_OFFSET + BENCH_NOISE * rand_gauss(),
+                                               i + 1 >= BENCH_WINDOW);
+        float ratio = trigger_ratio(&trigger);
+        ratio_max = ratio > ratio_max ? ratio : ratio_max;
+        if (trigger.triggered) {
+            fail("noise tripped the trigger", 0, i);
+        }
+        if (window == TRIGGER_WINDOW_NONE) {
+            if (i == expected) {
+                fail("missing heartbeat window on noise", 0, i);
+            }
+            continue;
+        }
+        if (window != TRIGGER_WINDOW_HEARTBEAT || i != expected) {
+            fail("unexpected window on noise", 0, i);
+        }
+        windows++;
+        expected = i + trigger.heartbeat;
+    }
+    printf("Noise (%d s)             : %u heartbeat windows, every %u samples, max ratio %.2f\n",
+           BENCH_NOISE_S, windows, trigger.heartbeat, (double)ratio_max);
+}
+
+
+/* ========================================================================= */
+/* STEPS                                                                     */
+/* ========================================================================= */
+
+// One step at a random phase after the warm-up; checks the schedule around
+// it and adds its onset latency. stride_latency gets the plain stride
+// schedule's first window with at least the trigger's lead of event samples.
+static void run_step(uint32_t step, uint32_t lead, latency_t *latency, latency_t *stride_latency) {
+    trigger_t trigger;
+    init_trigger(&trigger, lead);
+    uint32_t sta_samples = (uint32_t)(TRIGGER_STA_S * BENCH_RATE_HZ);
+
+    uint32_t start = trigger.lta_samples + BENCH_WINDOW +
+                     (uint32_t)(rand_uniform() * (float)trigger.heartbeat);
+    uint32_t end = start + BENCH_EVENT_S * BENCH_RATE_HZ;
+    uint32_t samples = end + BENCH_QUIET_S * BENCH_RATE_HZ;
+
+    std::vector<window_event_t> windows;
+    uint32_t crossing = 0;
+    uint32_t release = 0;
+    bool seen_crossing = false;
+    bool seen_release = false;
+    for (uint32_t i = 0; i < samples; i++) {
+        float gain = (i >= start && i < end) ? BENCH_EVENT_GAIN : 1.0f;
+        bool was_triggered = trigger.triggered;
+        trigger_window_t window = trigger_push(&trigger, BENCH_OFFSET + gain * BENCH_NOISE * rand_gauss(),
+                                               i + 1 >= BENCH_WINDOW);
+        float ratio = trigger_ratio(&trigger);
+
+        if (!was_triggered && trigger.triggered) {
+            if (seen_crossing) {
+                fail("second onset", step, i);
+            }
+            seen_crossing = true;
+            crossing = i;
+        }
+        if (was_triggered && !trigger.triggered) {
+            if (ratio >= trigger.off_ratio) {
+                fail("released above off_ratio", step, i);
+            }
+            seen_release = true;
+            release = i;
+        }
+        if (trigger.triggered && ratio < trigger.off_ratio) {
+            fail("still triggered below off_ratio", step, i);
+        }
+        if (window != TRIGGER_WINDOW_NONE) {
+            window_event_t event = { i, window };
+            windows.push_back(event);
+        }
+    }
+
+    if (!seen_crossing || crossing < start || crossing >= start + sta_samples) {
+        fail("onset not within the STA length of the step", step, crossing);
+    }
+    if (!seen_release) {
+        fail("no release after the event", step, samples);
+    }
+
+    // Heartbeats up to the onset window, nothing between the crossing and it
+    size_t k = 0;
+    uint32_t previous = 0;
+    while (k < windows.size() && windows[k].sample < crossing) {
+        if (windows[k].window != TRIGGER_WINDOW_HEARTBEAT) {
+            fail("non-heartbeat window before the onset", step, windows[k].sample);
+        }
+        previous = windows[k++].sample;
+    }
+    if (k == windows.size() || windows[k].window != TRIGGER_WINDOW_ONSET || windows[k].sample != crossing + lead) {
+        fail("onset window not lead samples after the crossing", step, k < windows.size() ? windows[k].sample : 0);
+    }
+    uint32_t onset_window = windows[k].sample;
+    previous = windows[k++].sample;
+
+    // ACTIVE every stride up to the last held sample
+    uint32_t hold_end = release + trigger.hold - 1;
+    while (k < windows.size() && windows[k].window == TRIGGER_WINDOW_ACTIVE) {
+        if (windows[k].sample != previous + trigger.stride || windows[k].sample > hold_end) {
+            fail("active window off the stride or past the hold", step, windows[k].sample);
+        }
+        previous = windows[k++].sample;
+    }
+    if (previous + trigger.stride <= hold_end) {
+        fail("active windows stopped before the end of the hold", step, previous);
+    }
+
+    // Then heartbeats again, the first one a period after the last window
+    while (k < windows.size()) {
+        if (windows[k].window != TRIGGER_WINDOW_HEARTBEAT || windows[k].sample != previous + trigger.heartbeat) {
+            fail("heartbeat not resumed after the hold", step, windows[k].sample);
+        }
+        previous = windows[k++].sample;
+    }
+    if (previous + trigger.heartbeat < samples) {
+        fail("missing heartbeat after the hold", step, previous);
+    }
+
+    // Latency against a window every stride (phase from the full ring, as
+    // main.cpp without the trigger)
+    add_latency(latency, onset_window + 1 - start, onset_window - start);
+    uint32_t wanted = start + (lead > 0 ? lead : 1) - 1;
+    uint32_t stride_window = BENCH_WINDOW - 1;
+    while (stride_window < wanted) {
+        stride_window += BENCH_STRIDE;
+    }
+    add_latency(stride_latency, stride_window + 1 - start, stride_window - start);
+}
+
+static void check_steps(uint32_t steps, uint32_t lead, latency_t *latency, latency_t *stride_latency) {
+    for (uint32_t step = 0; step < steps; step++) {
+        run_step(step, lead, latency, stride_latency);
+    }
+}
+
+static void print_latency(const char *name, const latency_t *latency, uint32_t steps) {
+    printf("  %-22s: %6.1f event samples in the window, delay mean %6.1f max %4u samples\n",
+           name, latency->event_samples / steps, latency->delay / steps, latency->delay_max);
+}
+
+
+/* ========================================================================= */
+/* MAIN                                                                      */
+/* ========================================================================= */
+
+int main(int argc, char **argv) {
+    uint32_t steps = argc > 1 ? (uint32_t)atoi(argv[1]) : BENCH_DEFAULT_STEPS;
+    if (steps == 0) {
+        fprintf(stderr, "Usage: %s [steps]\n", argv[0]);
+        return 1;
+    }
+    uint32_t lead = (uint32_t)(TRIGGER_ONSET_LEAD_S * BENCH_RATE_HZ);
+
+    printf("STA %.1f s, LTA %.1f s, on %.1f, off %.1f, heartbeat %.0f s, lead %u samples, stride %d, hold %d\n",
+           (double)TRIGGER_STA_S, (double)TRIGGER_LTA_S, (double)TRIGGER_ON_RATIO, (double)TRIGGER_OFF_RATIO,
+           (double)TRIGGER_HEARTBEAT_S, lead, BENCH_STRIDE, BENCH_WINDOW);
+
+    check_noise();
+
+    latency_t delayed = {}, delayed_stride = {}, immediate = {}, immediate_stride = {};
+    check_steps(steps, lead, &delayed, &delayed_stride);
+    check_steps(steps, 0, &immediate, &immediate_stride);
+    printf("Steps (%u per lead)       : onset, lead, stride, release, hold and heartbeat timing OK\n", steps);
+
+    printf("Onset latency:\n");
+    print_latency("onset, lead 0", &immediate, steps);
+    print_latency("onset, lead", &delayed, steps);
+    print_latency("stride, >= 1 sample", &immediate_stride, steps);
+    print_latency("stride, >= lead", &delayed_stride, steps);
+    if (delayed.delay >= delayed_stride.delay) {
+        fprintf(stderr, "FAIL: the delayed onset window is not ahead of the stride schedule\n");
+        return 1;
+    }
+
+    trigger_t trigger;
+    init_trigger(&trigger, lead);
+    std::vector<float> noise(4096);
+    for (size_t i = 0; i < noise.size(); i++) {
+        noise[i] = BENCH_OFFSET + BENCH_NOISE * rand_gauss();
+    }
+    uint32_t windows = 0;
+    double t0 = host_wall_time_s();
+    for (uint32_t i = 0; i < BENCH_TIMING_SAMPLES; i++) {
+        windows += trigger_push(&trigger, noise[i & 4095], true) != TRIGGER_WINDOW_NONE;
+    }
+    double elapsed = host_wall_time_s() - t0;
+    printf("trigger_push()           : %.1f ns per sample (%u windows)\n",
+           elapsed * 1e9 / BENCH_TIMING_SAMPLES, windows);
+    return 0;
+}
@@ -0,0 +1,62 @@
+/* Heap allocation counters - see heap_counters.h */
+
+#include <stdlib.h>
+#include <new>
+#include "heap_counters.h"
+
+heap_counters_t heap_counters;
+
+static void *count_allocation(void *ptr, size_t bytes) {
+    if (ptr) {
+        heap_counters.allocations++;
+        heap_counters.bytes += bytes;
+    }
+    return ptr;
+}
+
+static void count_free(void *ptr) {
+    if (ptr) {
+        heap_counters.frees++;
+    }
+    free(ptr);
+}
+
+void *ei_malloc(size_t size) {
+    return count_allocation(malloc(size), size);
+}
+
+void *ei_calloc(size_t nitems, size_t size) {
+    return count_allocation(calloc(nitems, size), nitems * size);
+}
+
+void ei_free(void *ptr) {
+    count_free(ptr);
+}
+
+void *operator new(size_t size) {
+    void *ptr = count_allocation(malloc(size ? size : 1), size);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    return count_allocation(malloc(size ? size : 1), size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+    return count_allocation(malloc(size ? size : 1), size);
+}
+
+void operator delete(void *ptr) noexcept {
+    count_free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    count_free(ptr);
+}
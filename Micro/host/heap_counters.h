@@ -0,0 +1,32 @@
+/* Heap allocation counters for the host benchmarks
+ *
+ * Linking heap_counters.cpp replaces the porting layer's ei_malloc, ei_calloc
+ * and ei_free (weak in porting/posix) and the global operator new / delete
+ * with versions that count every allocation and free, so a benchmark can
+ * check that a call does not touch the heap. Shared by bench_allocations
+ * and bench_dsp_memory.
+ */
+
+#ifndef SEISMIC_HEAP_COUNTERS_H
+#define SEISMIC_HEAP_COUNTERS_H
+
+#include <stddef.h>
+
+typedef struct {
+    size_t allocations;
+    size_t frees;
+    size_t bytes;
+} heap_counters_t;
+
+/**
+ * Allocations and frees since the last heap_counters_reset().
+ */
+extern heap_counters_t heap_counters;
+
+static inline void heap_counters_reset(void) {
+    heap_counters.allocations = 0;
+    heap_counters.frees = 0;
+    heap_counters.bytes = 0;
+}
+
+#endif // SEISMIC_HEAP_COUNTERS_H
@@ -0,0 +1,217 @@
+# Host build of the seismic pipeline (included from the top-level CMakeLists.txt)
+#
+# source/main.cpp is compiled unmodified against the pico-sdk stand-ins in
+# host/include, the Edge Impulse SDK runs on porting/posix with the reference
+# (non-CMSIS) kernels. The stage profiler is compiled in (inactive unless
+# SEISMIC_PROFILE or a benchmark turns it on).
+
+set(CMAKE_C_STANDARD 11)
+set(CMAKE_CXX_STANDARD 11)
+
+if (NOT CMAKE_BUILD_TYPE)
+    set(CMAKE_BUILD_TYPE Release)
+endif()
+
+include(${PROJECT_FOLDER}/edge-impulse-sdk/cmake/utils.cmake)
+
+# Core 1 runs on a pthread (host/host_multicore.cpp)
+find_package(Threads REQUIRED)
+
+add_definitions(-DEIDSP_QUANTIZE_FILTERBANK=0
+                -DEIDSP_USE_CMSIS_DSP=0
+                -DEI_CLASSIFIER_TFLITE_ENABLE_CMSIS_NN=0
+                -DEI_PORTING_POSIX=1
+                -DEI_PROFILER_ENABLED=1
+                )
+
+RECURSIVE_FIND_FILE(HOST_SDK_CPP_FILES "${PROJECT_FOLDER}/edge-impulse-sdk" "*.cpp")
+RECURSIVE_FIND_FILE(HOST_SDK_CC_FILES "${PROJECT_FOLDER}/edge-impulse-sdk/tensorflow" "*.cc")
+RECURSIVE_FIND_FILE(HOST_SDK_C_FILES "${PROJECT_FOLDER}/edge-impulse-sdk/tensorflow" "*.c")
+RECURSIVE_FIND_FILE(HOST_MODEL_FILES "${PROJECT_FOLDER}/tflite-model" "*.cpp")
+
+# SDK, model and porting layer, shared by every host executable
+add_library(seismic_sdk STATIC
+    ${HOST_SDK_CPP_FILES}
+    ${HOST_SDK_CC_FILES}
+    ${HOST_SDK_C_FILES}
+    ${HOST_MODEL_FILES}
+    )
+
+target_include_directories(seismic_sdk PUBLIC
+    ${PROJECT_FOLDER}/tflite-model
+    ${PROJECT_FOLDER}/model-parameters
+    ${PROJECT_FOLDER}
+    )
+
+target_link_libraries(seismic_sdk PUBLIC m)
+
+add_executable(app_host
+    source/main.cpp
+    source/acquisition.cpp
+    source/alert.cpp
+    source/detection.cpp
+    source/sample_ring.cpp
+    source/telemetry.cpp
+    source/trigger.cpp
+    host/host_hal.cpp
+    host/host_acquisition.cpp
+    host/host_alert.cpp
+    host/host_multicore.cpp
+    host/host_telemetry.cpp
+    )
+
+target_include_directories(app_host PRIVATE
+    ${PROJECT_FOLDER}/host/include
+    ${PROJECT_FOLDER}/source
+    )
+
+target_link_libraries(app_host seismic_sdk Threads::Threads)
+
+# Percentile kernel benchmark: selection vs. full sort on wavelet band sizes
+add_executable(bench_percentile
+    host/bench_percentile.cpp
+    )
+
+target_link_libraries(bench_percentile seismic_sdk)
+
+# Butterworth filter benchmark: streaming float32 biquads vs. per-call design
+add_executable(bench_filter
+    host/bench_filter.cpp
+    )
+
+target_link_libraries(bench_filter seismic_sdk)
+
+# Fused EON graph benchmark: depthwise-separable kernel vs. node-by-node path
+add_executable(bench_fused
+    host/bench_fused.cpp
+    host/model_windows.cpp
+    )
+
+target_include_directories(bench_fused PRIVATE ${PROJECT_FOLDER}/host)
+target_link_libraries(bench_fused seismic_sdk)
+
+# Stage profiler benchmark: per-stage and per-node timings, ring and binary dump
+add_executable(bench_profiler
+    host/bench_profiler.cpp
+    host/model_windows.cpp
+    )
+
+target_include_directories(bench_profiler PRIVATE ${PROJECT_FOLDER}/host)
+target_link_libraries(bench_profiler seismic_sdk)
+
+# Kernel benchmark suite: latency percentiles per DSP / inference kernel, CSV
+# results and a regression check against a baseline CSV
+add_executable(bench_kernels
+    host/bench_kernels.cpp
+    host/model_windows.cpp
+    )
+
+target_include_directories(bench_kernels PRIVATE ${PROJECT_FOLDER}/host)
+target_link_libraries(bench_kernels seismic_sdk)
+
+# Folded normalization check: scale/offset in the feature writer vs. the scaler pass
+add_executable(bench_normalization
+    host/bench_normalization.cpp
+    host/model_windows.cpp
+    )
+
+target_include_directories(bench_normalization PRIVATE ${PROJECT_FOLDER}/host)
+target_link_libraries(bench_normalization seismic_sdk)
+
+# Heap check: counts the SDK's allocations per run_classifier, none once planned
+add_executable(bench_allocations
+    host/bench_allocations.cpp
+    host/heap_counters.cpp
+    host/model_windows.cpp
+    )
+
+target_include_directories(bench_allocations PRIVATE ${PROJECT_FOLDER}/host)
+target_link_libraries(bench_allocations seismic_sdk)
+
+# Tracked DSP memory check: no heap use per call of the wavelet path, and
+# EIDSP_TRACK_ALLOCATIONS in-use and peak stay flat after the first window
+add_executable(bench_dsp_memory
+    host/bench_dsp_memory.cpp
+    host/heap_counters.cpp
+    host/model_windows.cpp
+    )
+
+target_include_directories(bench_dsp_memory PRIVATE ${PROJECT_FOLDER}/host)
+target_compile_definitions(bench_dsp_memory PRIVATE EIDSP_TRACK_ALLOCATIONS=1 EIDSP_PRINT_ALLOCATIONS=0)
+target_link_libraries(bench_dsp_memory seismic_sdk)
+
+# Continuous inference check: run_classifier_continuous per slice size against
+# the batch path, heap use once the window is full, and latency
+add_executable(bench_continuous
+    host/bench_continuous.cpp
+    host/heap_counters.cpp
+    host/model_windows.cpp
+    )
+
+target_include_directories(bench_continuous PRIVATE ${PROJECT_FOLDER}/host)
+target_link_libraries(bench_continuous seismic_sdk)
+
+# STEAD replay: recorded traces through ring, impulse and detection policy
+add_executable(replay
+    host/replay.cpp
+    host/model_windows.cpp
+    source/detection.cpp
+    source/sample_ring.cpp
+    source/trigger.cpp
+    )
+
+target_include_directories(replay PRIVATE
+    ${PROJECT_FOLDER}/host
+    ${PROJECT_FOLDER}/source
+    )
+
+target_link_libraries(replay seismic_sdk)
+
+# Telemetry decoder: binary frames from the board or SEISMIC_TELEMETRY_FILE
+add_executable(telemetry_decode
+    host/telemetry_decode.cpp
+    source/telemetry.cpp
+    host/host_telemetry.cpp
+    )
+
+target_include_directories(telemetry_decode PRIVATE ${PROJECT_FOLDER}/source)
+
+# Alert engine check: pattern timing, and no lost samples during critical alerts
+add_executable(bench_alert
+    host/bench_alert.cpp
+    source/acquisition.cpp
+    source/alert.cpp
+    host/host_acquisition.cpp
+    host/host_alert.cpp
+    host/host_hal.cpp
+    )
+
+target_include_directories(bench_alert PRIVATE
+    ${PROJECT_FOLDER}/host/include
+    ${PROJECT_FOLDER}/source
+    )
+
+target_link_libraries(bench_alert Threads::Threads)
+
+# Acquisition block kernel benchmark: DMA-block decimation vs. per-sample averaging
+add_executable(bench_acquisition
+    host/bench_acquisition.cpp
+    source/acquisition.cpp
+    host/host_acquisition.cpp
+    host/host_hal.cpp
+    )
+
+target_include_directories(bench_acquisition PRIVATE
+    ${PROJECT_FOLDER}/host/include
+    ${PROJECT_FOLDER}/source
+    )
+
+target_link_libraries(bench_acquisition Threads::Threads)
+
+# STA/LTA trigger check: onset, lead, release, hold and heartbeat timing on synthetic steps
+add_executable(bench_trigger
+    host/bench_trigger.cpp
+    source/trigger.cpp
+    )
+
+target_include_directories(bench_trigger PRIVATE ${PROJECT_FOLDER}/source)
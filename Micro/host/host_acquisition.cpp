@@ -0,0 +1,57 @@
+/* Host acquisition backend - fake ADC + DMA
+ *
+ * Stands in for acquisition_rp2350.cpp. There are no interrupts on the host,
+ * so the blocks are filled in acq_backend_service(), called at the start of
+ * every acquisition_poll(): all conversions due by the current virtual time
+ * are sampled from the host ADC source (see host_hal.cpp) at their exact
+ * conversion times and written into the blocks in DMA order. A main loop
+ * that stalls longer than a block therefore overruns exactly as it would on
+ * the board.
+ */
+
+#include "pico/stdlib.h"
+#include "acquisition.h"
+#include "host_hal.h"
+
+static uint16_t *fake_blocks[ACQ_BLOCK_COUNT];
+static size_t fake_block_len = 0;
+static uint32_t fake_rate_hz = 0;
+static uint64_t fake_start_us = 0;
+static uint64_t fake_conversions = 0;
+static unsigned int fake_block = 0;
+static size_t fake_fill = 0;
+
+
+/* ========================================================================= */
+/* BACKEND                                                                   */
+/* ========================================================================= */
+
+bool acq_backend_start(uint32_t conversion_rate_hz, uint16_t *blocks[ACQ_BLOCK_COUNT], size_t block_len) {
+    for (unsigned int i = 0; i < ACQ_BLOCK_COUNT; i++) {
+        fake_blocks[i] = blocks[i];
+    }
+    fake_block_len = block_len;
+    fake_rate_hz = conversion_rate_hz;
+    fake_start_us = time_us_64();
+    fake_conversions = 0;
+    fake_block = 0;
+    fake_fill = 0;
+    return true;
+}
+
+void acq_backend_service(void) {
+    uint64_t elapsed_us = time_us_64() - fake_start_us;
+    uint64_t due = elapsed_us * fake_rate_hz / 1000000ULL;
+
+    while (fake_conversions < due) {
+        uint64_t t_us = fake_start_us + fake_conversions * 1000000ULL / fake_rate_hz;
+        fake_blocks[fake_block][fake_fill++] = host_adc_convert(t_us);
+        fake_conversions++;
+
+        if (fake_fill == fake_block_len) {
+            acquisition_block_ready(fake_block);
+            fake_block = (fake_block + 1) % ACQ_BLOCK_COUNT;
+            fake_fill = 0;
+        }
+    }
+}
@@ -0,0 +1,34 @@
+/* Host alert backend - polled tick
+ *
+ * Stands in for alert_rp2350.cpp. There are no timer interrupts on the
+ * host, so alert_poll() runs every tick that fell due since the last call,
+ * at its scheduled virtual time, as the repeating timer would have.
+ */
+
+#include "pico/stdlib.h"
+#include "alert.h"
+
+static uint32_t host_tick_us = 0;
+static uint64_t host_next_tick_us = 0;
+
+
+/* ========================================================================= */
+/* BACKEND                                                                   */
+/* ========================================================================= */
+
+bool alert_backend_start(uint32_t tick_us) {
+    host_tick_us = tick_us;
+    host_next_tick_us = time_us_64();
+    return tick_us > 0;
+}
+
+void alert_backend_service(void) {
+    if (host_tick_us == 0) {
+        return;
+    }
+    uint64_t now_us = time_us_64();
+    while (host_next_tick_us <= now_us) {
+        alert_tick(host_next_tick_us);
+        host_next_tick_us += host_tick_us;
+    }
+}
@@ -0,0 +1,329 @@
+/* Host (Linux/macOS) hardware abstraction for the seismic pipeline
+ *
+ * Implements the pico-sdk calls made by source/main.cpp so the unmodified
+ * acquisition -> inference -> alerting loop can be profiled on a build
+ * machine. Time is virtual and only advances in sleep_ms()/sleep_us(), so a
+ * simulated hour of monitoring completes in seconds of wall time.
+ *
+ * ADC source (environment variables):
+ *   SEISMIC_ADC_FILE         Text file with whitespace separated 12-bit ADC
+ *                            codes (0 - 4095), one per trace sample.
+ *   SEISMIC_ADC_RATE_HZ      Sample rate of the trace (default 100 Hz). The
+ *                            trace is held between samples, so any number of
+ *                            adc_read() calls per period return the same code.
+ *   SEISMIC_HOST_DURATION_S  Simulated run time when no file is given
+ *                            (default 600 s of mid-scale noise).
+ *
+ * The process exits once the trace is exhausted and prints a short summary
+ * (simulated vs. wall time) to stderr.
+ *
+ * Dual core (see host_multicore.cpp): once core 1 is launched it keeps the
+ * clock. Core 1 advances virtual time only while core 0 is blocked in a
+ * sleep or a FIFO wait, and stops at core 0's wake-up time, so work on
+ * either core takes zero virtual time and runs are deterministic, as with
+ * a single core.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "hardware/gpio.h"
+#include "host_hal.h"
+
+#define HOST_GPIO_COUNT         48
+#define HOST_ADC_MIDSCALE       2048
+#define HOST_DEFAULT_RATE_HZ    100
+#define HOST_DEFAULT_DURATION_S 600
+
+static uint64_t virtual_time_us = 0;
+
+// Dual-core clock, see host_core0_wait() and core1_advance()
+static pthread_mutex_t clock_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t clock_cond = PTHREAD_COND_INITIALIZER;
+static bool dual_core = false;
+static thread_local bool on_core1 = false;
+static bool core0_waiting = false;
+static uint64_t core0_deadline_us = 0;
+static bool core0_wake_pending = false;
+static bool gpio_state[HOST_GPIO_COUNT] = {0};
+
+static uint16_t *adc_trace = NULL;
+static size_t adc_trace_length = 0;
+static uint32_t adc_rate_hz = HOST_DEFAULT_RATE_HZ;
+static uint64_t adc_end_us = 0;
+static uint64_t adc_read_count = 0;
+static uint32_t noise_state = 0x12345678u;
+
+static double wall_start_s = 0.0;
+
+
+/* ========================================================================= */
+/* HELPERS                                                                   */
+/* ========================================================================= */
+
+static uint64_t clock_now(void) {
+    return __atomic_load_n(&virtual_time_us, __ATOMIC_ACQUIRE);
+}
+
+static void clock_set(uint64_t t_us) {
+    __atomic_store_n(&virtual_time_us, t_us, __ATOMIC_RELEASE);
+}
+
+static uint32_t env_u32(const char *name, uint32_t fallback) {
+    const char *value = getenv(name);
+    if (!value || !*value) {
+        return fallback;
+    }
+    return (uint32_t)strtoul(value, NULL, 10);
+}
+
+static bool load_adc_trace(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "[host] Cannot open ADC trace '%s'\n", path);
+        return false;
+    }
+
+    size_t capacity = 4096;
+    adc_trace = (uint16_t *)malloc(capacity * sizeof(uint16_t));
+
+    long code;
+    while (adc_trace && fscanf(f, "%ld", &code) == 1) {
+        if (adc_trace_length == capacity) {
+            capacity *= 2;
+            adc_trace = (uint16_t *)realloc(adc_trace, capacity * sizeof(uint16_t));
+            if (!adc_trace) {
+                break;
+            }
+        }
+        if (code < 0) code = 0;
+        if (code > 4095) code = 4095;
+        adc_trace[adc_trace_length++] = (uint16_t)code;
+    }
+    fclose(f);
+
+    if (!adc_trace || adc_trace_length == 0) {
+        fprintf(stderr, "[host] ADC trace '%s' holds no samples\n", path);
+        return false;
+    }
+    return true;
+}
+
+void host_finish_run(void) {
+    double wall_s = host_wall_time_s() - wall_start_s;
+    double sim_s = (double)clock_now() / 1e6;
+
+    fflush(stdout);
+    fprintf(stderr, "\n[host] ADC source exhausted\n");
+    fprintf(stderr, "[host] Simulated: %.1f s | Wall: %.3f s | Speed-up: %.0fx\n",
+            sim_s, wall_s, wall_s > 0.0 ? sim_s / wall_s : 0.0);
+    fprintf(stderr, "[host] ADC conversions: %llu\n",
+            (unsigned long long)adc_read_count);
+
+    exit(0);
+}
+
+uint16_t host_adc_convert(uint64_t t_us) {
+    if (t_us >= adc_end_us) {
+        host_finish_run();
+    }
+
+    adc_read_count++;
+
+    if (adc_trace) {
+        size_t index = (size_t)(t_us * adc_rate_hz / 1000000ULL);
+        return adc_trace[index];
+    }
+
+    // xorshift32, +/- 8 codes around mid-scale
+    noise_state ^= noise_state << 13;
+    noise_state ^= noise_state >> 17;
+    noise_state ^= noise_state << 5;
+    return (uint16_t)(HOST_ADC_MIDSCALE - 8 + (noise_state & 0x0F));
+}
+
+
+/* ========================================================================= */
+/* DUAL-CORE CLOCK                                                           */
+/* ========================================================================= */
+
+// Called with clock_mutex held: park core 0 until core 1 releases it, either
+// at deadline_us or through host_core0_wake()
+static void core0_block(uint64_t deadline_us) {
+    core0_deadline_us = deadline_us;
+    core0_waiting = true;
+    pthread_cond_broadcast(&clock_cond);
+    while (core0_waiting) {
+        pthread_cond_wait(&clock_cond, &clock_mutex);
+    }
+}
+
+// Core 1 moves the clock to target_us, but only while core 0 is parked and
+// never past the time core 0 asked to be woken at
+static void core1_advance(uint64_t target_us) {
+    pthread_mutex_lock(&clock_mutex);
+    while (clock_now() < target_us) {
+        while (!core0_waiting) {
+            pthread_cond_wait(&clock_cond, &clock_mutex);
+        }
+
+        uint64_t step_us = target_us < core0_deadline_us ? target_us : core0_deadline_us;
+        if (step_us > clock_now()) {
+            clock_set(step_us);
+        }
+        if (clock_now() >= core0_deadline_us) {
+            core0_waiting = false;
+            pthread_cond_broadcast(&clock_cond);
+        }
+    }
+    pthread_mutex_unlock(&clock_mutex);
+}
+
+void host_core1_enter(void) {
+    on_core1 = true;
+}
+
+void host_dual_core_begin(void) {
+    pthread_mutex_lock(&clock_mutex);
+    dual_core = true;
+    pthread_mutex_unlock(&clock_mutex);
+}
+
+bool host_on_core1(void) {
+    return on_core1;
+}
+
+void host_core0_wait(void) {
+    pthread_mutex_lock(&clock_mutex);
+    if (!core0_wake_pending) {
+        core0_block(UINT64_MAX);
+    }
+    core0_wake_pending = false;
+    pthread_mutex_unlock(&clock_mutex);
+}
+
+void host_core0_wake(void) {
+    pthread_mutex_lock(&clock_mutex);
+    core0_wake_pending = true;
+    if (core0_waiting && core0_deadline_us == UINT64_MAX) {
+        core0_waiting = false;
+        pthread_cond_broadcast(&clock_cond);
+    }
+    pthread_mutex_unlock(&clock_mutex);
+}
+
+
+/* ========================================================================= */
+/* pico/stdlib.h                                                             */
+/* ========================================================================= */
+
+bool stdio_init_all(void) {
+    wall_start_s = host_wall_time_s();
+
+    adc_rate_hz = env_u32("SEISMIC_ADC_RATE_HZ", HOST_DEFAULT_RATE_HZ);
+    if (adc_rate_hz == 0) {
+        adc_rate_hz = HOST_DEFAULT_RATE_HZ;
+    }
+
+    const char *path = getenv("SEISMIC_ADC_FILE");
+    if (path && *path) {
+        if (!load_adc_trace(path)) {
+            exit(1);
+        }
+        adc_end_us = (uint64_t)adc_trace_length * 1000000ULL / adc_rate_hz;
+        fprintf(stderr, "[host] ADC trace: %s (%zu samples @ %u Hz)\n",
+                path, adc_trace_length, adc_rate_hz);
+    } else {
+        adc_end_us = (uint64_t)env_u32("SEISMIC_HOST_DURATION_S", HOST_DEFAULT_DURATION_S) * 1000000ULL;
+        fprintf(stderr, "[host] No SEISMIC_ADC_FILE, using mid-scale noise for %llu s\n",
+                (unsigned long long)(adc_end_us / 1000000ULL));
+    }
+
+    // Boot-time sleeps are part of the simulated timeline; start the clock at
+    // zero so the trace lines up with the first acquisition
+    clock_set(0);
+    return true;
+}
+
+void sleep_ms(uint32_t ms) {
+    sleep_us((uint64_t)ms * 1000ULL);
+}
+
+void sleep_us(uint64_t us) {
+    uint64_t deadline_us = clock_now() + us;
+
+    if (!dual_core) {
+        clock_set(deadline_us);
+    } else if (on_core1) {
+        core1_advance(deadline_us);
+    } else {
+        // A FIFO wake-up does not end a sleep early
+        pthread_mutex_lock(&clock_mutex);
+        while (clock_now() < deadline_us) {
+            core0_block(deadline_us);
+        }
+        pthread_mutex_unlock(&clock_mutex);
+    }
+}
+
+uint64_t time_us_64(void) {
+    return clock_now();
+}
+
+absolute_time_t get_absolute_time(void) {
+    return clock_now();
+}
+
+
+/* ========================================================================= */
+/* hardware/gpio.h                                                           */
+/* ========================================================================= */
+
+void gpio_init(unsigned int gpio) {
+    if (gpio < HOST_GPIO_COUNT) {
+        gpio_state[gpio] = false;
+    }
+}
+
+void gpio_set_dir(unsigned int gpio, bool out) {
+    (void)gpio;
+    (void)out;
+}
+
+void gpio_put(unsigned int gpio, bool value) {
+    if (gpio < HOST_GPIO_COUNT) {
+        gpio_state[gpio] = value;
+    }
+}
+
+bool gpio_get(unsigned int gpio) {
+    return gpio < HOST_GPIO_COUNT ? gpio_state[gpio] : false;
+}
+
+void gpio_pull_up(unsigned int gpio) {
+    gpio_put(gpio, true);
+}
+
+
+/* ========================================================================= */
+/* hardware/adc.h                                                            */
+/* ========================================================================= */
+
+void adc_init(void) {
+}
+
+void adc_gpio_init(unsigned int gpio) {
+    (void)gpio;
+}
+
+void adc_select_input(unsigned int input) {
+    (void)input;
+}
+
+uint16_t adc_read(void) {
+    return host_adc_convert(clock_now());
+}
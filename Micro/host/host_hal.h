@@ -0,0 +1,60 @@
+/* Host HAL internals shared by the host-only sources
+ *
+ * Not part of the pico-sdk stand-ins: lets the fake acquisition backend
+ * sample the same ADC source as adc_read() at arbitrary conversion times,
+ * and the multicore stand-in cooperate with the virtual clock. Also the
+ * wall clock the host tools and benchmarks time themselves with.
+ */
+
+#ifndef SEISMIC_HOST_HAL_H
+#define SEISMIC_HOST_HAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Monotonic wall-clock time in seconds (not the virtual clock).
+ */
+static inline double host_wall_time_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * ADC code at virtual time t_us (trace sample or noise). Ends the run with
+ * host_finish_run() once t_us is past the end of the source.
+ */
+uint16_t host_adc_convert(uint64_t t_us);
+
+/**
+ * Print the run summary to stderr and exit(0).
+ */
+void host_finish_run(void);
+
+/**
+ * Dual-core emulation (host_multicore.cpp). host_dual_core_begin() is called
+ * on core 0 before core 1 starts, host_core1_enter() first thing on the core 1
+ * thread.
+ */
+void host_dual_core_begin(void);
+void host_core1_enter(void);
+bool host_on_core1(void);
+
+/**
+ * Park core 0 (without a deadline) until host_core0_wake(); core 1 keeps
+ * advancing the clock meanwhile. A wake that arrives first is not lost.
+ */
+void host_core0_wait(void);
+void host_core0_wake(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SEISMIC_HOST_HAL_H
@@ -0,0 +1,132 @@
+/* Host (Linux/macOS) emulation of the RP2350's second core
+ *
+ * multicore_launch_core1() runs the entry function on a pthread. Each
+ * direction of the inter-core FIFO is a small mutex protected queue of the
+ * same depth as the SIO FIFO, read by the other core only.
+ *
+ * Both cores share the virtual clock kept in host_hal.cpp: while core 1
+ * runs, only it advances time, and only while core 0 is parked in
+ * sleep_ms() or multicore_fifo_pop_blocking(). Work on either core
+ * therefore takes zero virtual time. A core 1 that blocks on a full FIFO
+ * while core 0 sleeps would stall the clock; poll multicore_fifo_wready()
+ * first, as the firmware does.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "host_hal.h"
+
+#define HOST_FIFO_DEPTH 4
+
+typedef struct {
+    uint32_t data[HOST_FIFO_DEPTH];
+    unsigned int read;
+    unsigned int count;
+} host_fifo_t;
+
+static pthread_mutex_t fifo_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t fifo_cond = PTHREAD_COND_INITIALIZER;
+static host_fifo_t fifo_to_core0;
+static host_fifo_t fifo_to_core1;
+
+static pthread_t core1_thread;
+static void (*core1_entry)(void) = NULL;
+
+
+/* ========================================================================= */
+/* HELPERS                                                                   */
+/* ========================================================================= */
+
+// The FIFO the calling core reads from, and the one it writes to
+static host_fifo_t *rx_fifo(void) {
+    return host_on_core1() ? &fifo_to_core1 : &fifo_to_core0;
+}
+
+static host_fifo_t *tx_fifo(void) {
+    return host_on_core1() ? &fifo_to_core0 : &fifo_to_core1;
+}
+
+static void *core1_main(void *arg) {
+    (void)arg;
+    host_core1_enter();
+    core1_entry();
+    return NULL;
+}
+
+
+/* ========================================================================= */
+/* pico/multicore.h                                                          */
+/* ========================================================================= */
+
+void multicore_launch_core1(void (*entry)(void)) {
+    core1_entry = entry;
+    host_dual_core_begin();
+
+    if (pthread_create(&core1_thread, NULL, core1_main, NULL) != 0) {
+        fprintf(stderr, "[host] Cannot start core 1 thread\n");
+        exit(1);
+    }
+}
+
+bool multicore_fifo_rvalid(void) {
+    pthread_mutex_lock(&fifo_mutex);
+    bool valid = rx_fifo()->count > 0;
+    pthread_mutex_unlock(&fifo_mutex);
+    return valid;
+}
+
+bool multicore_fifo_wready(void) {
+    pthread_mutex_lock(&fifo_mutex);
+    bool ready = tx_fifo()->count < HOST_FIFO_DEPTH;
+    pthread_mutex_unlock(&fifo_mutex);
+    return ready;
+}
+
+void multicore_fifo_push_blocking(uint32_t data) {
+    pthread_mutex_lock(&fifo_mutex);
+    host_fifo_t *fifo = tx_fifo();
+    while (fifo->count == HOST_FIFO_DEPTH) {
+        pthread_cond_wait(&fifo_cond, &fifo_mutex);
+    }
+    fifo->data[(fifo->read + fifo->count) % HOST_FIFO_DEPTH] = data;
+    fifo->count++;
+    pthread_cond_broadcast(&fifo_cond);
+    pthread_mutex_unlock(&fifo_mutex);
+
+    if (host_on_core1()) {
+        host_core0_wake();
+    }
+}
+
+uint32_t multicore_fifo_pop_blocking(void) {
+    pthread_mutex_lock(&fifo_mutex);
+    host_fifo_t *fifo = rx_fifo();
+    while (fifo->count == 0) {
+        if (host_on_core1()) {
+            pthread_cond_wait(&fifo_cond, &fifo_mutex);
+        } else {
+            // Let core 1 keep the clock running while core 0 waits
+            pthread_mutex_unlock(&fifo_mutex);
+            host_core0_wait();
+            pthread_mutex_lock(&fifo_mutex);
+        }
+    }
+    uint32_t data = fifo->data[fifo->read];
+    fifo->read = (fifo->read + 1) % HOST_FIFO_DEPTH;
+    fifo->count--;
+    pthread_cond_broadcast(&fifo_cond);
+    pthread_mutex_unlock(&fifo_mutex);
+    return data;
+}
+
+void multicore_fifo_drain(void) {
+    pthread_mutex_lock(&fifo_mutex);
+    host_fifo_t *fifo = rx_fifo();
+    fifo->read = 0;
+    fifo->count = 0;
+    pthread_cond_broadcast(&fifo_cond);
+    pthread_mutex_unlock(&fifo_mutex);
+}
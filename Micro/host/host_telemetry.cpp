@@ -0,0 +1,39 @@
+/* Host telemetry backend - capture file
+ *
+ * Stands in for telemetry_rp2350.cpp. Frames are appended to the file named
+ * by SEISMIC_TELEMETRY_FILE (opened on the first write, truncated) and can
+ * be read back with telemetry_decode. Without it they are discarded. The
+ * file always takes every byte, so the TX ring never backs up on the host.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "telemetry.h"
+
+static FILE *capture = NULL;
+static bool capture_opened = false;
+
+
+/* ========================================================================= */
+/* BACKEND                                                                   */
+/* ========================================================================= */
+
+size_t telemetry_backend_write(const uint8_t *data, size_t len) {
+    if (!capture_opened) {
+        capture_opened = true;
+        const char *path = getenv("SEISMIC_TELEMETRY_FILE");
+        if (path && *path) {
+            capture = fopen(path, "wb");
+            if (!capture) {
+                fprintf(stderr, "[host] Cannot write telemetry to %s\n", path);
+            } else {
+                fprintf(stderr, "[host] Telemetry: %s\n", path);
+            }
+        }
+    }
+
+    if (capture) {
+        fwrite(data, 1, len, capture);
+    }
+    return len;
+}
@@ -0,0 +1,25 @@
+/* Host stand-in for hardware/adc.h
+ *
+ * adc_read() samples a recorded trace at the current virtual time, see
+ * host/host_hal.cpp for the file format and environment variables.
+ */
+
+#ifndef SEISMIC_HOST_HARDWARE_ADC_H
+#define SEISMIC_HOST_HARDWARE_ADC_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void adc_init(void);
+void adc_gpio_init(unsigned int gpio);
+void adc_select_input(unsigned int input);
+uint16_t adc_read(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SEISMIC_HOST_HARDWARE_ADC_H
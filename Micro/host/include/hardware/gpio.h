@@ -0,0 +1,30 @@
+/* Host stand-in for hardware/gpio.h
+ *
+ * Pins are plain state cells; outputs are latched and inputs read back the
+ * last written value (or 1 once a pull-up is enabled).
+ */
+
+#ifndef SEISMIC_HOST_HARDWARE_GPIO_H
+#define SEISMIC_HOST_HARDWARE_GPIO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define GPIO_OUT    1
+#define GPIO_IN     0
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void gpio_init(unsigned int gpio);
+void gpio_set_dir(unsigned int gpio, bool out);
+void gpio_put(unsigned int gpio, bool value);
+bool gpio_get(unsigned int gpio);
+void gpio_pull_up(unsigned int gpio);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SEISMIC_HOST_HARDWARE_GPIO_H
@@ -0,0 +1,29 @@
+/* Host stand-in for the subset of pico/multicore.h used by source/main.cpp
+ *
+ * Core 1 is a pthread and the inter-core FIFOs are mutex protected queues;
+ * see host/host_multicore.cpp for how both cores share the virtual clock.
+ */
+
+#ifndef SEISMIC_HOST_PICO_MULTICORE_H
+#define SEISMIC_HOST_PICO_MULTICORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void multicore_launch_core1(void (*entry)(void));
+
+bool multicore_fifo_rvalid(void);
+bool multicore_fifo_wready(void);
+void multicore_fifo_push_blocking(uint32_t data);
+uint32_t multicore_fifo_pop_blocking(void);
+void multicore_fifo_drain(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SEISMIC_HOST_PICO_MULTICORE_H
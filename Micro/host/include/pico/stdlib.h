@@ -0,0 +1,43 @@
+/* Host stand-in for the subset of pico/stdlib.h used by source/main.cpp
+ *
+ * Time is virtual: sleep_ms()/sleep_us() advance the clock instead of
+ * blocking, so the main loop runs as fast as the host CPU allows while the
+ * acquisition and inference scheduling behave exactly as on the board.
+ */
+
+#ifndef SEISMIC_HOST_PICO_STDLIB_H
+#define SEISMIC_HOST_PICO_STDLIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "hardware/gpio.h"
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+bool stdio_init_all(void);
+
+void sleep_ms(uint32_t ms);
+void sleep_us(uint64_t us);
+
+uint64_t time_us_64(void);
+absolute_time_t get_absolute_time(void);
+
+static inline uint32_t to_ms_since_boot(absolute_time_t t) {
+    return (uint32_t)(t / 1000);
+}
+
+static inline uint64_t to_us_since_boot(absolute_time_t t) {
+    return t;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SEISMIC_HOST_PICO_STDLIB_H
@@ -0,0 +1,274 @@
+/* Model input windows for the host tools, see model_windows.h */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "edge-impulse-sdk/classifier/ei_aligned_malloc.h"
+#include "tflite-model/tflite_learn_815551_95_compiled.h"
+#include "model_windows.h"
+
+// Conversion of main.cpp (adc_to_voltage, voltage_to_velocity_ms) and its
+// model input scale
+#define TRACE_ADC_VREF          3.3f
+#define TRACE_SENSITIVITY_V_MS  28.8f
+#ifdef SEISMIC_COUNTS_PER_M_S
+#define TRACE_COUNTS_PER_M_S    ((float)(SEISMIC_COUNTS_PER_M_S))
+#else
+#define TRACE_COUNTS_PER_M_S    1e8f
+#endif
+
+static_assert(MODEL_WINDOW_SAMPLES == EI_CLASSIFIER_RAW_SAMPLE_COUNT, "window must match the impulse");
+static_assert(MODEL_WINDOW_FEATURES == EI_CLASSIFIER_NN_INPUT_FRAME_SIZE, "features must match the impulse");
+static_assert(MODEL_WINDOW_LABELS == EI_CLASSIFIER_LABEL_COUNT, "labels must match the impulse");
+static_assert(MODEL_WINDOW_RATE_HZ == EI_CLASSIFIER_FREQUENCY, "rate must match the impulse");
+
+
+/* ========================================================================= */
+/* SYNTHETIC WINDOWS                                                         */
+/* ========================================================================= */
+
+static float next_uniform(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return (float)(x & 0xFFFFFF) / (float)0x1000000;
+}
+
+// Approximately normal, zero mean, unit variance
+static float next_normal(uint32_t *state) {
+    float sum = 0.0f;
+    for (int i = 0; i < 4; i++) {
+        sum += next_uniform(state);
+    }
+    return (sum - 2.0f) * 1.7320508f;
+}
+
+bool model_windows_synthetic(uint32_t *state, float *window) {
+    return model_windows_synthetic_scaled(state, MODEL_WINDOW_MIXED, window);
+}
+
+bool model_windows_synthetic_scaled(uint32_t *state, model_window_scale_t scale, float *window) {
+    const float fs = (float)EI_CLASSIFIER_FREQUENCY;
+
+    // STEAD counts (10 - 1e5) or geophone velocity (1e-7 - 1e-3 m/s)
+    bool pick_counts = next_uniform(state) < 0.5f;
+    bool counts = scale == MODEL_WINDOW_MIXED ? pick_counts : scale == MODEL_WINDOW_COUNTS;
+    float amplitude = counts ? powf(10.0f, 1.0f + 4.0f * next_uniform(state))
+                             : powf(10.0f, -7.0f + 4.0f * next_uniform(state));
+    float offset = amplitude * (4.0f * next_uniform(state) - 2.0f);
+    float smoothing = 0.9f * next_uniform(state);
+
+    float noise = 0.0f;
+    for (size_t i = 0; i < MODEL_WINDOW_SAMPLES; i++) {
+        noise = smoothing * noise + next_normal(state);
+        window[i] = offset + amplitude * noise;
+    }
+
+    bool event = next_uniform(state) < 0.5f;
+    if (!event) {
+        return false;
+    }
+
+    // Onset in the first 80 % of the window, 0.5 s rise, 1 - 5 s decay
+    size_t onset = 100 + (size_t)(700.0f * next_uniform(state));
+    float peak = amplitude * powf(10.0f, 0.5f + 1.5f * next_uniform(state));
+    float decay_s = 1.0f + 4.0f * next_uniform(state);
+    float freq[3], phase[3];
+    for (int k = 0; k < 3; k++) {
+        freq[k] = 1.0f + 9.0f * next_uniform(state);
+        phase[k] = 2.0f * (float)M_PI * next_uniform(state);
+    }
+
+    for (size_t i = onset; i < MODEL_WINDOW_SAMPLES; i++) {
+        float t = (float)(i - onset) / fs;
+        float envelope = (t < 0.5f ? t / 0.5f : 1.0f) * expf(-t / decay_s);
+        float carrier = 0.0f;
+        for (int k = 0; k < 3; k++) {
+            carrier += sinf(2.0f * (float)M_PI * freq[k] * t + phase[k]);
+        }
+        window[i] += peak * envelope * carrier / 3.0f;
+    }
+    return true;
+}
+
+
+/* ========================================================================= */
+/* RECORDED TRACES                                                           */
+/* ========================================================================= */
+
+size_t model_windows_load_trace(const char *path, float **samples) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return 0;
+    }
+
+    size_t count = 0;
+    size_t capacity = 4096;
+    float *data = (float*)malloc(capacity * sizeof(float));
+    long code;
+    while (data && fscanf(file, "%ld", &code) == 1) {
+        if (count == capacity) {
+            capacity *= 2;
+            float *grown = (float*)realloc(data, capacity * sizeof(float));
+            if (!grown) {
+                free(data);
+                data = NULL;
+                break;
+            }
+            data = grown;
+        }
+        float voltage = (float)code * TRACE_ADC_VREF / 4095.0f;
+        data[count++] = (voltage - TRACE_ADC_VREF / 2.0f) / TRACE_SENSITIVITY_V_MS * TRACE_COUNTS_PER_M_S;
+    }
+    fclose(file);
+
+    if (!data) {
+        fprintf(stderr, "Out of memory reading %s\n", path);
+        return 0;
+    }
+    *samples = data;
+    return count;
+}
+
+
+/* ========================================================================= */
+/* FEATURES                                                                  */
+/* ========================================================================= */
+
+bool model_windows_init(void) {
+    return init_impulse(&ei_default_impulse) == EI_IMPULSE_OK &&
+           init_data_normalization(&ei_default_impulse) == EI_IMPULSE_OK;
+}
+
+// The DSP block as deployed: features come out normalized when the data
+// normalization is folded into it, run_data_normalization() skips the block then
+static bool run_dsp_block(const float *window, float *features, void *config) {
+    const ei_impulse_t *impulse = ei_default_impulse.impulse;
+    ei_model_dsp_t block = impulse->dsp_blocks[0];
+
+    signal_t signal;
+    numpy::signal_from_buffer(window, MODEL_WINDOW_SAMPLES, &signal);
+
+    ei::matrix_t matrix(1, block.n_output_features, features);
+    return block.extract_fn(&signal, &matrix, config, impulse->frequency) == EIDSP_OK;
+}
+
+bool model_windows_dsp(const float *window, float *features) {
+    ei_dsp_config_spectral_analysis_t config =
+        *(const ei_dsp_config_spectral_analysis_t*)ei_default_impulse.impulse->dsp_blocks[0].config;
+    config.feature_scale = nullptr;
+    config.feature_offset = nullptr;
+    return run_dsp_block(window, features, &config);
+}
+
+bool model_windows_normalize(float *features) {
+    ei::matrix_t matrix(1, MODEL_WINDOW_FEATURES, features);
+    ei_model_dsp_t block = ei_default_impulse.impulse->dsp_blocks[0];
+    return data_normalization_standard_scaler(&block, &matrix) == EI_IMPULSE_OK;
+}
+
+bool model_windows_features(const float *window, float *features) {
+    if (!run_dsp_block(window, features, ei_default_impulse.impulse->dsp_blocks[0].config)) {
+        return false;
+    }
+
+    ei::matrix_t matrix(1, MODEL_WINDOW_FEATURES, features);
+    ei_feature_t feature;
+    memset(&feature, 0, sizeof(feature));
+    feature.matrix = &matrix;
+    feature.blockId = ei_default_impulse.impulse->dsp_blocks[0].blockId;
+    return run_data_normalization(&ei_default_impulse, &feature) == EI_IMPULSE_OK;
+}
+
+void model_windows_scaler(const float **mean, const float **scale,
+                          const float **folded_scale, const float **folded_offset) {
+    const ei_model_dsp_t *block = &ei_default_impulse.impulse->dsp_blocks[0];
+    const ei_data_normalization_standard_scaler_config_t *scaler =
+        (const ei_data_normalization_standard_scaler_config_t*)block->data_normalization_config->config;
+    const ei_dsp_config_spectral_analysis_t *config = (const ei_dsp_config_spectral_analysis_t*)block->config;
+
+    *mean = scaler->mean_data;
+    *scale = scaler->scale_data;
+    *folded_scale = config->feature_scale;
+    *folded_offset = config->feature_offset;
+}
+
+bool model_windows_classify(const float *window, float *probs) {
+    signal_t signal;
+    numpy::signal_from_buffer(window, MODEL_WINDOW_SAMPLES, &signal);
+
+    ei_impulse_result_t result;
+    if (run_classifier(&signal, &result, false) != EI_IMPULSE_OK) {
+        return false;
+    }
+    for (size_t i = 0; i < EI_CLASSIFIER_LABEL_COUNT; i++) {
+        probs[i] = result.classification[i].value;
+    }
+    return true;
+}
+
+void model_windows_continuous_init(void) {
+    run_classifier_init();
+}
+
+// ei_set_features_observer() callback of model_windows_continuous(), only
+// called once the sliding window is full
+static bool ready_features = false;
+
+static void copy_continuous_features(const float *features, size_t count, void *ctx) {
+    memcpy(ctx, features, std::min(count, (size_t)MODEL_WINDOW_FEATURES) * sizeof(float));
+    ready_features = true;
+}
+
+bool model_windows_continuous(const float *slice, size_t length, float *features, float *probs, bool *ready) {
+    signal_t signal;
+    numpy::signal_from_buffer(slice, length, &signal);
+
+    ei_impulse_result_t result;
+    ready_features = false;
+    ei_set_features_observer(copy_continuous_features, features);
+    EI_IMPULSE_ERROR res = run_classifier_continuous(&signal, &result, false, false);
+    ei_set_features_observer(nullptr, nullptr);
+    if (res != EI_IMPULSE_OK) {
+        return false;
+    }
+
+    *ready = ready_features;
+    for (size_t i = 0; *ready && i < EI_CLASSIFIER_LABEL_COUNT; i++) {
+        probs[i] = result.classification[i].value;
+    }
+    return true;
+}
+
+bool model_windows_float_init(void) {
+    return tflite_learn_815551_95_init(ei_aligned_calloc) == kTfLiteOk;
+}
+
+bool model_windows_float(const float *features, float *probs) {
+    TfLiteTensor input, output;
+    tflite_learn_815551_95_input(0, &input);
+    memcpy(input.data.f, features, MODEL_WINDOW_FEATURES * sizeof(float));
+    if (tflite_learn_815551_95_invoke() != kTfLiteOk) {
+        return false;
+    }
+    tflite_learn_815551_95_output(0, &output);
+    memcpy(probs, output.data.f, MODEL_WINDOW_LABELS * sizeof(float));
+    return true;
+}
+
+int model_windows_top1(const float *probs) {
+    int best = 0;
+    for (int i = 1; i < MODEL_WINDOW_LABELS; i++) {
+        best = probs[i] >= probs[best] ? i : best;
+    }
+    return best;
+}
+
+const char *model_windows_label(size_t index) {
+    return index < EI_CLASSIFIER_LABEL_COUNT ? ei_classifier_inferencing_categories[index] : "";
+}
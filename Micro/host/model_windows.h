@@ -0,0 +1,130 @@
+/* Model input windows for the host tools
+ *
+ * Shared by the host benchmarks and replay: synthetic windows, windows cut
+ * from a recorded ADC trace, the impulse's DSP block plus data
+ * normalization to turn a window into the 56 features the network sees,
+ * the float graph on its own, and the whole impulse. This is the one host
+ * translation unit that includes ei_run_classifier.h (its definitions live
+ * in the header).
+ *
+ * Synthetic windows come in two scales: STEAD counts, which the model was
+ * trained on and main.cpp feeds it (MODEL_COUNTS_PER_M_S), and raw geophone
+ * velocity in m/s. Half of them carry a decaying multi-tone burst (a local
+ * event), the rest are coloured noise with an offset.
+ */
+
+#ifndef SEISMIC_MODEL_WINDOWS_H
+#define SEISMIC_MODEL_WINDOWS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MODEL_WINDOW_SAMPLES  1000      // EI_CLASSIFIER_RAW_SAMPLE_COUNT
+#define MODEL_WINDOW_FEATURES 56        // EI_CLASSIFIER_NN_INPUT_FRAME_SIZE
+#define MODEL_WINDOW_STRIDE   250       // EI_CLASSIFIER_SLICE_SIZE
+#define MODEL_WINDOW_LABELS   2         // EI_CLASSIFIER_LABEL_COUNT
+#define MODEL_WINDOW_RATE_HZ  100       // EI_CLASSIFIER_FREQUENCY
+#define MODEL_WINDOW_EARTHQUAKE 0       // Class index of "earthquake_local"
+
+/**
+ * Initializes the impulse (planned storage, data normalization). Call once
+ * before model_windows_features() or model_windows_classify().
+ */
+bool model_windows_init(void);
+
+typedef enum {
+    MODEL_WINDOW_MIXED = 0,     // Either scale, half of the windows each
+    MODEL_WINDOW_COUNTS,        // STEAD counts, the training data
+    MODEL_WINDOW_VELOCITY       // Geophone m/s, before the model input scale
+} model_window_scale_t;
+
+/**
+ * Fills window with MODEL_WINDOW_SAMPLES synthetic samples. state is the
+ * generator state (any non-zero seed). Returns true if the window holds an
+ * event.
+ */
+bool model_windows_synthetic(uint32_t *state, float *window);
+
+/**
+ * model_windows_synthetic() on one scale only. The generator advances the
+ * same way for every scale.
+ */
+bool model_windows_synthetic_scaled(uint32_t *state, model_window_scale_t scale, float *window);
+
+/**
+ * Reads a text file of 12-bit ADC codes (the SEISMIC_ADC_FILE format) and
+ * converts it to what main.cpp feeds the impulse: velocity in m/s scaled to
+ * STEAD counts. Returns the number of samples (0 on error); *samples is
+ * malloc'ed and owned by the caller.
+ */
+size_t model_windows_load_trace(const char *path, float **samples);
+
+/**
+ * DSP block and data normalization on one window, as the impulse runs them
+ * (normalization folded into the feature writer when
+ * EI_CLASSIFIER_DATA_NORMALIZATION_FOLDED). Returns false if the DSP block
+ * fails.
+ */
+bool model_windows_features(const float *window, float *features);
+
+/**
+ * The reference path in two halves: the DSP block on one window without the
+ * folded normalization (raw features), and the separate standard scaler pass
+ * over them in place.
+ */
+bool model_windows_dsp(const float *window, float *features);
+bool model_windows_normalize(float *features);
+
+/**
+ * The impulse's standard scaler (MODEL_WINDOW_FEATURES means and scales)
+ * and the scale / offset pair folded into its DSP block, both NULL when the
+ * normalization is not folded.
+ */
+void model_windows_scaler(const float **mean, const float **scale,
+                          const float **folded_scale, const float **folded_offset);
+
+/**
+ * Runs the whole impulse (run_classifier) on one window and writes the
+ * class probabilities to probs (MODEL_WINDOW_LABELS values). Returns false
+ * if the impulse fails.
+ */
+bool model_windows_classify(const float *window, float *probs);
+
+/**
+ * Starts a continuous run: run_classifier_init(), which also clears the
+ * sliding window of model_windows_continuous().
+ */
+void model_windows_continuous_init(void);
+
+/**
+ * Feeds one slice of `length` samples (1 to MODEL_WINDOW_SAMPLES) to
+ * run_classifier_continuous. Once the sliding window is full, every slice
+ * sets *ready and writes the window's features (as model_windows_features)
+ * and class probabilities. Returns false if the impulse fails.
+ */
+bool model_windows_continuous(const float *slice, size_t length, float *features, float *probs, bool *ready);
+
+/**
+ * Initializes the EON float graph for model_windows_float(), apart from the
+ * impulse's own instance.
+ */
+bool model_windows_float_init(void);
+
+/**
+ * Runs the float graph alone on MODEL_WINDOW_FEATURES features (no DSP
+ * block) and writes the class probabilities to probs. Returns false if the
+ * graph fails.
+ */
+bool model_windows_float(const float *features, float *probs);
+
+/**
+ * Index of the most likely class of probs.
+ */
+int model_windows_top1(const float *probs);
+
+/**
+ * Name of class index of probs.
+ */
+const char *model_windows_label(size_t index);
+
+#endif // SEISMIC_MODEL_WINDOWS_H
@@ -0,0 +1,462 @@
+/* STEAD replay through the device pipeline (host only)
+ *
+ * Streams the Z channel of recorded STEAD traces through the same stages as
+ * the firmware. Each sample is pushed into a sample ring sized like
+ * main.cpp's, after the optional high-pass filter that core 1 applies
+ * (SEISMIC_HIGHPASS_HZ). Every INFERENCE_STRIDE samples, once a full
+ * window is buffered, the impulse runs on the ring view as in run_inference(),
+ * and its best class is graded with detection_level() as in
+ * process_inference_result().
+ *
+ * Input is the flat binary written by data-prep/export_replay.py from the
+ * .npz archives of dataset-npz.ipynb (format described there). The file is
+ * memory-mapped, so archives of any size stream without being loaded.
+ * Samples enter the ring in STEAD counts, the scale the model was trained
+ * on, so neither the ADC conversion of main.cpp nor its model input scale
+ * (MODEL_COUNTS_PER_M_S) applies to them.
+ *
+ * Every trace starts with an empty ring, like the device after boot. For each
+ * alert level (any, high, critical) the tool reports:
+ *   - events detected: earthquake_local traces with a window at or above
+ *     the level;
+ *   - delay after P: from the P arrival to the end of the first such window;
+ *   - lead before S: from the end of that window to the S arrival;
+ *   - false alarms: noise traces with such a window, and their rate per
+ *     hour of noise.
+ * It also reports throughput (windows/s, samples/s, x real time) and the
+ * inference load (windows per minute of signal).
+ *
+ * Built with SEISMIC_TRIGGER, windows are scheduled by the STA/LTA trigger
+ * as on core 1 (trigger.h) instead of every INFERENCE_STRIDE samples.
+ *
+ * speed 0 replays as fast as possible. speed 1 paces the samples at the
+ * trace's sample rate, and N paces them N times faster. When the impulse
+ * cannot keep up, the largest lag behind the schedule is reported.
+ *
+ * Usage: replay <traces.bin> [speed] [traces] [results.csv|-]
+ *        (default speed 0, all traces; results.csv receives one line per trace)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <vector>
+#include "edge-impulse-sdk/dsp/spectral/filters.hpp"
+#include "detection.h"
+#include "sample_ring.h"
+#include "trigger.h"
+#include "model_windows.h"
+#include "host_hal.h"
+
+// As main.cpp
+#ifdef SEISMIC_INFERENCE_STRIDE
+#define INFERENCE_STRIDE    SEISMIC_INFERENCE_STRIDE
+#else
+#define INFERENCE_STRIDE    MODEL_WINDOW_STRIDE
+#endif
+#define WINDOW_SIZE         MODEL_WINDOW_SAMPLES
+#define RING_SLACK          64
+#define RING_CAPACITY       (WINDOW_SIZE + INFERENCE_STRIDE + RING_SLACK)
+#define HIGHPASS_ORDER      2
+
+#define REPLAY_MAGIC        "SRPL"
+#define REPLAY_VERSION      1
+#define REPLAY_HEADER_BYTES 32
+#define REPLAY_ENTRY_BYTES  64
+#define REPLAY_NAME_BYTES   40
+
+enum {
+    CATEGORY_NOISE = 0,
+    CATEGORY_EARTHQUAKE = 1,
+};
+
+struct replay_trace_t {
+    const float *samples;
+    uint32_t count;
+    int32_t p_arrival;
+    int32_t s_arrival;
+    uint8_t category;
+    char name[REPLAY_NAME_BYTES + 1];
+};
+
+struct trace_result_t {
+    uint32_t windows;
+    uint32_t onsets;                                // SEISMIC_TRIGGER onset windows
+    uint32_t detections;                            // windows above DETECTION_NONE
+    int64_t first_end[DETECTION_LEVEL_COUNT];       // -1: no window at or above the level
+    float max_confidence;                           // best non-noise confidence
+};
+
+struct level_stats_t {
+    size_t detected;
+    size_t false_alarms;
+    std::vector<double> delay_after_p_s;
+    std::vector<double> lead_before_s_s;
+};
+
+static float ring_storage[2 * RING_CAPACITY];       // Mirrored, see sample_ring.h
+static sample_ring_t ring;
+#ifdef SEISMIC_HIGHPASS_HZ
+static ei::spectral::filters::biquad_cascade highpass;
+#endif
+
+
+/* ========================================================================= */
+/* HELPERS                                                                   */
+/* ========================================================================= */
+
+static void sleep_until(double t_s) {
+    double wait_s = t_s - host_wall_time_s();
+    if (wait_s > 0.0) {
+        struct timespec ts;
+        ts.tv_sec = (time_t)wait_s;
+        ts.tv_nsec = (long)((wait_s - (double)ts.tv_sec) * 1e9);
+        nanosleep(&ts, NULL);
+    }
+}
+
+static uint32_t read_u32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t read_u64(const uint8_t *p) {
+    return (uint64_t)read_u32(p) | ((uint64_t)read_u32(p + 4) << 32);
+}
+
+static double median(std::vector<double> values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    size_t mid = values.size() / 2;
+    return values.size() % 2 ? values[mid] : 0.5 * (values[mid - 1] + values[mid]);
+}
+
+static double mean(const std::vector<double> &values) {
+    double sum = 0.0;
+    for (double v : values) {
+        sum += v;
+    }
+    return values.empty() ? 0.0 : sum / values.size();
+}
+
+
+/* ========================================================================= */
+/* TRACE FILE                                                                */
+/* ========================================================================= */
+
+// Maps the file and checks the header and every index entry. The mapping
+// stays for the whole run (the traces point into it), unless a check fails
+static bool open_traces(const char *path, std::vector<replay_trace_t> *traces, uint32_t *rate_hz) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < REPLAY_HEADER_BYTES) {
+        fprintf(stderr, "%s is not a replay file\n", path);
+        close(fd);
+        return false;
+    }
+    size_t size = (size_t)st.st_size;
+    void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "Cannot map %s\n", path);
+        return false;
+    }
+    madvise(map, size, MADV_SEQUENTIAL);
+
+    const uint8_t *file = (const uint8_t*)map;
+    uint32_t count = read_u32(file + 8);
+    if (memcmp(file, REPLAY_MAGIC, 4) != 0 || read_u32(file + 4) != REPLAY_VERSION ||
+            read_u32(file + 16) != REPLAY_ENTRY_BYTES ||
+            (uint64_t)count * REPLAY_ENTRY_BYTES > size - REPLAY_HEADER_BYTES) {
+        fprintf(stderr, "%s is not a version %d replay file\n", path, REPLAY_VERSION);
+        munmap(map, size);
+        return false;
+    }
+    *rate_hz = read_u32(file + 12);
+
+    for (uint32_t i = 0; i < count; i++) {
+        const uint8_t *entry = file + REPLAY_HEADER_BYTES + (size_t)i * REPLAY_ENTRY_BYTES;
+        uint64_t offset = read_u64(entry);
+        replay_trace_t trace;
+        trace.count = read_u32(entry + 8);
+        trace.p_arrival = (int32_t)read_u32(entry + 12);
+        trace.s_arrival = (int32_t)read_u32(entry + 16);
+        trace.category = entry[20];
+        memcpy(trace.name, entry + 24, REPLAY_NAME_BYTES);
+        trace.name[REPLAY_NAME_BYTES] = '\0';
+
+        if (offset % sizeof(float) != 0 || offset > size || trace.count > (size - offset) / sizeof(float)) {
+            fprintf(stderr, "%s: trace %u lies outside the file\n", path, i);
+            traces->clear();  // its entries point into the mapping
+            munmap(map, size);
+            return false;
+        }
+        trace.samples = (const float*)(file + offset);
+        traces->push_back(trace);
+    }
+    return true;
+}
+
+
+/* ========================================================================= */
+/* PIPELINE                                                                  */
+/* ========================================================================= */
+
+// Best class of the window ending at ring position end, graded like
+// process_inference_result()
+static bool classify_window(uint32_t end, detection_level_t *level, float *confidence) {
+    sample_ring_view_t view;
+    float probs[MODEL_WINDOW_LABELS];
+    if (!sample_ring_window_ending(&ring, end, WINDOW_SIZE, &view) ||
+            !model_windows_classify(view.samples, probs)) {
+        return false;
+    }
+
+    size_t best = 0;
+    for (size_t i = 1; i < MODEL_WINDOW_LABELS; i++) {
+        best = probs[i] > probs[best] ? i : best;
+    }
+    *level = detection_level(model_windows_label(best), probs[best]);
+    *confidence = probs[best];
+    return true;
+}
+
+static bool replay_trace(const replay_trace_t *trace, double speed, uint32_t rate_hz,
+                         trace_result_t *result, double *max_lag_s) {
+    memset(result, 0, sizeof(*result));
+    for (int l = 0; l < DETECTION_LEVEL_COUNT; l++) {
+        result->first_end[l] = -1;
+    }
+
+    sample_ring_init(&ring, ring_storage, RING_CAPACITY);
+#ifdef SEISMIC_HIGHPASS_HZ
+    highpass.design_butterworth(true, HIGHPASS_ORDER, (float)rate_hz, SEISMIC_HIGHPASS_HZ);
+#endif
+
+    const double start_s = host_wall_time_s();
+#ifdef SEISMIC_TRIGGER
+    trigger_t trigger;
+    trigger_init(&trigger, (uint32_t)(TRIGGER_STA_S * rate_hz), (uint32_t)(TRIGGER_LTA_S * rate_hz),
+                 TRIGGER_ON_RATIO, TRIGGER_OFF_RATIO, INFERENCE_STRIDE, (uint32_t)(TRIGGER_HEARTBEAT_S * rate_hz),
+                 WINDOW_SIZE, (uint32_t)(TRIGGER_ONSET_LEAD_S * rate_hz));
+#else
+    uint32_t since_window = 0;
+#endif
+    for (uint32_t i = 0; i < trace->count; i++) {
+#ifdef SEISMIC_HIGHPASS_HZ
+        float value = highpass.process(trace->samples[i]);
+#else
+        float value = trace->samples[i];
+#endif
+        sample_ring_push(&ring, value);
+
+#ifdef SEISMIC_TRIGGER
+        trigger_window_t window = trigger_push(&trigger, value, sample_ring_count(&ring) >= WINDOW_SIZE);
+        if (window == TRIGGER_WINDOW_NONE) {
+            continue;
+        }
+        result->onsets += window == TRIGGER_WINDOW_ONSET;
+#else
+        if (++since_window < INFERENCE_STRIDE || sample_ring_count(&ring) < WINDOW_SIZE) {
+            continue;
+        }
+        since_window = 0;
+#endif
+
+        if (speed > 0.0) {
+            double due_s = start_s + (double)(i + 1) / (rate_hz * speed);
+            *max_lag_s = std::max(*max_lag_s, host_wall_time_s() - due_s);
+            sleep_until(due_s);
+        }
+
+        detection_level_t level;
+        float confidence;
+        if (!classify_window(sample_ring_head(&ring), &level, &confidence)) {
+            fprintf(stderr, "%s: inference failed at sample %u\n", trace->name, i);
+            return false;
+        }
+        result->windows++;
+        if (level == DETECTION_NONE) {
+            continue;
+        }
+        result->detections++;
+        result->max_confidence = std::max(result->max_confidence, confidence);
+        for (int l = DETECTION_LOW; l <= (int)level; l++) {
+            if (result->first_end[l] < 0) {
+                result->first_end[l] = (int64_t)i + 1;
+            }
+        }
+    }
+    return true;
+}
+
+
+/* ========================================================================= */
+/* REPORT                                                                    */
+/* ========================================================================= */
+
+static void add_result(const replay_trace_t *trace, const trace_result_t *result, uint32_t rate_hz,
+                       level_stats_t stats[DETECTION_LEVEL_COUNT]) {
+    for (int l = DETECTION_LOW; l < DETECTION_LEVEL_COUNT; l++) {
+        int64_t end = result->first_end[l];
+        if (end < 0) {
+            continue;
+        }
+        if (trace->category == CATEGORY_NOISE) {
+            stats[l].false_alarms++;
+        } else if (trace->category == CATEGORY_EARTHQUAKE) {
+            stats[l].detected++;
+            if (trace->p_arrival >= 0) {
+                stats[l].delay_after_p_s.push_back((double)(end - trace->p_arrival) / rate_hz);
+            }
+            if (trace->s_arrival >= 0) {
+                stats[l].lead_before_s_s.push_back((double)(trace->s_arrival - end) / rate_hz);
+            }
+        }
+    }
+}
+
+static void write_csv_line(FILE *csv, const replay_trace_t *trace, const trace_result_t *result, uint32_t rate_hz) {
+    int64_t end = result->first_end[DETECTION_LOW];
+    int level = DETECTION_NONE;
+    for (int l = DETECTION_LOW; l < DETECTION_LEVEL_COUNT; l++) {
+        level = result->first_end[l] >= 0 ? l : level;
+    }
+    fprintf(csv, "%s,%u,%u,%d,%d,%u,%u,%s,%.4f,%lld", trace->name, (unsigned)trace->category,
+            trace->count, trace->p_arrival, trace->s_arrival, result->windows, result->detections,
+            detection_level_name((detection_level_t)level), result->max_confidence, (long long)end);
+    if (end >= 0 && trace->p_arrival >= 0) {
+        fprintf(csv, ",%.2f", (double)(end - trace->p_arrival) / rate_hz);
+    } else {
+        fprintf(csv, ",");
+    }
+    if (end >= 0 && trace->s_arrival >= 0) {
+        fprintf(csv, ",%.2f\n", (double)(trace->s_arrival - end) / rate_hz);
+    } else {
+        fprintf(csv, ",\n");
+    }
+}
+
+static void print_report(const level_stats_t stats[DETECTION_LEVEL_COUNT], size_t events, size_t noise,
+                         double noise_hours) {
+    printf("Detections (%zu earthquake_local, %zu noise traces)\n", events, noise);
+    printf("    %-9s %16s %22s %22s %18s\n", "level", "events detected",
+           "delay after P (s)", "lead before S (s)", "false alarms");
+    printf("    %-9s %16s %11s %10s %11s %10s %8s %9s\n", "", "", "mean", "median", "mean", "median", "traces", "per hour");
+    for (int l = DETECTION_LOW; l < DETECTION_LEVEL_COUNT; l++) {
+        const level_stats_t *s = &stats[l];
+        char detected[32];
+        snprintf(detected, sizeof(detected), "%zu (%.1f %%)", s->detected,
+                 events > 0 ? 100.0 * s->detected / events : 0.0);
+        printf("    %-9s %16s %11.2f %10.2f %11.2f %10.2f %8zu %9.2f\n",
+               l == DETECTION_LOW ? "any" : detection_level_name((detection_level_t)l), detected,
+               mean(s->delay_after_p_s), median(s->delay_after_p_s),
+               mean(s->lead_before_s_s), median(s->lead_before_s_s),
+               s->false_alarms, noise_hours > 0.0 ? s->false_alarms / noise_hours : 0.0);
+    }
+}
+
+
+/* ========================================================================= */
+/* MAIN                                                                      */
+/* ========================================================================= */
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: replay <traces.bin> [speed] [traces] [results.csv|-]\n");
+        return 1;
+    }
+    double speed = argc > 2 ? atof(argv[2]) : 0.0;
+    long limit = argc > 3 ? strtol(argv[3], NULL, 10) : 0;
+    const char *csv_path = argc > 4 && strcmp(argv[4], "-") != 0 ? argv[4] : NULL;
+
+    std::vector<replay_trace_t> traces;
+    uint32_t rate_hz = 0;
+    if (!open_traces(argv[1], &traces, &rate_hz)) {
+        return 1;
+    }
+    if (rate_hz != MODEL_WINDOW_RATE_HZ) {
+        fprintf(stderr, "%s is sampled at %u Hz, the impulse expects %d Hz\n",
+                argv[1], rate_hz, MODEL_WINDOW_RATE_HZ);
+        return 1;
+    }
+    if (limit > 0 && (size_t)limit < traces.size()) {
+        traces.resize((size_t)limit);
+    }
+    if (!model_windows_init()) {
+        fprintf(stderr, "Failed to initialize the impulse\n");
+        return 1;
+    }
+
+    FILE *csv = NULL;
+    if (csv_path) {
+        csv = fopen(csv_path, "w");
+        if (!csv) {
+            fprintf(stderr, "Cannot write %s\n", csv_path);
+            return 1;
+        }
+        fprintf(csv, "trace,category,samples,p_arrival,s_arrival,windows,detections,"
+                     "max_level,max_confidence,first_detection,delay_after_p_s,lead_before_s_s\n");
+    }
+
+    level_stats_t stats[DETECTION_LEVEL_COUNT] = {};
+    size_t events = 0, noise = 0;
+    uint64_t samples = 0, windows = 0, onsets = 0, noise_samples = 0;
+    double max_lag_s = 0.0;
+    const double start_s = host_wall_time_s();
+
+    for (const replay_trace_t &trace : traces) {
+        trace_result_t result;
+        if (!replay_trace(&trace, speed, rate_hz, &result, &max_lag_s)) {
+            if (csv) {
+                fclose(csv);
+            }
+            return 1;
+        }
+        events += trace.category == CATEGORY_EARTHQUAKE;
+        noise += trace.category == CATEGORY_NOISE;
+        noise_samples += trace.category == CATEGORY_NOISE ? trace.count : 0;
+        samples += trace.count;
+        windows += result.windows;
+        onsets += result.onsets;
+        add_result(&trace, &result, rate_hz, stats);
+        if (csv) {
+            write_csv_line(csv, &trace, &result, rate_hz);
+        }
+    }
+    const double wall_s = host_wall_time_s() - start_s;
+    if (csv) {
+        fclose(csv);
+        printf("Wrote %s\n", csv_path);
+    }
+
+    print_report(stats, events, noise, (double)noise_samples / rate_hz / 3600.0);
+    printf("Throughput (%zu traces, stride %d)\n", traces.size(), INFERENCE_STRIDE);
+    printf("    windows:   %llu, %.0f / s\n", (unsigned long long)windows, wall_s > 0.0 ? windows / wall_s : 0.0);
+    printf("    load:      %.2f windows per minute of signal\n",
+           samples > 0 ? (double)windows * 60.0 * rate_hz / (double)samples : 0.0);
+#ifdef SEISMIC_TRIGGER
+    printf("    trigger:   %llu onsets (STA %.1f s, LTA %.1f s, on %.1f, off %.1f, lead %.1f s, heartbeat %.0f s)\n",
+           (unsigned long long)onsets, (double)TRIGGER_STA_S, (double)TRIGGER_LTA_S,
+           (double)TRIGGER_ON_RATIO, (double)TRIGGER_OFF_RATIO, (double)TRIGGER_ONSET_LEAD_S,
+           (double)TRIGGER_HEARTBEAT_S);
+#endif
+    printf("    samples:   %llu, %.0f / s\n", (unsigned long long)samples, wall_s > 0.0 ? samples / wall_s : 0.0);
+    printf("    real time: %.1f s replayed in %.2f s (%.0fx)\n", (double)samples / rate_hz, wall_s,
+           wall_s > 0.0 ? (double)samples / rate_hz / wall_s : 0.0);
+    if (speed > 0.0) {
+        printf("    max lag behind %.0fx schedule: %.3f s\n", speed, max_lag_s);
+    }
+    return 0;
+}
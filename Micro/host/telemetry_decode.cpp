@@ -0,0 +1,417 @@
+/* Telemetry decoder (host only)
+ *
+ * Reads a capture of the binary telemetry stream (source/telemetry.h), from
+ * a file or stdin, e.g. the USB CDC port of the board or the
+ * SEISMIC_TELEMETRY_FILE written by app_host. The stream is scanned for the
+ * sync bytes, so text printed on the same port (SEISMIC_TEXT_OUTPUT) and
+ * bytes lost on the link only cost the frames they hit: a frame whose CRC
+ * does not match is counted and the scan resumes one byte after its sync.
+ *
+ * Modes:
+ *   text    one line per frame (default)
+ *   csv     one CSV line per frame: seq,type, then the payload fields
+ *   events  EVENT frames only, as text
+ *   stats   no frames, only the summary
+ *
+ * The summary (stderr) counts frames per type, CRC errors, frames missing
+ * from the sequence (lost on the device or the link, modulo 256), frames the device dropped from
+ * its TX ring (last STATUS), the bytes skipped outside frames and the
+ * samples the device never sent (a jump in the SAMPLES ends with no frame
+ * missing in between, counted modulo the ring wrap once a HELLO gave it).
+ *
+ * Usage: telemetry_decode [capture.bin|-] [text|csv|events|stats]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include "telemetry.h"
+#include "sample_ring.h"
+
+typedef enum {
+    MODE_TEXT,
+    MODE_CSV,
+    MODE_EVENTS,
+    MODE_STATS
+} decode_mode_t;
+
+typedef struct {
+    uint64_t frames[TELEMETRY_TYPE_COUNT];
+    uint64_t crc_errors;
+    uint64_t seq_missing;
+    uint64_t skipped_bytes;
+    uint32_t device_dropped;
+    bool have_seq;
+    uint8_t last_seq;
+    uint64_t samples_not_sent;
+    uint32_t ring_wrap;             // From the last HELLO, 0 before
+    bool have_samples_end;
+    uint32_t samples_end;           // End of the last SAMPLES frame
+    uint64_t samples_seq_missing;   // seq_missing at that frame
+} decode_stats_t;
+
+static const char *type_names[TELEMETRY_TYPE_COUNT] = {
+    "?", "hello", "samples", "features", "scores", "timing", "event", "status"
+};
+
+static const char *level_names[] = { "none", "low", "high", "critical" };
+
+// Labels from the last HELLO, for SCORES and EVENT
+static std::vector<std::string> labels;
+
+
+/* ========================================================================= */
+/* PAYLOAD READER                                                            */
+/* ========================================================================= */
+
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+    size_t pos;
+    bool ok;
+} reader_t;
+
+static bool take(reader_t *r, void *out, size_t n) {
+    if (!r->ok || r->len - r->pos < n) {
+        r->ok = false;
+        memset(out, 0, n);
+        return false;
+    }
+    memcpy(out, r->data + r->pos, n);
+    r->pos += n;
+    return true;
+}
+
+static uint8_t get_u8(reader_t *r) {
+    uint8_t b = 0;
+    take(r, &b, 1);
+    return b;
+}
+
+static uint16_t get_u16(reader_t *r) {
+    uint8_t b[2];
+    take(r, b, 2);
+    return (uint16_t)(b[0] | (b[1] << 8));
+}
+
+static uint32_t get_u32(reader_t *r) {
+    uint8_t b[4];
+    take(r, b, 4);
+    return (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+}
+
+static float get_f32(reader_t *r) {
+    uint32_t bits = get_u32(r);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static void skip(reader_t *r, size_t n) {
+    if (!r->ok || r->len - r->pos < n) {
+        r->ok = false;
+        return;
+    }
+    r->pos += n;
+}
+
+static const char *label_name(unsigned int index) {
+    return index < labels.size() ? labels[index].c_str() : "?";
+}
+
+
+/* ========================================================================= */
+/* FRAME OUTPUT                                                              */
+/* ========================================================================= */
+
+static void print_floats(reader_t *r, unsigned int count) {
+    for (unsigned int i = 0; i < count; i++) {
+        printf(",%.6g", (double)get_f32(r));
+    }
+}
+
+// Prints one frame in the selected mode; false if the payload is malformed
+static bool print_frame(uint8_t type, uint8_t seq, const uint8_t *payload, size_t len,
+                        decode_mode_t mode, decode_stats_t *stats) {
+    reader_t r = { payload, len, 0, true };
+    const bool csv = mode == MODE_CSV;
+    const bool print = mode == MODE_TEXT || mode == MODE_CSV || (mode == MODE_EVENTS && type == TELEMETRY_EVENT);
+
+    if (print) {
+        printf(csv ? "%u,%s" : "#%-3u %-8s", seq, type_names[type]);
+    }
+
+    switch (type) {
+        case TELEMETRY_HELLO: {
+            unsigned int version = get_u16(&r);
+            unsigned int rate = get_u16(&r);
+            unsigned int window = get_u16(&r);
+            unsigned int stride = get_u16(&r);
+            uint32_t wrap = version >= 2 ? get_u32(&r) : 0;
+            unsigned int count = get_u8(&r);
+            if (r.ok) {
+                stats->ring_wrap = wrap;
+            }
+            labels.clear();
+            for (unsigned int i = 0; i < count && r.ok; i++) {
+                const char *start = (const char*)r.data + r.pos;
+                size_t n = strnlen(start, r.len - r.pos);
+                if (n == r.len - r.pos) {
+                    r.ok = false;
+                    break;
+                }
+                labels.push_back(std::string(start, n));
+                r.pos += n + 1;
+            }
+            if (print) {
+                printf(csv ? ",%u,%u,%u,%u,%u,%u" : " v%u %u Hz window %u stride %u wrap %u labels %u:",
+                       version, rate, window, stride, wrap, count);
+                for (const std::string &label : labels) {
+                    printf(csv ? ",%s" : " %s", label.c_str());
+                }
+            }
+            break;
+        }
+        case TELEMETRY_SAMPLES:
+        case TELEMETRY_FEATURES: {
+            uint32_t end = get_u32(&r);
+            unsigned int count = get_u16(&r);
+            if (print) {
+                printf(csv ? ",%u,%u" : " end %u count %u", end, count);
+                if (csv) {
+                    print_floats(&r, count);
+                } else {
+                    // A summary, the full vectors are in the csv mode
+                    float lo = 0.0f, hi = 0.0f;
+                    for (unsigned int i = 0; i < count; i++) {
+                        float v = get_f32(&r);
+                        lo = (i == 0 || v < lo) ? v : lo;
+                        hi = (i == 0 || v > hi) ? v : hi;
+                    }
+                    printf(" range %.6g .. %.6g", (double)lo, (double)hi);
+                }
+            } else {
+                skip(&r, (size_t)count * sizeof(float));
+            }
+            if (type == TELEMETRY_SAMPLES && r.ok) {
+                // A jump is only the device's when no frame went missing since
+                // the previous SAMPLES frame (which could have carried them).
+                // Ends run backwards only when the device restarted
+                uint32_t wrap = stats->ring_wrap;
+                if (wrap > 0 && stats->have_samples_end && stats->seq_missing == stats->samples_seq_missing) {
+                    uint32_t first = sample_ring_position_sub(wrap, end, count);
+                    uint32_t jump = sample_ring_position_sub(wrap, first, stats->samples_end);
+                    if (jump < wrap / 2) {
+                        stats->samples_not_sent += jump;
+                    }
+                }
+                stats->have_samples_end = true;
+                stats->samples_end = end;
+                stats->samples_seq_missing = stats->seq_missing;
+            }
+            break;
+        }
+        case TELEMETRY_SCORES: {
+            uint32_t end = get_u32(&r);
+            unsigned int count = get_u8(&r);
+            unsigned int best = get_u8(&r);
+            if (print && csv) {
+                printf(",%u,%u,%u", end, count, best);
+                print_floats(&r, count);
+            } else if (print) {
+                printf(" end %u best %s", end, label_name(best));
+                for (unsigned int i = 0; i < count; i++) {
+                    printf(" %s=%.4f", label_name(i), (double)get_f32(&r));
+                }
+            } else {
+                skip(&r, (size_t)count * sizeof(float));
+            }
+            break;
+        }
+        case TELEMETRY_TIMING: {
+            uint32_t end = get_u32(&r);
+            uint32_t dsp = get_u32(&r);
+            uint32_t classification = get_u32(&r);
+            uint32_t total = get_u32(&r);
+            if (print) {
+                printf(csv ? ",%u,%u,%u,%u" : " end %u dsp %u us classification %u us total %u us",
+                       end, dsp, classification, total);
+            }
+            break;
+        }
+        case TELEMETRY_EVENT: {
+            uint32_t end = get_u32(&r);
+            uint32_t timestamp = get_u32(&r);
+            unsigned int level = get_u8(&r);
+            unsigned int label = get_u8(&r);
+            get_u16(&r);
+            float confidence = get_f32(&r);
+            uint32_t total = get_u32(&r);
+            uint32_t high = get_u32(&r);
+            uint32_t critical = get_u32(&r);
+            const char *level_name = level < sizeof(level_names) / sizeof(level_names[0]) ? level_names[level] : "?";
+            if (print && csv) {
+                printf(",%u,%u,%s,%s,%.4f,%u,%u,%u", end, timestamp, level_name, label_name(label),
+                       (double)confidence, total, high, critical);
+            } else if (print) {
+                printf(" end %u at %u ms %s %s %.2f%% (total %u, high %u, critical %u)", end, timestamp,
+                       level_name, label_name(label), (double)confidence * 100.0, total, high, critical);
+            }
+            break;
+        }
+        case TELEMETRY_STATUS: {
+            uint32_t uptime = get_u32(&r);
+            uint32_t run = get_u32(&r);
+            uint32_t dropped = get_u32(&r);
+            uint32_t overruns = get_u32(&r);
+            uint32_t tx_dropped = get_u32(&r);
+            unsigned int flags = get_u8(&r);
+            if (r.ok) {
+                stats->device_dropped = tx_dropped;
+            }
+            if (print) {
+                printf(csv ? ",%u,%u,%u,%u,%u,%u" :
+                             " uptime %u ms windows %u run %u dropped, ADC overruns %u, tx dropped %u, flags %#x",
+                       uptime, run, dropped, overruns, tx_dropped, flags);
+            }
+            break;
+        }
+    }
+
+    if (print) {
+        printf("%s\n", r.ok ? "" : (csv ? ",malformed" : " (malformed)"));
+    }
+    return r.ok;
+}
+
+
+/* ========================================================================= */
+/* STREAM                                                                    */
+/* ========================================================================= */
+
+// Decodes every complete frame in buf and returns the bytes consumed; an
+// incomplete frame at the end is kept for the next read
+static size_t decode_buffer(const uint8_t *buf, size_t len, bool at_eof, decode_mode_t mode, decode_stats_t *stats) {
+    size_t pos = 0;
+    while (pos < len) {
+        if (buf[pos] != TELEMETRY_SYNC0) {
+            stats->skipped_bytes++;
+            pos++;
+            continue;
+        }
+        if (len - pos < TELEMETRY_HEADER_BYTES) {
+            break;
+        }
+        if (buf[pos + 1] != TELEMETRY_SYNC1) {
+            stats->skipped_bytes++;
+            pos++;
+            continue;
+        }
+
+        uint8_t type = buf[pos + 2];
+        uint8_t seq = buf[pos + 3];
+        size_t length = (size_t)(buf[pos + 4] | (buf[pos + 5] << 8));
+        size_t frame_bytes = TELEMETRY_HEADER_BYTES + length + TELEMETRY_CRC_BYTES;
+        if (length > TELEMETRY_MAX_PAYLOAD || type == 0 || type >= TELEMETRY_TYPE_COUNT) {
+            stats->skipped_bytes++;
+            pos++;
+            continue;
+        }
+        if (len - pos < frame_bytes) {
+            break;
+        }
+
+        const uint8_t *frame = buf + pos;
+        uint16_t crc = telemetry_crc16(0xFFFF, frame + 2, TELEMETRY_HEADER_BYTES - 2 + length);
+        uint16_t sent = (uint16_t)(frame[frame_bytes - 2] | (frame[frame_bytes - 1] << 8));
+        if (crc != sent) {
+            stats->crc_errors++;
+            stats->skipped_bytes++;
+            pos++;
+            continue;
+        }
+
+        if (stats->have_seq) {
+            stats->seq_missing += (uint8_t)(seq - stats->last_seq - 1);
+        }
+        stats->have_seq = true;
+        stats->last_seq = seq;
+        stats->frames[type]++;
+
+        print_frame(type, seq, frame + TELEMETRY_HEADER_BYTES, length, mode, stats);
+        pos += frame_bytes;
+    }
+
+    if (at_eof) {
+        stats->skipped_bytes += len - pos;
+        return len;
+    }
+    return pos;
+}
+
+
+/* ========================================================================= */
+/* MAIN                                                                      */
+/* ========================================================================= */
+
+int main(int argc, char **argv) {
+    const char *path = argc > 1 && strcmp(argv[1], "-") != 0 ? argv[1] : NULL;
+    const char *mode_name = argc > 2 ? argv[2] : "text";
+
+    decode_mode_t mode;
+    if (strcmp(mode_name, "text") == 0) {
+        mode = MODE_TEXT;
+    } else if (strcmp(mode_name, "csv") == 0) {
+        mode = MODE_CSV;
+    } else if (strcmp(mode_name, "events") == 0) {
+        mode = MODE_EVENTS;
+    } else if (strcmp(mode_name, "stats") == 0) {
+        mode = MODE_STATS;
+    } else {
+        fprintf(stderr, "Usage: telemetry_decode [capture.bin|-] [text|csv|events|stats]\n");
+        return 1;
+    }
+
+    FILE *in = path ? fopen(path, "rb") : stdin;
+    if (!in) {
+        fprintf(stderr, "Cannot read %s\n", path);
+        return 1;
+    }
+
+    decode_stats_t stats = {};
+    std::vector<uint8_t> buf;
+    uint8_t chunk[4096];
+    uint64_t total_bytes = 0;
+    ssize_t n;
+
+    // read(), not fread(): a serial port is decoded as the frames arrive
+    while ((n = read(fileno(in), chunk, sizeof(chunk))) > 0) {
+        total_bytes += n;
+        buf.insert(buf.end(), chunk, chunk + n);
+        size_t used = decode_buffer(buf.data(), buf.size(), false, mode, &stats);
+        buf.erase(buf.begin(), buf.begin() + (long)used);
+        fflush(stdout);
+    }
+    decode_buffer(buf.data(), buf.size(), true, mode, &stats);
+    if (path) {
+        fclose(in);
+    }
+
+    uint64_t frames = 0;
+    fprintf(stderr, "\n[telemetry] %llu bytes\n", (unsigned long long)total_bytes);
+    for (int type = 1; type < TELEMETRY_TYPE_COUNT; type++) {
+        fprintf(stderr, "  %-9s %llu\n", type_names[type], (unsigned long long)stats.frames[type]);
+        frames += stats.frames[type];
+    }
+    fprintf(stderr, "  frames    %llu\n", (unsigned long long)frames);
+    fprintf(stderr, "  CRC errors %llu, missing from sequence %llu, device TX drops %u, bytes outside frames %llu\n",
+            (unsigned long long)stats.crc_errors, (unsigned long long)stats.seq_missing,
+            stats.device_dropped, (unsigned long long)stats.skipped_bytes);
+    fprintf(stderr, "  samples not sent %llu (no window covered them)\n",
+            (unsigned long long)stats.samples_not_sent);
+
+    return stats.crc_errors > 0 ? 2 : 0;
+}
@@ -129,6 +129,9 @@
 #define EI_CLASSIFIER_HAS_VISUAL_ANOMALY            0
 #define EI_CLASSIFIER_HAS_MODEL_VARIABLES           1
 #define EI_CLASSIFIER_HAS_DATA_NORMALIZATION        1
+#ifndef EI_CLASSIFIER_DATA_NORMALIZATION_FOLDED   // 0: separate standard scaler pass
+#define EI_CLASSIFIER_DATA_NORMALIZATION_FOLDED     1
+#endif
 #define EI_CLASSIFIER_CALIBRATION_ENABLED           0
 #define EI_CLASSIFIER_OBJECT_TRACKING_ENABLED       0
 #define EI_CLASSIFIER_TFLITE_LARGEST_ARENA_SIZE     10969
@@ -159,6 +162,7 @@
 #define EI_HAS_QC_FACE_DET_LITE                     0
 
 #define EI_DSP_PARAMS_SPECTRAL_ANALYSIS_ANALYSIS_TYPE_WAVELET 1
+#define EI_DSP_PARAMS_SPECTRAL_ANALYSIS_WAVELET_BIOR3P7 1
 
 #ifndef EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW
 #define EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW    4
@@ -278,6 +282,8 @@ typedef struct {
     int wavelet_level;
     const char * wavelet;
     bool extra_low_freq;
+    const float * feature_scale; // folded data normalization, nullptr if none
+    const float * feature_offset;
 } ei_dsp_config_spectral_analysis_t;
 
 typedef struct {
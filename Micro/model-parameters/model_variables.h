@@ -48,6 +48,12 @@
 
 const char* ei_classifier_inferencing_categories_815551_17[] = { "earthquake_local", "noise" };
 
+const float ei_dn_standard_scaler_mean_815551_94[56] = { 3.2735072139104537, 0.40475008861993617, 0.4479637065978409, -0.002055267757394674, -0.000534700001957804, 0.0005229175848595695, 0.00209027262785485, 0.0000013273803475172211, -0.0000014236173540722478, 0.001361796940808691, 0.00013427562124624417, 0.0013633089104268486, 0.0086610377362699, 3.3717445525449654, 3.041850381054428, 0.31386783850104055, 0.36270767482501437, -0.000777801626628249, -0.0001559923210222878, 0.00015818288275829616, 0.0007822876088234983, 0.000001445592902610735, 4.250134032604676e-8, 0.0005396103855498861, 0.00003089350458679939, 0.0005418355272147931, -0.005515951508731255, 5.027222776510986, 2.891312854407399, 0.3481492246563725, 0.40680723704977845, -0.00022817798431451727, -0.000040997953131639566, 0.00004065343115812917, 0.0002293676126572569, -1.3318915484835865e-7, -7.638114844696143e-8, 0.00015285300876574908, 0.0000026269627211998157, 0.00015307433040045713, 0.0028342369073106896, 9.239080719260977, 2.2717337519715226, 0.29820440302693885, 0.3715823646083181, -0.000034570633759237306, -0.000005857183401586543, 0.0000059127056438912536, 0.000034359126103257625, 3.4081116941817e-9, 1.0047976297596566e-12, 0.00002366467486187462, 6.414552458099196e-8, 0.000023664728225512484, 0.0032699599487550505, 11.898504040794844 };
+const float ei_dn_standard_scaler_scale_815551_94[56] = { 0.9136664805776182, 4.421453108882977, 4.737286929831859, 57.17121780729373, 234.8076124337025, 253.0076188669572, 54.97216096351889, 2350.7324006029335, 1881.8181054218062, 87.22135120154829, 195.31395281436602, 87.12917739040141, 0.8251610418249639, 0.0758346913432614, 0.7978267225244109, 5.041366717216338, 5.726717076908515, 135.16572970119321, 752.4487034334651, 692.9141931979769, 132.9670052379439, 8657.934902553796, 2512.222464136145, 181.4333540379926, 669.9486800428699, 180.96916721457958, 0.6694353389129604, 0.0640974661403733, 0.7244484605327293, 4.083568951531194, 4.442582825986478, 395.1800324061041, 2614.678530011994, 2686.577978600454, 357.18647353334455, 55637.58499571933, 12820.972725731333, 620.9463161001677, 7774.4761945063665, 620.2274077120645, 0.5088573710137055, 0.03224853292054207, 0.6185319450032343, 3.754784476020276, 3.6455169386666557, 2695.429432198419, 18219.95513805545, 18035.675737078134, 2732.674870463791, 733359.9846807093, 2799164.094018341, 3969.661091037661, 362005.3246194652, 3969.6571730289247, 0.43487788144223977, 0.019563614093723654 };
+const float ei_dn_standard_scaler_var_815551_94[56] = { 1.1979111720093958, 0.05115286382194633, 0.04455953190124559, 0.0003059462352897086, 0.000018137426054339767, 0.000015621862152559443, 0.0003309134207356225, 1.809645942258829e-7, 2.8238700978902816e-7, 0.0001314481200739469, 0.000026214010017464458, 0.0001317263846770502, 1.468664403831495, 173.88581413530414, 1.57102408414103, 0.03934625663047366, 0.03049218489545196, 0.0000547352131130639, 0.0000017662257155332717, 0.0000020827689067120556, 0.00005656036782909978, 1.334047728754806e-8, 1.584469233029608e-7, 0.00003037845913565102, 0.0000022280089362997483, 0.00003053450080386764, 2.231427241487203, 243.3987125885102, 1.90539496055751, 0.05996808960537773, 0.050667436656425036, 0.0000064033909074591364, 1.4627274058584924e-7, 1.3854826729829583e-7, 0.000007838085416729467, 3.2304532354241263e-10, 6.083563525603842e-9, 0.0000025935336684367293, 1.6544655321273535e-8, 0.0000025995495060751522, 3.861960791740075, 961.5681633367559, 2.6138203288383233, 0.07093000210630418, 0.07524571252221736, 1.376398109696046e-7, 3.0123497432005458e-9, 3.074221552301687e-9, 1.3391341145597792e-7, 1.8593689806248247e-12, 1.276272121405865e-13, 6.345898754886707e-8, 7.630800211088957e-12, 6.345911281559893e-8, 5.287682394788273, 2612.7738758794226 };
+// -mean * scale, folded at export: features are written as x * scale + offset
+const float ei_dn_standard_scaler_offset_815551_94[56] = { -2.9908938152790085, -1.7895835376492772, -2.1221326123049855, 0.11750216061031903, 0.125551630828008, -0.13230213300897972, -0.11490680335607442, -0.003120315990832313, 0.002678988912085842, -0.1187777692394689, -0.02622590235220862, -0.11878398389449576, -0.007146750921745798, -0.25569520743057045, -2.4268695199262846, -1.5823228746237785, -2.0771242353461905, 0.10513212442598231, 0.11737621969879732, -0.10960716458419496, -0.10401844058001272, -0.012515849246397532, -0.00010677282192299009, -0.09790332212405016, -0.0206970626198246, -0.09805552412733379, 0.0036925728676749626, -0.3222322416975264, -2.0946071462939315, -1.421691364306421, -1.8072748448043559, 0.09017138323577045, 0.10719646782773597, -0.10921861290397938, -0.08192700870780771, 0.0074103229233835775, 0.0009792806209985285, -0.09491351269791853, -0.02042325913982363, -0.0949408951315356, -0.001442222341484133, -0.2979467987306331, -1.405139896136441, -1.1196932631664438, -1.354609804289433, 0.0931827037244005, 0.10671761881226983, -0.10663964172201443, -0.0938923204734686, -0.002499372739835238, -2.8125934469779657e-06, -0.09394073903124073, -0.02322102144882788, -0.09394085814818569, -0.0014220332549155714, -0.23277774134672186 };
+
 EI_CLASSIFIER_DSP_AXES_INDEX_TYPE ei_dsp_config_815551_94_axes[] = { 0 };
 const uint32_t ei_dsp_config_815551_94_axes_size = 1;
 ei_dsp_config_spectral_analysis_t ei_dsp_config_815551_94 = {
@@ -68,12 +74,16 @@ ei_dsp_config_spectral_analysis_t ei_dsp_config_815551_94 = {
     false, // boolean do-fft-overlap
     3, // int wavelet-level
     "bior3.7", // select wavelet
-    false // boolean extra-low-freq
+    false, // boolean extra-low-freq
+#if EI_CLASSIFIER_DATA_NORMALIZATION_FOLDED
+    ei_dn_standard_scaler_scale_815551_94, // folded data normalization scale
+    ei_dn_standard_scaler_offset_815551_94 // folded data normalization offset
+#else
+    nullptr, // folded data normalization scale
+    nullptr // folded data normalization offset
+#endif
 };
 
-const float ei_dn_standard_scaler_mean_815551_94[56] = { 3.2735072139104537, 0.40475008861993617, 0.4479637065978409, -0.002055267757394674, -0.000534700001957804, 0.0005229175848595695, 0.00209027262785485, 0.0000013273803475172211, -0.0000014236173540722478, 0.001361796940808691, 0.00013427562124624417, 0.0013633089104268486, 0.0086610377362699, 3.3717445525449654, 3.041850381054428, 0.31386783850104055, 0.36270767482501437, -0.000777801626628249, -0.0001559923210222878, 0.00015818288275829616, 0.0007822876088234983, 0.000001445592902610735, 4.250134032604676e-8, 0.0005396103855498861, 0.00003089350458679939, 0.0005418355272147931, -0.005515951508731255, 5.027222776510986, 2.891312854407399, 0.3481492246563725, 0.40680723704977845, -0.00022817798431451727, -0.000040997953131639566, 0.00004065343115812917, 0.0002293676126572569, -1.3318915484835865e-7, -7.638114844696143e-8, 0.00015285300876574908, 0.0000026269627211998157, 0.00015307433040045713, 0.0028342369073106896, 9.239080719260977, 2.2717337519715226, 0.29820440302693885, 0.3715823646083181, -0.000034570633759237306, -0.000005857183401586543, 0.0000059127056438912536, 0.000034359126103257625, 3.4081116941817e-9, 1.0047976297596566e-12, 0.00002366467486187462, 6.414552458099196e-8, 0.000023664728225512484, 0.0032699599487550505, 11.898504040794844 };
-const float ei_dn_standard_scaler_scale_815551_94[56] = { 0.9136664805776182, 4.421453108882977, 4.737286929831859, 57.17121780729373, 234.8076124337025, 253.0076188669572, 54.97216096351889, 2350.7324006029335, 1881.8181054218062, 87.22135120154829, 195.31395281436602, 87.12917739040141, 0.8251610418249639, 0.0758346913432614, 0.7978267225244109, 5.041366717216338, 5.726717076908515, 135.16572970119321, 752.4487034334651, 692.9141931979769, 132.9670052379439, 8657.934902553796, 2512.222464136145, 181.4333540379926, 669.9486800428699, 180.96916721457958, 0.6694353389129604, 0.0640974661403733, 0.7244484605327293, 4.083568951531194, 4.442582825986478, 395.1800324061041, 2614.678530011994, 2686.577978600454, 357.18647353334455, 55637.58499571933, 12820.972725731333, 620.9463161001677, 7774.4761945063665, 620.2274077120645, 0.5088573710137055, 0.03224853292054207, 0.6185319450032343, 3.754784476020276, 3.6455169386666557, 2695.429432198419, 18219.95513805545, 18035.675737078134, 2732.674870463791, 733359.9846807093, 2799164.094018341, 3969.661091037661, 362005.3246194652, 3969.6571730289247, 0.43487788144223977, 0.019563614093723654 };
-const float ei_dn_standard_scaler_var_815551_94[56] = { 1.1979111720093958, 0.05115286382194633, 0.04455953190124559, 0.0003059462352897086, 0.000018137426054339767, 0.000015621862152559443, 0.0003309134207356225, 1.809645942258829e-7, 2.8238700978902816e-7, 0.0001314481200739469, 0.000026214010017464458, 0.0001317263846770502, 1.468664403831495, 173.88581413530414, 1.57102408414103, 0.03934625663047366, 0.03049218489545196, 0.0000547352131130639, 0.0000017662257155332717, 0.0000020827689067120556, 0.00005656036782909978, 1.334047728754806e-8, 1.584469233029608e-7, 0.00003037845913565102, 0.0000022280089362997483, 0.00003053450080386764, 2.231427241487203, 243.3987125885102, 1.90539496055751, 0.05996808960537773, 0.050667436656425036, 0.0000064033909074591364, 1.4627274058584924e-7, 1.3854826729829583e-7, 0.000007838085416729467, 3.2304532354241263e-10, 6.083563525603842e-9, 0.0000025935336684367293, 1.6544655321273535e-8, 0.0000025995495060751522, 3.861960791740075, 961.5681633367559, 2.6138203288383233, 0.07093000210630418, 0.07524571252221736, 1.376398109696046e-7, 3.0123497432005458e-9, 3.074221552301687e-9, 1.3391341145597792e-7, 1.8593689806248247e-12, 1.276272121405865e-13, 6.345898754886707e-8, 7.630800211088957e-12, 6.345911281559893e-8, 5.287682394788273, 2612.7738758794226 };
 ei_data_normalization_standard_scaler_config_t ei_data_normalization_standard_scaler_config_815551_94 = {
     .mean_data = (float *)ei_dn_standard_scaler_mean_815551_94,
     .mean_data_len = 56,
@@ -88,7 +98,11 @@ ei_data_normalization_t ei_data_normalization_config_815551_94 = {
     nullptr, // context
     nullptr, // init func
     nullptr, // deinit func
+#if EI_CLASSIFIER_DATA_NORMALIZATION_FOLDED
+    nullptr // exec func, folded into the DSP block's feature writer
+#else
     &data_normalization_standard_scaler // exec func
+#endif
 };
 
 const uint8_t ei_dsp_blocks_815551_17_size = 1;
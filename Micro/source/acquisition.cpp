@@ -0,0 +1,121 @@
+/* SM-24 Geophone acquisition - shared block processing
+ *
+ * See acquisition.h. This file holds everything that is the same on the board
+ * and on the host: the raw block buffers, the decimation kernel and the
+ * producer/consumer bookkeeping between the backend and the main loop.
+ */
+
+#include <string.h>
+#include "acquisition.h"
+
+#if defined(__ARM_FEATURE_SIMD32) && __ARM_FEATURE_SIMD32
+#include <arm_acle.h>
+#endif
+
+static uint16_t raw_blocks[ACQ_BLOCK_COUNT][ACQ_BLOCK_CODES] __attribute__((aligned(4)));
+static uint32_t acq_oversample = 0;
+
+// Written by the backend (DMA interrupt), read by the main loop
+static volatile uint32_t blocks_completed = 0;
+static uint32_t blocks_consumed = 0;
+static uint32_t overruns = 0;
+
+
+/* ========================================================================= */
+/* BLOCK KERNEL                                                              */
+/* ========================================================================= */
+
+void acquisition_decimate(const uint16_t *raw, size_t out_count, uint32_t factor, uint16_t *out) {
+    for (size_t k = 0; k < out_count; k++) {
+        const uint16_t *p = raw + k * factor;
+        uint32_t sum = 0;
+
+#if defined(__ARM_FEATURE_SIMD32) && __ARM_FEATURE_SIMD32
+        // Two 12-bit codes per word: SMLAD multiplies both halves by 1 and
+        // accumulates, so the sum costs one instruction per pair
+        const uint32_t *pairs = (const uint32_t *)p;
+        for (uint32_t i = 0; i < factor / 2; i++) {
+            sum = (uint32_t)__smlad((int16x2_t)pairs[i], (int16x2_t)0x00010001, (int32_t)sum);
+        }
+#else
+        for (uint32_t i = 0; i < factor; i++) {
+            sum += p[i];
+        }
+#endif
+
+        out[k] = (uint16_t)(sum / factor);
+    }
+}
+
+
+/* ========================================================================= */
+/* APPLICATION API                                                           */
+/* ========================================================================= */
+
+bool acquisition_start(uint32_t sample_rate_hz, uint32_t oversample) {
+    if (sample_rate_hz == 0 || oversample == 0 || oversample % 2 != 0 ||
+        ACQ_BLOCK_CODES % oversample != 0) {
+        return false;
+    }
+
+    acq_oversample = oversample;
+    blocks_completed = 0;
+    blocks_consumed = 0;
+    overruns = 0;
+
+    uint16_t *blocks[ACQ_BLOCK_COUNT];
+    for (int i = 0; i < ACQ_BLOCK_COUNT; i++) {
+        memset(raw_blocks[i], 0, sizeof(raw_blocks[i]));
+        blocks[i] = raw_blocks[i];
+    }
+
+    return acq_backend_start(sample_rate_hz * oversample, blocks, ACQ_BLOCK_CODES);
+}
+
+size_t acquisition_block_samples(void) {
+    return acq_oversample ? ACQ_BLOCK_CODES / acq_oversample : 0;
+}
+
+size_t acquisition_poll(uint16_t *out, size_t capacity, uint64_t *first_index) {
+    acq_backend_service();
+
+    uint32_t completed = blocks_completed;
+    if (completed == blocks_consumed) {
+        return 0;
+    }
+
+    // The DMA keeps going while we are busy; anything more than one block
+    // behind has already been overwritten by the next lap
+    if (completed - blocks_consumed > ACQ_BLOCK_COUNT - 1) {
+        overruns += completed - blocks_consumed - (ACQ_BLOCK_COUNT - 1);
+        blocks_consumed = completed - (ACQ_BLOCK_COUNT - 1);
+    }
+
+    size_t samples = acquisition_block_samples();
+    if (samples > capacity) {
+        samples = capacity;
+    }
+
+    uint32_t block = blocks_consumed % ACQ_BLOCK_COUNT;
+    acquisition_decimate(raw_blocks[block], samples, acq_oversample, out);
+
+    if (first_index) {
+        *first_index = (uint64_t)blocks_consumed * acquisition_block_samples();
+    }
+    blocks_consumed++;
+    return samples;
+}
+
+uint32_t acquisition_overruns(void) {
+    return overruns;
+}
+
+
+/* ========================================================================= */
+/* PLATFORM BACKEND                                                          */
+/* ========================================================================= */
+
+void acquisition_block_ready(unsigned int block) {
+    (void)block;  // Blocks complete strictly in order
+    blocks_completed = blocks_completed + 1;
+}
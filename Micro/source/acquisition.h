@@ -0,0 +1,95 @@
+/* SM-24 Geophone acquisition - ADC free-running mode + DMA ping-pong
+ *
+ * The ADC converts continuously at SAMPLE_RATE_HZ x oversample, paced by its
+ * clock divider, and pushes every result through its FIFO. Two chained DMA
+ * channels copy the FIFO into a pair of raw blocks: while one block fills,
+ * the main loop averages the other down to the output rate. Sample timing is
+ * set by the ADC clock alone, so it no longer depends on how long inference
+ * or alerting keep the main loop busy, and the CPU no longer spins on
+ * adc_read().
+ *
+ * The platform backend (DMA on the RP2350, a fake ADC source on the host)
+ * only fills raw blocks and reports them with acquisition_block_ready();
+ * decimation and bookkeeping are shared.
+ */
+
+#ifndef SEISMIC_ACQUISITION_H
+#define SEISMIC_ACQUISITION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Raw ADC codes per DMA block. With 64x oversampling a block holds 10 output
+// samples, i.e. 100 ms of signal at 100 Hz, which bounds the added latency.
+#define ACQ_BLOCK_CODES         640
+#define ACQ_BLOCK_COUNT         2           // Ping-pong
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ========================================================================= */
+/* APPLICATION API                                                           */
+/* ========================================================================= */
+
+/**
+ * Configure and start acquisition. oversample must be even and divide
+ * ACQ_BLOCK_CODES. Returns false if the configuration is not supported.
+ */
+bool acquisition_start(uint32_t sample_rate_hz, uint32_t oversample);
+
+/**
+ * Output samples produced per completed block.
+ */
+size_t acquisition_block_samples(void);
+
+/**
+ * Average one completed block down to the output rate. Writes at most
+ * capacity codes to out and returns how many were written (0 when no block
+ * is ready). first_index receives the index of out[0] counted from
+ * acquisition_start(), which gives the exact sample time.
+ */
+size_t acquisition_poll(uint16_t *out, size_t capacity, uint64_t *first_index);
+
+/**
+ * Blocks that were overwritten by DMA before the main loop consumed them.
+ */
+uint32_t acquisition_overruns(void);
+
+/**
+ * Block kernel: average every `factor` consecutive raw codes into one output
+ * code (truncating, like sum / factor). raw must be 4-byte aligned and factor
+ * even; uses the M33 dual 16-bit MAC (SMLAD) where available.
+ */
+void acquisition_decimate(const uint16_t *raw, size_t out_count, uint32_t factor, uint16_t *out);
+
+
+/* ========================================================================= */
+/* PLATFORM BACKEND                                                          */
+/* ========================================================================= */
+
+/**
+ * Start filling blocks[0], blocks[1], blocks[0], ... with block_len codes each,
+ * converting at conversion_rate_hz. Implemented by acquisition_rp2350.cpp on
+ * the board and host/host_acquisition.cpp on the host.
+ */
+bool acq_backend_start(uint32_t conversion_rate_hz, uint16_t *blocks[ACQ_BLOCK_COUNT], size_t block_len);
+
+/**
+ * Called before each poll. Backends without interrupts (host) fill blocks
+ * here, the DMA backend does nothing.
+ */
+void acq_backend_service(void);
+
+/**
+ * Reported by the backend (from the DMA interrupt on the board) each time a
+ * block has been completely written.
+ */
+void acquisition_block_ready(unsigned int block);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SEISMIC_ACQUISITION_H
@@ -0,0 +1,95 @@
+/* SM-24 Geophone acquisition - RP2350 backend
+ *
+ * ADC in free-running mode with its FIFO raising DREQ_ADC on every result.
+ * Two DMA channels, chained to each other, move 16-bit results into the two
+ * raw blocks in turn; each one raises DMA_IRQ_0 when its block is full, and
+ * the handler re-arms its write address for the next lap before reporting
+ * the block. The conversion rate comes from the ADC clock divider (48 MHz
+ * ADC clock, one result every 1 + div cycles), so samples are evenly spaced
+ * whatever the CPU is doing.
+ */
+
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "acquisition.h"
+
+#define ACQ_ADC_CLOCK_HZ    48000000.0f
+#define ACQ_ADC_MIN_CYCLES  96          // One conversion takes 96 ADC clocks
+
+static int dma_channels[ACQ_BLOCK_COUNT] = {-1, -1};
+static uint16_t *dma_blocks[ACQ_BLOCK_COUNT];
+
+
+/* ========================================================================= */
+/* DMA INTERRUPT                                                             */
+/* ========================================================================= */
+
+static void acq_dma_irq_handler(void) {
+    for (unsigned int i = 0; i < ACQ_BLOCK_COUNT; i++) {
+        if (dma_channel_get_irq0_status(dma_channels[i])) {
+            dma_channel_acknowledge_irq0(dma_channels[i]);
+
+            // The other channel is already running (chained); point this one
+            // back at the start of its block so the chain can trigger it again
+            dma_channel_set_write_addr(dma_channels[i], dma_blocks[i], false);
+
+            acquisition_block_ready(i);
+        }
+    }
+}
+
+
+/* ========================================================================= */
+/* BACKEND                                                                   */
+/* ========================================================================= */
+
+bool acq_backend_start(uint32_t conversion_rate_hz, uint16_t *blocks[ACQ_BLOCK_COUNT], size_t block_len) {
+    float div = ACQ_ADC_CLOCK_HZ / (float)conversion_rate_hz - 1.0f;
+    if (div < (float)(ACQ_ADC_MIN_CYCLES - 1)) {
+        printf("[ADC] Conversion rate %u Hz is above the ADC limit\n", conversion_rate_hz);
+        return false;
+    }
+
+    // FIFO on, DREQ on every sample, no error bit, full 12-bit results
+    adc_fifo_setup(true, true, 1, false, false);
+    adc_set_clkdiv(div);
+
+    for (unsigned int i = 0; i < ACQ_BLOCK_COUNT; i++) {
+        dma_channels[i] = dma_claim_unused_channel(true);
+        dma_blocks[i] = blocks[i];
+    }
+
+    for (unsigned int i = 0; i < ACQ_BLOCK_COUNT; i++) {
+        dma_channel_config cfg = dma_channel_get_default_config(dma_channels[i]);
+        channel_config_set_transfer_data_size(&cfg, DMA_SIZE_16);
+        channel_config_set_read_increment(&cfg, false);
+        channel_config_set_write_increment(&cfg, true);
+        channel_config_set_dreq(&cfg, DREQ_ADC);
+        channel_config_set_chain_to(&cfg, dma_channels[(i + 1) % ACQ_BLOCK_COUNT]);
+
+        dma_channel_configure(dma_channels[i], &cfg,
+                              blocks[i],          // Write: raw block
+                              &adc_hw->fifo,      // Read: ADC FIFO
+                              block_len,
+                              false);
+        dma_channel_set_irq0_enabled(dma_channels[i], true);
+    }
+
+    irq_set_exclusive_handler(DMA_IRQ_0, acq_dma_irq_handler);
+    irq_set_enabled(DMA_IRQ_0, true);
+
+    adc_fifo_drain();
+    dma_channel_start(dma_channels[0]);
+    adc_run(true);
+
+    printf("[ADC] Free-running at %u Hz, DMA blocks of %u codes\n",
+           conversion_rate_hz, (unsigned int)block_len);
+    return true;
+}
+
+void acq_backend_service(void) {
+    // Blocks are reported from the DMA interrupt
+}
@@ -0,0 +1,249 @@
+/* Alert engine - pattern tables and the tick, see alert.h
+ *
+ * Requests are handed to the tick through per-request counters: the
+ * request functions only increment their own counter and the tick only
+ * reads them, so neither side needs a lock, on the board (tick in a timer
+ * interrupt on core 0) or on the host (tick from alert_poll()).
+ */
+
+#include <stddef.h>
+#include "hardware/gpio.h"
+#include "alert.h"
+
+enum {
+    REQUEST_SILENCED = DETECTION_LEVEL_COUNT,   // Levels first
+    REQUEST_ENABLED,
+    REQUEST_CLEAR,
+    REQUEST_COUNT
+};
+
+typedef struct {
+    const alert_pattern_t *pattern;     // NULL when idle
+    int level;
+    uint8_t segment;
+    uint8_t blink;
+    bool on;
+    uint64_t until_us;                  // End of the current on or off time
+} alert_player_t;
+
+
+/* ========================================================================= */
+/* PATTERNS                                                                  */
+/* ========================================================================= */
+
+static const alert_segment_t low_segments[] = {
+    { ALERT_OUT_STATUS, 2, 200, 200 },
+};
+
+static const alert_segment_t high_segments[] = {
+    { ALERT_OUT_ALERT, 5, 100, 100 },
+    { ALERT_OUT_BUZZER, 3, 150, 150 },
+};
+
+static const alert_segment_t critical_segments[] = {
+    { ALERT_OUT_ALERT, 10, 50, 50 },
+    { ALERT_OUT_BUZZER, 5, 100, 100 },
+};
+
+#define SEGMENTS(s) s, (uint8_t)(sizeof(s) / sizeof(s[0]))
+
+static const alert_pattern_t level_patterns[DETECTION_LEVEL_COUNT] = {
+    { NULL, 0, 0 },                                     // DETECTION_NONE
+    { SEGMENTS(low_segments), 0 },                      // DETECTION_LOW
+    { SEGMENTS(high_segments), 0 },                     // DETECTION_HIGH
+    { SEGMENTS(critical_segments), ALERT_OUT_ALERT },   // DETECTION_CRITICAL, LED stays on
+};
+
+static const alert_segment_t silenced_segments[] = {
+    { ALERT_OUT_FEEDBACK, 1, 100, 100 },
+};
+
+static const alert_segment_t enabled_segments[] = {
+    { ALERT_OUT_FEEDBACK, 3, 100, 100 },
+};
+
+static const alert_pattern_t feedback_patterns[2] = {
+    { SEGMENTS(silenced_segments), 0 },
+    { SEGMENTS(enabled_segments), 0 },
+};
+
+
+/* ========================================================================= */
+/* STATE                                                                     */
+/* ========================================================================= */
+
+static unsigned int output_pins[ALERT_OUTPUT_COUNT];
+static volatile uint32_t requested[REQUEST_COUNT];  // Request functions only
+static uint32_t served[REQUEST_COUNT];              // Tick only
+static volatile bool buzzer_silenced = false;
+static volatile bool alert_playing = false;
+
+// Tick only
+static alert_player_t alert_player;
+static alert_player_t feedback_player;
+static uint8_t held = 0;
+static uint8_t driven = 0;                          // Outputs last written
+
+
+/* ========================================================================= */
+/* PLAYER                                                                    */
+/* ========================================================================= */
+
+static void player_start(alert_player_t *player, const alert_pattern_t *pattern, int level, uint64_t now_us) {
+    player->pattern = pattern->segment_count > 0 ? pattern : NULL;
+    player->level = level;
+    player->segment = 0;
+    player->blink = 0;
+    player->on = true;
+    player->until_us = now_us + (pattern->segment_count > 0 ? pattern->segments[0].on_ms * 1000ULL : 0);
+}
+
+// Steps through every on/off time that ended by now_us; returns the outputs
+// that are on
+static uint8_t player_advance(alert_player_t *player, uint64_t now_us) {
+    while (player->pattern && now_us >= player->until_us) {
+        const alert_segment_t *segment = &player->pattern->segments[player->segment];
+        if (player->on) {
+            player->on = false;
+            player->until_us += segment->off_ms * 1000ULL;
+            continue;
+        }
+
+        if (++player->blink >= segment->count) {
+            player->blink = 0;
+            if (++player->segment >= player->pattern->segment_count) {
+                held |= player->pattern->hold;
+                player->pattern = NULL;
+                break;
+            }
+            segment = &player->pattern->segments[player->segment];
+        }
+        player->on = true;
+        player->until_us += segment->on_ms * 1000ULL;
+    }
+
+    if (!player->pattern || !player->on) {
+        return 0;
+    }
+    return player->pattern->segments[player->segment].outputs;
+}
+
+static bool take_request(int request) {
+    uint32_t count = requested[request];
+    if (count == served[request]) {
+        return false;
+    }
+    served[request] = count;
+    return true;
+}
+
+
+/* ========================================================================= */
+/* TICK                                                                      */
+/* ========================================================================= */
+
+void alert_tick(uint64_t now_us) {
+    if (take_request(REQUEST_CLEAR)) {
+        alert_player.pattern = NULL;
+        held = 0;
+    }
+
+    // Highest pending level; lower ones are dropped with it
+    int level = -1;
+    for (int i = DETECTION_LEVEL_COUNT - 1; i > DETECTION_NONE; i--) {
+        if (take_request(i) && level < 0) {
+            level = i;
+        }
+    }
+    if (level >= 0 && (!alert_player.pattern || level >= alert_player.level)) {
+        player_start(&alert_player, &level_patterns[level], level, now_us);
+    }
+
+    // Both pending: the current setting wins
+    bool silenced_request = take_request(REQUEST_SILENCED);
+    bool enabled_request = take_request(REQUEST_ENABLED);
+    if (silenced_request || enabled_request) {
+        bool silenced = silenced_request && (!enabled_request || buzzer_silenced);
+        player_start(&feedback_player, &feedback_patterns[silenced ? 0 : 1], 0, now_us);
+    }
+
+    uint8_t outputs = held | player_advance(&alert_player, now_us) | player_advance(&feedback_player, now_us);
+    if (buzzer_silenced) {
+        outputs &= (uint8_t)~ALERT_OUT_BUZZER;
+    }
+    alert_playing = alert_player.pattern != NULL;
+
+    if (outputs != driven) {
+        for (int i = 0; i < ALERT_OUTPUT_COUNT; i++) {
+            if ((outputs ^ driven) & (1u << i)) {
+                gpio_put(output_pins[i], (outputs >> i) & 1);
+            }
+        }
+        driven = outputs;
+    }
+}
+
+
+/* ========================================================================= */
+/* APPLICATION API                                                           */
+/* ========================================================================= */
+
+bool alert_init(unsigned int status_pin, unsigned int alert_pin, unsigned int buzzer_pin, unsigned int feedback_pin) {
+    output_pins[0] = status_pin;
+    output_pins[1] = alert_pin;
+    output_pins[2] = buzzer_pin;
+    output_pins[3] = feedback_pin;
+
+    // Before the tick starts, so it can write changes only
+    for (int i = 0; i < ALERT_OUTPUT_COUNT; i++) {
+        gpio_put(output_pins[i], 0);
+    }
+    driven = 0;
+    return alert_backend_start(ALERT_TICK_US);
+}
+
+void alert_play(detection_level_t level) {
+    if (level > DETECTION_NONE && level < DETECTION_LEVEL_COUNT) {
+        requested[level]++;
+    }
+}
+
+void alert_feedback(bool silenced) {
+    requested[silenced ? REQUEST_SILENCED : REQUEST_ENABLED]++;
+}
+
+void alert_set_silenced(bool silenced) {
+    buzzer_silenced = silenced;
+}
+
+void alert_clear(void) {
+    requested[REQUEST_CLEAR]++;
+}
+
+void alert_poll(void) {
+    alert_backend_service();
+}
+
+bool alert_active(void) {
+    if (alert_playing) {
+        return true;
+    }
+    for (int i = DETECTION_NONE + 1; i < DETECTION_LEVEL_COUNT; i++) {
+        if (requested[i] != served[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const alert_pattern_t *alert_pattern(detection_level_t level) {
+    return &level_patterns[level < DETECTION_LEVEL_COUNT ? level : DETECTION_NONE];
+}
+
+uint32_t alert_pattern_ms(const alert_pattern_t *pattern) {
+    uint32_t ms = 0;
+    for (uint8_t i = 0; i < pattern->segment_count; i++) {
+        ms += pattern->segments[i].count * (uint32_t)(pattern->segments[i].on_ms + pattern->segments[i].off_ms);
+    }
+    return ms;
+}
@@ -0,0 +1,131 @@
+/* Alert engine - LED and buzzer patterns without blocking
+ *
+ * Patterns are tables of blink segments (outputs, count, on time, off time)
+ * keyed by detection level, played by a tick that runs from a repeating
+ * timer interrupt on the board. alert_play() only posts a request and
+ * returns, so neither the main loop nor acquisition ever waits for a
+ * pattern to finish.
+ *
+ * A request at the level of the running pattern or above restarts the
+ * player with the new pattern; lower ones are ignored while it runs. A
+ * pattern may leave outputs held on (the alert LED after a critical
+ * event) until alert_clear(). While silenced, the buzzer stays off and
+ * the patterns keep their timing.
+ *
+ * Button feedback (silenced / enabled) has its own player on the feedback
+ * LED and plays alongside the alert patterns.
+ *
+ * The request functions may be called from core 0 at any time; the tick
+ * is the only code that touches the pattern state and the pins.
+ */
+
+#ifndef SEISMIC_ALERT_H
+#define SEISMIC_ALERT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "detection.h"
+
+#define ALERT_TICK_US           5000        // Pattern resolution
+
+// Outputs driven by the engine, see alert_init()
+#define ALERT_OUT_STATUS        0x01
+#define ALERT_OUT_ALERT         0x02
+#define ALERT_OUT_BUZZER        0x04
+#define ALERT_OUT_FEEDBACK      0x08
+#define ALERT_OUTPUT_COUNT      4
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint8_t outputs;            // ALERT_OUT_* on during on_ms
+    uint8_t count;
+    uint16_t on_ms;
+    uint16_t off_ms;
+} alert_segment_t;
+
+typedef struct {
+    const alert_segment_t *segments;
+    uint8_t segment_count;
+    uint8_t hold;               // ALERT_OUT_* left on at the end
+} alert_pattern_t;
+
+
+/* ========================================================================= */
+/* APPLICATION API                                                           */
+/* ========================================================================= */
+
+/**
+ * Pins of the ALERT_OUT_* outputs (set up as outputs by the caller), then
+ * start the tick. Returns false if the timer could not be started.
+ */
+bool alert_init(unsigned int status_pin, unsigned int alert_pin, unsigned int buzzer_pin, unsigned int feedback_pin);
+
+/**
+ * Play the pattern of a detection level (nothing for DETECTION_NONE).
+ */
+void alert_play(detection_level_t level);
+
+/**
+ * Short blink pattern on the feedback LED for the button: one blink when
+ * silenced, three when enabled.
+ */
+void alert_feedback(bool silenced);
+
+/**
+ * Keep the buzzer off (patterns still run on the LEDs).
+ */
+void alert_set_silenced(bool silenced);
+
+/**
+ * Stop the running alert pattern and release held outputs.
+ */
+void alert_clear(void);
+
+/**
+ * Call from the main loop; advances the patterns where there is no timer
+ * interrupt (host). Never blocks.
+ */
+void alert_poll(void);
+
+/**
+ * True while an alert pattern plays (held outputs do not count).
+ */
+bool alert_active(void);
+
+/**
+ * Pattern of a level, and its length in ms without the held outputs.
+ */
+const alert_pattern_t *alert_pattern(detection_level_t level);
+uint32_t alert_pattern_ms(const alert_pattern_t *pattern);
+
+/**
+ * The tick: applies pending requests and sets the outputs for now_us.
+ * Called by the backend every ALERT_TICK_US.
+ */
+void alert_tick(uint64_t now_us);
+
+
+/* ========================================================================= */
+/* PLATFORM BACKEND                                                          */
+/* ========================================================================= */
+
+/**
+ * Call alert_tick() every tick_us. Implemented by alert_rp2350.cpp (repeating
+ * timer interrupt) on the board and host/host_alert.cpp on the host.
+ */
+bool alert_backend_start(uint32_t tick_us);
+
+/**
+ * Called by alert_poll(). Backends without a timer interrupt (host) run the
+ * due ticks here.
+ */
+void alert_backend_service(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SEISMIC_ALERT_H
@@ -0,0 +1,30 @@
+/* Alert engine - RP2350 backend
+ *
+ * The tick runs from a repeating timer on the default alarm pool, whose
+ * interrupt is serviced by core 0 (the pool is created there at boot), so
+ * patterns keep their timing while core 0 is busy with inference.
+ */
+
+#include "pico/stdlib.h"
+#include "alert.h"
+
+static repeating_timer_t alert_timer;
+
+static bool alert_timer_callback(repeating_timer_t *timer) {
+    (void)timer;
+    alert_tick(time_us_64());
+    return true;
+}
+
+
+/* ========================================================================= */
+/* BACKEND                                                                   */
+/* ========================================================================= */
+
+bool alert_backend_start(uint32_t tick_us) {
+    // Negative delay: tick_us between the starts of consecutive callbacks
+    return add_repeating_timer_us(-(int64_t)tick_us, alert_timer_callback, NULL, &alert_timer);
+}
+
+void alert_backend_service(void) {
+}
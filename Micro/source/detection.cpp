@@ -0,0 +1,27 @@
+/* Detection policy - see detection.h */
+
+#include <string.h>
+#include "detection.h"
+
+detection_level_t detection_level(const char *label, float confidence) {
+    if (strcmp(label, DETECTION_NOISE_LABEL) == 0) {
+        return DETECTION_NONE;
+    }
+    if (confidence >= DETECTION_CRITICAL_CONFIDENCE) {
+        return DETECTION_CRITICAL;
+    }
+    if (confidence >= DETECTION_HIGH_CONFIDENCE) {
+        return DETECTION_HIGH;
+    }
+    return DETECTION_LOW;
+}
+
+const char *detection_level_name(detection_level_t level) {
+    switch (level) {
+        case DETECTION_NONE:     return "none";
+        case DETECTION_LOW:      return "low";
+        case DETECTION_HIGH:     return "high";
+        case DETECTION_CRITICAL: return "critical";
+        default:                 return "?";
+    }
+}
@@ -0,0 +1,45 @@
+/* Detection policy - inference result to alert level
+ *
+ * Shared by main.cpp (process_inference_result) and the host replay tool so
+ * both grade a window the same way: the noise class is no detection, any
+ * other class is an event whose alert level follows its confidence.
+ */
+
+#ifndef SEISMIC_DETECTION_H
+#define SEISMIC_DETECTION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define DETECTION_NOISE_LABEL           "noise"
+#define DETECTION_HIGH_CONFIDENCE       0.85f
+#define DETECTION_CRITICAL_CONFIDENCE   0.95f
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    DETECTION_NONE = 0,         // Noise
+    DETECTION_LOW,
+    DETECTION_HIGH,
+    DETECTION_CRITICAL,
+    DETECTION_LEVEL_COUNT
+} detection_level_t;
+
+/**
+ * Alert level for the most likely class of a window and its confidence.
+ * label must be one of the impulse's classes, not a failure placeholder.
+ */
+detection_level_t detection_level(const char *label, float confidence);
+
+/**
+ * Short name of a level ("none", "low", "high", "critical").
+ */
+const char *detection_level_name(detection_level_t level);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SEISMIC_DETECTION_H
@@ -4,12 +4,16 @@
  * - SM-24 Geophone analog signal acquisition via ADC
  * - Edge Impulse CNN-LSTM inference for seismic classification
  * - Real-time event detection and alerting
- * - Serial output for monitoring
+ * - Serial output for monitoring (text reports and/or binary telemetry)
  * - LED and buzzer alerts
  * 
  * Hardware: Raspberry Pi Pico 2 (RP2350A)
  * Sensor: SM-24 Geophone (analog output)
- * No RTOS - Simple main loop architecture
+ * No RTOS - one loop per core:
+ *   core 1: acquisition, conversion, sample ring, window handoff
+ *   core 0: DSP + inference, alerts, status, button
+ * Completed windows are handed over as ring positions through the SIO FIFO;
+ * the samples themselves stay in the lock-free sample ring.
  */
 
 #include <stdio.h>
@@ -17,9 +21,16 @@
 #include <stdlib.h>
 #include <math.h>
 #include "pico/stdlib.h"
+#include "pico/multicore.h"
 #include "hardware/adc.h"
 #include "hardware/gpio.h"
 #include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "acquisition.h"
+#include "alert.h"
+#include "detection.h"
+#include "sample_ring.h"
+#include "telemetry.h"
+#include "trigger.h"
 typedef unsigned short uint16_t;
 typedef unsigned char uint8_t;
 
@@ -30,7 +41,7 @@ typedef unsigned char uint8_t;
 // SM-24 Geophone ADC Configuration
 #define SM24_ADC_CHANNEL    0           // ADC0 = GPIO 26
 #define SM24_ADC_PIN        26          // GPIO 26 for analog input
-#define ADC_SAMPLES         64          // Averaging samples for noise reduction
+#define ADC_SAMPLES         64          // Oversampling factor, averaged per sample
 #define ADC_VREF            3.3f        // ADC reference voltage
 
 // SM-24 Geophone Specifications
@@ -39,6 +50,17 @@ typedef unsigned char uint8_t;
 #define SM24_FREQ_MIN_HZ        10      // Minimum frequency: 10 Hz
 #define SM24_FREQ_MAX_HZ        240     // Maximum frequency: 240 Hz
 
+// Model input scale. The impulse (and its standard scaler) was trained on
+// STEAD traces in digitizer counts, 10 - 1e5 for noise to local events;
+// in m/s the features sit at the scaler's means and every window scores
+// the same. The window is multiplied by this on its way into the impulse,
+// the ring and telemetry stay in m/s. Set with -DSEISMIC_COUNTS_PER_M_S.
+#ifdef SEISMIC_COUNTS_PER_M_S
+#define MODEL_COUNTS_PER_M_S    ((float)(SEISMIC_COUNTS_PER_M_S))
+#else
+#define MODEL_COUNTS_PER_M_S    1e8f    // 1e-7 - 1e-3 m/s onto 10 - 1e5 counts
+#endif
+
 // Pin Definitions
 #define LED_BUILTIN         25          // Built-in LED
 #define LED_STATUS          15          // External status LED
@@ -46,10 +68,63 @@ typedef unsigned char uint8_t;
 #define BUZZER_PIN          16          // Buzzer for audio alerts
 #define BUTTON_PIN          17          // User button for silence/reset
 
-// Sampling Configuration
-#define SAMPLE_RATE_HZ      100         // 100 Hz sampling rate
-#define SAMPLE_PERIOD_MS    10          // 10ms between samples
-#define WINDOW_SIZE         256         // Sample window for inference
+// Sampling Configuration, from the impulse (model-parameters/model_metadata.h)
+#define SAMPLE_RATE_HZ      EI_CLASSIFIER_FREQUENCY             // 100 Hz sampling rate
+#define SAMPLE_PERIOD_MS    EI_CLASSIFIER_INTERVAL_MS           // 10ms between samples
+#define WINDOW_SIZE         EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE  // Sample window for inference
+
+// New samples between windows; less than WINDOW_SIZE gives overlapping
+// windows. Set with -DSEISMIC_INFERENCE_STRIDE=<samples> (CMake cache).
+#ifdef SEISMIC_INFERENCE_STRIDE
+#define INFERENCE_STRIDE    SEISMIC_INFERENCE_STRIDE
+#else
+#define INFERENCE_STRIDE    EI_CLASSIFIER_SLICE_SIZE            // 4 windows per model window
+#endif
+
+// STA/LTA trigger on core 1 (-DSEISMIC_TRIGGER, CMake option): a window
+// TRIGGER_ONSET_LEAD_S after every onset, then every INFERENCE_STRIDE
+// samples while triggered and for one window length after, otherwise a
+// heartbeat window every TRIGGER_HEARTBEAT_S. Off: a window every
+// INFERENCE_STRIDE samples.
+// Settings in trigger.h.
+#define TRIGGER_STA_SAMPLES     ((int)(TRIGGER_STA_S * SAMPLE_RATE_HZ))
+#define TRIGGER_LTA_SAMPLES     ((int)(TRIGGER_LTA_S * SAMPLE_RATE_HZ))
+#define TRIGGER_HEARTBEAT       ((int)(TRIGGER_HEARTBEAT_S * SAMPLE_RATE_HZ))
+#define TRIGGER_ONSET_LEAD      ((int)(TRIGGER_ONSET_LEAD_S * SAMPLE_RATE_HZ))
+
+// Optional high pass against geophone offset and drift, run on core 1 as the
+// samples arrive (state kept across windows). Off unless built with
+// -DSEISMIC_HIGHPASS_HZ=<Hz>: the deployed impulse was trained unfiltered.
+#define HIGHPASS_ORDER      2
+
+#define RING_SLACK          64          // Samples that may arrive during one inference
+// Core 0 may pick up a window up to one stride late (busy with alerts)
+#define RING_CAPACITY       (WINDOW_SIZE + INFERENCE_STRIDE + RING_SLACK)
+
+static_assert(EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME == 1, "The geophone provides one axis");
+static_assert(INFERENCE_STRIDE > 0 && INFERENCE_STRIDE <= WINDOW_SIZE,
+              "INFERENCE_STRIDE must be between 1 and WINDOW_SIZE samples");
+static_assert(TRIGGER_STA_SAMPLES < TRIGGER_LTA_SAMPLES && TRIGGER_HEARTBEAT >= INFERENCE_STRIDE,
+              "STA shorter than LTA, heartbeat no faster than the stride");
+static_assert(TRIGGER_ONSET_LEAD >= 0 && TRIGGER_ONSET_LEAD < WINDOW_SIZE,
+              "The onset window must still hold the onset");
+
+// Serial output. Text reports (SEISMIC_TEXT_OUTPUT, on unless built with
+// -DSEISMIC_TEXT_OUTPUT=0) and binary telemetry frames (-DSEISMIC_TELEMETRY,
+// see telemetry.h) share the USB CDC port; a frame cut by text printed in
+// the middle of it is dropped by the decoder, so use one or the other.
+#ifndef SEISMIC_TEXT_OUTPUT
+#define SEISMIC_TEXT_OUTPUT 1
+#endif
+#if SEISMIC_TEXT_OUTPUT
+#define text_printf(...)    printf(__VA_ARGS__)
+#else
+#define text_printf(...)    ((void)0)
+#endif
+
+#ifdef SEISMIC_TELEMETRY
+static_assert(EI_CLASSIFIER_NN_INPUT_FRAME_SIZE <= TELEMETRY_MAX_VALUES, "Features must fit in one frame");
+#endif
 
 
 
@@ -67,28 +142,47 @@ typedef struct {
 
 typedef struct {
     char label[64];
+    int label_index;            // -1 without a classification
     float confidence;
     uint32_t inference_time_ms;
     uint64_t timestamp_ms;
+    uint32_t window_end;        // Ring position one past the newest sample
 } inference_result_t;
 
-typedef struct {
-    float buffer[WINDOW_SIZE];
-    uint16_t index;
-    bool filled;
-} sample_buffer_t;
 
 
 /* ========================================================================= */
 /* GLOBAL VARIABLES                                                          */
 /* ========================================================================= */
 
-static sample_buffer_t geophone_buffer = {0};
+static float geophone_storage[2 * RING_CAPACITY];   // Mirrored, see sample_ring.h
+static sample_ring_t geophone_ring;
+static sample_ring_view_t inference_window;
 static uint32_t total_events = 0;
 static uint32_t high_confidence_events = 0;
 static uint32_t critical_events = 0;
 static bool system_ready = false;
 static bool alert_silenced = false;
+static uint64_t acquisition_start_ms = 0;
+#ifdef SEISMIC_HIGHPASS_HZ
+static ei::spectral::filters::biquad_cascade geophone_highpass;
+#endif
+static volatile uint32_t windows_posted = 0;        // Core 1
+static volatile uint32_t windows_dropped = 0;       // Core 1, FIFO full
+#ifdef SEISMIC_TRIGGER
+static trigger_t window_trigger;                    // Core 1
+static volatile uint32_t windows_onset = 0;         // Core 1, by reason
+static volatile uint32_t windows_heartbeat = 0;
+#endif
+static uint32_t windows_processed = 0;              // Core 0
+static uint32_t windows_skipped = 0;                // Core 0, superseded
+static uint32_t windows_overrun = 0;                // Core 0, lapped during inference
+#ifdef SEISMIC_TELEMETRY
+static float window_features[EI_CLASSIFIER_NN_INPUT_FRAME_SIZE];    // Core 0
+static size_t window_feature_count = 0;
+static uint32_t samples_sent_end = 0;               // Core 0, one past the last sent sample
+static bool samples_sent = false;
+#endif
 
 
 /* ========================================================================= */
@@ -105,9 +199,9 @@ void adc_init_sm24(void) {
     // Select ADC channel
     adc_select_input(SM24_ADC_CHANNEL);
 
-    printf("[ADC] SM-24 Geophone initialized on GPIO %d\n", SM24_ADC_PIN);
-    printf("[ADC] Sensitivity: %.2f V/m/s\n", SM24_SENSITIVITY_V_MS);
-    printf("[ADC] Frequency range: %d - %d Hz\n", SM24_FREQ_MIN_HZ, SM24_FREQ_MAX_HZ);
+    text_printf("[ADC] SM-24 Geophone initialized on GPIO %d\n", SM24_ADC_PIN);
+    text_printf("[ADC] Sensitivity: %.2f V/m/s\n", SM24_SENSITIVITY_V_MS);
+    text_printf("[ADC] Frequency range: %d - %d Hz\n", SM24_FREQ_MIN_HZ, SM24_FREQ_MAX_HZ);
 }
 
 void gpio_init_all(void) {
@@ -134,7 +228,7 @@ void gpio_init_all(void) {
     gpio_set_dir(BUTTON_PIN, GPIO_IN);
     gpio_pull_up(BUTTON_PIN);
 
-    printf("[GPIO] All pins initialized\n");
+    text_printf("[GPIO] All pins initialized\n");
 }
 
 
@@ -142,6 +236,8 @@ void gpio_init_all(void) {
 /* LED & BUZZER CONTROL                                                      */
 /* ========================================================================= */
 
+// Blocking; boot sequence only. Alerts and button feedback are played by the
+// alert engine (alert.h) without stopping the main loop.
 void led_blink(uint8_t pin, int count, int duration_ms) {
     for (int i = 0; i < count; i++) {
         gpio_put(pin, 1);
@@ -151,47 +247,11 @@ void led_blink(uint8_t pin, int count, int duration_ms) {
     }
 }
 
-void buzzer_beep(int count, int duration_ms) {
-    if (alert_silenced) return;
-
-    for (int i = 0; i < count; i++) {
-        gpio_put(BUZZER_PIN, 1);
-        sleep_ms(duration_ms);
-        gpio_put(BUZZER_PIN, 0);
-        sleep_ms(duration_ms);
-    }
-}
-
-void alert_low_confidence(void) {
-    led_blink(LED_STATUS, 2, 200);
-}
-
-void alert_high_confidence(void) {
-    led_blink(LED_ALERT, 5, 100);
-    buzzer_beep(3, 150);
-}
-
-void alert_critical(void) {
-    led_blink(LED_ALERT, 10, 50);
-    buzzer_beep(5, 100);
-    gpio_put(LED_ALERT, 1);  // Keep alert LED on
-}
-
 
 /* ========================================================================= */
 /* SM-24 GEOPHONE DATA ACQUISITION                                          */
 /* ========================================================================= */
 
-uint32_t read_adc_averaged(void) {
-    uint32_t sum = 0;
-
-    for (int i = 0; i < ADC_SAMPLES; i++) {
-        sum += adc_read();
-    }
-
-    return sum / ADC_SAMPLES;
-}
-
 float adc_to_voltage(uint32_t adc_value) {
     // RP2350 ADC is 12-bit (0-4095)
     return (adc_value * ADC_VREF) / 4095.0f;
@@ -205,9 +265,9 @@ float voltage_to_velocity_ms(float voltage) {
     return v_signal / SM24_SENSITIVITY_V_MS;
 }
 
-void acquire_geophone_sample(geophone_sample_t *sample) {
-    // Read ADC with averaging
-    uint32_t adc_raw = read_adc_averaged();
+void convert_geophone_sample(uint32_t adc_raw, uint64_t sample_index, geophone_sample_t *sample) {
+    // adc_raw is already averaged over ADC_SAMPLES conversions by the
+    // acquisition block kernel
 
     // Convert to voltage
     float voltage = adc_to_voltage(adc_raw);
@@ -220,17 +280,16 @@ void acquire_geophone_sample(geophone_sample_t *sample) {
     sample->raw_voltage = voltage;
     sample->velocity_m_s = velocity_m_s;
     sample->velocity_mm_s = velocity_m_s * 1000.0f;
-    sample->timestamp_ms = to_ms_since_boot(get_absolute_time());
+    // Samples are evenly spaced by the ADC clock, so the index gives the time
+    sample->timestamp_ms = acquisition_start_ms + sample_index * 1000 / SAMPLE_RATE_HZ;
 }
 
 void buffer_add_sample(float value) {
-    geophone_buffer.buffer[geophone_buffer.index] = value;
-    geophone_buffer.index++;
+    sample_ring_push(&geophone_ring, value);
+}
 
-    if (geophone_buffer.index >= WINDOW_SIZE) {
-        geophone_buffer.index = 0;
-        geophone_buffer.filled = true;
-    }
+bool buffer_ready(void) {
+    return sample_ring_count(&geophone_ring) >= WINDOW_SIZE;
 }
 
 
@@ -240,38 +299,61 @@ void buffer_add_sample(float value) {
 
 #include "edge-impulse-sdk/classifier/ei_run_classifier.h"
 
-// REQUIRED: Converts buffered samples to Edge Impulse input format
-static int get_window_data(size_t offset, size_t length, float *out_ptr) {
-    for (size_t i = 0; i < length; i++) {
-        size_t index = offset + i;
-        if (index < WINDOW_SIZE)
-            out_ptr[i] = geophone_buffer.buffer[index];
-        else 
-            out_ptr[i] = 0; // padding should never happen but safe
+#ifdef SEISMIC_TELEMETRY
+// ei_set_features_observer() callback: the feature matrix is freed when
+// run_classifier() returns, keep a copy for the FEATURES frame
+static void copy_window_features(const float *features, size_t count, void *ctx) {
+    (void)ctx;
+    if (count > EI_CLASSIFIER_NN_INPUT_FRAME_SIZE - window_feature_count) {
+        count = EI_CLASSIFIER_NN_INPUT_FRAME_SIZE - window_feature_count;
     }
-    return 0;
+    memcpy(window_features + window_feature_count, features, count * sizeof(float));
+    window_feature_count += count;
 }
+#endif
+
+void run_inference(uint32_t window_end, inference_result_t *result) {
+    result->label_index = -1;
+    result->window_end = window_end;
 
-void run_inference(inference_result_t *result) {
-    if (!geophone_buffer.filled) {
+    if (!sample_ring_window_ending(&geophone_ring, window_end, WINDOW_SIZE, &inference_window)) {
         strcpy(result->label, "insufficient_data");
         result->confidence = 0.0f;
         result->inference_time_ms = 0;
         return;
     }
 
-    signal_t signal;
-    signal.total_length = WINDOW_SIZE;
-    signal.get_data = get_window_data;
+    // inference_window is a contiguous, oldest-first view into the ring, so
+    // the DSP block reads the window with a single memcpy, scaled to counts
+    SignalWithSpans window_signal(inference_window.samples, inference_window.length, nullptr, 0,
+                                  MODEL_COUNTS_PER_M_S);
 
     ei_impulse_result_t ei_result = {0};
 
-    uint32_t start_time = to_ms_since_boot(get_absolute_time());
-    EI_IMPULSE_ERROR resp = run_classifier(&signal, &ei_result, false);
-    uint32_t end_time = to_ms_since_boot(get_absolute_time());
-
-    result->inference_time_ms = end_time - start_time;
-    result->timestamp_ms      = end_time;
+#ifdef SEISMIC_TELEMETRY
+    window_feature_count = 0;
+#endif
+    uint64_t start_us = time_us_64();
+    EI_IMPULSE_ERROR resp = run_classifier(window_signal.get_signal(), &ei_result, false);
+    uint64_t end_us = time_us_64();
+
+#ifdef SEISMIC_PROFILE
+    // Stage timings of this window, then start over for the next one
+    printf("\n[Profile]\n");
+    ei_profiler_dump_csv();
+    ei_profiler_clear();
+#endif
+
+    result->inference_time_ms = (uint32_t)((end_us - start_us) / 1000);
+    result->timestamp_ms      = end_us / 1000;
+
+    // The producer kept going during inference; make sure it did not lap us
+    if (!sample_ring_view_valid(&geophone_ring, &inference_window)) {
+        strcpy(result->label, "window_overrun");
+        result->confidence = 0;
+        windows_overrun++;
+        return;
+    }
 
     if (resp != EI_IMPULSE_OK) {
         strcpy(result->label, "model_error");
@@ -291,17 +373,42 @@ void run_inference(inference_result_t *result) {
     }
 
     strcpy(result->label, ei_result.classification[best_index].label);
+    result->label_index = best_index;
     result->confidence = best_score;
 
+#ifdef SEISMIC_TELEMETRY
+    // The samples not sent with an earlier window (skipped windows and the
+    // trigger's onsets and heartbeats are not a stride apart), at most this
+    // window, so the SAMPLES ends only jump where no window covered the
+    // samples. Then what the impulse made of the whole window
+    float scores[EI_CLASSIFIER_LABEL_COUNT];
+    for (int i = 0; i < EI_CLASSIFIER_LABEL_COUNT; i++) {
+        scores[i] = ei_result.classification[i].value;
+    }
+    uint32_t new_samples = WINDOW_SIZE;
+    if (samples_sent) {
+        uint32_t unsent = sample_ring_distance(&geophone_ring, samples_sent_end, window_end);
+        new_samples = unsent < WINDOW_SIZE ? unsent : WINDOW_SIZE;
+    }
+    telemetry_send_samples(window_end, geophone_ring.wrap,
+                           inference_window.samples + (WINDOW_SIZE - new_samples), (uint16_t)new_samples);
+    samples_sent_end = window_end;
+    samples_sent = true;
+    telemetry_send_features(window_end, window_features, (uint16_t)window_feature_count);
+    telemetry_send_scores(window_end, scores, EI_CLASSIFIER_LABEL_COUNT, (uint8_t)best_index);
+    telemetry_send_timing(window_end, (uint32_t)ei_result.timing.dsp_us,
+                          (uint32_t)ei_result.timing.classification_us, (uint32_t)(end_us - start_us));
+#endif
+
     /* Print raw classification results */
-    printf("\n[Inference Results]\n");
+    text_printf("\n[Inference Results]\n");
     for (int i = 0; i < EI_CLASSIFIER_LABEL_COUNT; i++) {
-        printf("  %s : %.2f%%\n",
+        text_printf("  %s : %.2f%%\n",
             ei_result.classification[i].label,
             ei_result.classification[i].value * 100.0f);
     }
 
-    printf("Best Class = %s (%.2f%%)\n",
+    text_printf("Best Class = %s (%.2f%%)\n",
             result->label, result->confidence * 100.0f);
 }
 
@@ -310,40 +417,50 @@ void run_inference(inference_result_t *result) {
 /* ========================================================================= */
 
 void process_inference_result(const inference_result_t *result) {
+    // No classification (insufficient_data, window_overrun, model_error)
+    if (result->label_index < 0) {
+        return;
+    }
+
     // Skip noise detections
-    if (strcmp(result->label, "noise") == 0) {
+    detection_level_t level = detection_level(result->label, result->confidence);
+    if (level == DETECTION_NONE) {
         return;
     }
 
-    printf("\n╔═══════════════════════════════════════════════╗\n");
-    printf("║     SEISMIC EVENT DETECTED                    ║\n");
-    printf("╚═══════════════════════════════════════════════╝\n");
-    printf("  Event Type: %s\n", result->label);
-    printf("  Confidence: %.2f%%\n", result->confidence * 100.0f);
-    printf("  Inference Time: %u ms\n", result->inference_time_ms);
-    printf("  Timestamp: %llu ms\n", result->timestamp_ms);
+    text_printf("\n╔═══════════════════════════════════════════════╗\n");
+    text_printf("║     SEISMIC EVENT DETECTED                    ║\n");
+    text_printf("╚═══════════════════════════════════════════════╝\n");
+    text_printf("  Event Type: %s\n", result->label);
+    text_printf("  Confidence: %.2f%%\n", result->confidence * 100.0f);
+    text_printf("  Inference Time: %u ms\n", result->inference_time_ms);
+    text_printf("  Timestamp: %llu ms\n", result->timestamp_ms);
 
     total_events++;
 
-    // Determine alert level
-    if (result->confidence >= 0.95f) {
-        printf("\n  *** CRITICAL ALERT - VERY HIGH CONFIDENCE ***\n");
-        alert_critical();
+    // Determine alert level; the pattern plays in the background
+    alert_play(level);
+    if (level == DETECTION_CRITICAL) {
+        text_printf("\n  *** CRITICAL ALERT - VERY HIGH CONFIDENCE ***\n");
         critical_events++;
 
-    } else if (result->confidence >= 0.85f) {
-        printf("\n  *** HIGH CONFIDENCE ALERT ***\n");
-        alert_high_confidence();
+    } else if (level == DETECTION_HIGH) {
+        text_printf("\n  *** HIGH CONFIDENCE ALERT ***\n");
         high_confidence_events++;
 
     } else {
-        printf("\n  [Low confidence detection]\n");
-        alert_low_confidence();
+        text_printf("\n  [Low confidence detection]\n");
     }
 
-    printf("\n  Total Events: %u | High Conf: %u | Critical: %u\n",
+    text_printf("\n  Total Events: %u | High Conf: %u | Critical: %u\n",
            total_events, high_confidence_events, critical_events);
-    printf("═══════════════════════════════════════════════\n\n");
+    text_printf("═══════════════════════════════════════════════\n\n");
+
+#ifdef SEISMIC_TELEMETRY
+    telemetry_send_event(result->window_end, (uint32_t)result->timestamp_ms, (uint8_t)level,
+                         (uint8_t)result->label_index, result->confidence,
+                         total_events, high_confidence_events, critical_events);
+#endif
 }
 
 
@@ -352,17 +469,42 @@ void process_inference_result(const inference_result_t *result) {
 /* ========================================================================= */
 
 void print_system_status(void) {
-    printf("\n┌───────────────────────────────────────────────┐\n");
-    printf("│         SYSTEM STATUS                         │\n");
-    printf("├───────────────────────────────────────────────┤\n");
-    printf("│ Geophone: %s                          │\n", system_ready ? "✓ Active    " : "✗ Inactive  ");
-    printf("│ Buffer: %s                              │\n", geophone_buffer.filled ? "✓ Ready     " : "○ Filling   ");
-    printf("│ Events Detected: %-5u                      │\n", total_events);
-    printf("│ High Confidence: %-5u                      │\n", high_confidence_events);
-    printf("│ Critical Events: %-5u                      │\n", critical_events);
-    printf("│ Alert: %s                               │\n", alert_silenced ? "Silenced    " : "Enabled     ");
-    printf("└───────────────────────────────────────────────┘\n");
+    text_printf("\n┌───────────────────────────────────────────────┐\n");
+    text_printf("│         SYSTEM STATUS                         │\n");
+    text_printf("├───────────────────────────────────────────────┤\n");
+    text_printf("│ Geophone: %s                          │\n", system_ready ? "✓ Active    " : "✗ Inactive  ");
+    text_printf("│ Buffer: %s                              │\n", buffer_ready() ? "✓ Ready     " : "○ Filling   ");
+    text_printf("│ Events Detected: %-5u                      │\n", total_events);
+    text_printf("│ High Confidence: %-5u                      │\n", high_confidence_events);
+    text_printf("│ Critical Events: %-5u                      │\n", critical_events);
+    text_printf("│ Alert: %s                               │\n", alert_silenced ? "Silenced    " : "Enabled     ");
+    text_printf("│ ADC Overruns: %-5u                         │\n", acquisition_overruns());
+    text_printf("│ Windows: %-5u run, %-5u dropped           │\n",
+           windows_processed, windows_dropped + windows_skipped);
+    text_printf("│ Window Overruns: %-5u                      │\n", windows_overrun);
+#ifdef SEISMIC_TRIGGER
+    text_printf("│ Trigger: %-5u onsets, %-5u heartbeats     │\n",
+           windows_onset, windows_heartbeat);
+#endif
+    text_printf("└───────────────────────────────────────────────┘\n");
+}
+
+#ifdef SEISMIC_TELEMETRY
+// HELLO goes out with every STATUS so a decoder attached after boot still
+// learns the labels
+void send_telemetry_status(uint32_t now) {
+    telemetry_status_t status;
+    status.uptime_ms = now;
+    status.windows_run = windows_processed;
+    status.windows_dropped = windows_dropped + windows_skipped;
+    status.adc_overruns = acquisition_overruns();
+    status.flags = (system_ready ? TELEMETRY_STATUS_READY : 0) | (alert_silenced ? TELEMETRY_STATUS_SILENCED : 0);
+
+    telemetry_send_hello(SAMPLE_RATE_HZ, WINDOW_SIZE, INFERENCE_STRIDE, geophone_ring.wrap,
+                         ei_classifier_inferencing_categories, EI_CLASSIFIER_LABEL_COUNT);
+    telemetry_send_status(&status);
 }
+#endif
 
 void check_button(void) {
     static uint32_t last_press = 0;
@@ -371,16 +513,93 @@ void check_button(void) {
     // Check button with debounce
     if (!gpio_get(BUTTON_PIN) && (now - last_press > 500)) {
         alert_silenced = !alert_silenced;
-        gpio_put(LED_ALERT, 0);  // Turn off alert LED
+        alert_set_silenced(alert_silenced);
+        alert_clear();  // Turn off alert LED
 
-        printf("\n[BUTTON] Alert %s\n", alert_silenced ? "SILENCED" : "ENABLED");
-        led_blink(LED_BUILTIN, alert_silenced ? 1 : 3, 100);
+        text_printf("\n[BUTTON] Alert %s\n", alert_silenced ? "SILENCED" : "ENABLED");
+        alert_feedback(alert_silenced);
 
         last_press = now;
     }
 }
 
 
+/* ========================================================================= */
+/* CORE 1 - ACQUISITION                                                      */
+/* ========================================================================= */
+
+// Owns the ADC, the DMA interrupt and the producer side of the sample ring.
+// Never waits on core 0: a window that does not fit into the FIFO is counted
+// and dropped, acquisition carries on.
+void core1_acquisition_main(void) {
+    geophone_sample_t current_sample;
+    uint16_t block_codes[ACQ_BLOCK_CODES];
+    uint64_t first_index = 0;
+#ifdef SEISMIC_TRIGGER
+    trigger_init(&window_trigger, TRIGGER_STA_SAMPLES, TRIGGER_LTA_SAMPLES, TRIGGER_ON_RATIO, TRIGGER_OFF_RATIO,
+                 INFERENCE_STRIDE, TRIGGER_HEARTBEAT, WINDOW_SIZE, TRIGGER_ONSET_LEAD);
+#else
+    uint32_t since_window = 0;
+#endif
+
+#ifdef SEISMIC_HIGHPASS_HZ
+    if (geophone_highpass.design_butterworth(true, HIGHPASS_ORDER, SAMPLE_RATE_HZ, SEISMIC_HIGHPASS_HZ) != 0) {
+        printf("[DSP] ERROR: invalid high pass at %.2f Hz\n", (double)SEISMIC_HIGHPASS_HZ);
+    } else {
+        text_printf("[DSP] High pass at %.2f Hz, order %d\n", (double)SEISMIC_HIGHPASS_HZ, HIGHPASS_ORDER);
+    }
+#endif
+
+    // Started here so the DMA interrupt is serviced by this core
+    acquisition_start_ms = to_ms_since_boot(get_absolute_time());
+    if (!acquisition_start(SAMPLE_RATE_HZ, ADC_SAMPLES)) {
+        printf("[ADC] ERROR: acquisition could not be started\n");
+    }
+
+    while (1) {
+        // The ADC free-runs at SAMPLE_RATE_HZ x ADC_SAMPLES into DMA blocks,
+        // average and buffer every block completed since last pass
+        size_t count;
+        while ((count = acquisition_poll(block_codes, ACQ_BLOCK_CODES, &first_index)) > 0) {
+            for (size_t i = 0; i < count; i++) {
+                convert_geophone_sample(block_codes[i], first_index + i, &current_sample);
+#ifdef SEISMIC_HIGHPASS_HZ
+                float value = geophone_highpass.process(current_sample.velocity_m_s);
+#else
+                float value = current_sample.velocity_m_s;
+#endif
+                buffer_add_sample(value);
+
+#ifdef SEISMIC_TRIGGER
+                // Post the end of the window at onsets, every INFERENCE_STRIDE
+                // samples around events, every TRIGGER_HEARTBEAT otherwise
+                trigger_window_t window = trigger_push(&window_trigger, value, buffer_ready());
+                bool post = window != TRIGGER_WINDOW_NONE;
+                windows_onset += window == TRIGGER_WINDOW_ONSET;
+                windows_heartbeat += window == TRIGGER_WINDOW_HEARTBEAT;
+#else
+                // Post the end of every INFERENCE_STRIDE-th full window
+                bool post = ++since_window >= INFERENCE_STRIDE && buffer_ready();
+                if (post) {
+                    since_window = 0;
+                }
+#endif
+                if (post) {
+                    if (multicore_fifo_wready()) {
+                        multicore_fifo_push_blocking(sample_ring_head(&geophone_ring));
+                        windows_posted++;
+                    } else {
+                        windows_dropped++;
+                    }
+                }
+            }
+        }
+
+        sleep_ms(1);
+    }
+}
+
+
 /* ========================================================================= */
 /* MAIN APPLICATION                                                         */
 /* ========================================================================= */
@@ -390,62 +609,88 @@ int main(void) {
     stdio_init_all();
     sleep_ms(2000);  // Wait for USB serial
 
-    printf("\n\n");
-    printf("╔═══════════════════════════════════════════════════════╗\n");
-    printf("║                                                       ║\n");
-    printf("║    Raspberry Pi Pico 2 (RP2350A)                     ║\n");
-    printf("║    Standalone Seismic Detection System               ║\n");
-    printf("║    with SM-24 Geophone & Edge Impulse                ║\n");
-    printf("║                                                       ║\n");
-    printf("╚═══════════════════════════════════════════════════════╝\n");
-    printf("\n");
+    text_printf("\n\n");
+    text_printf("╔═══════════════════════════════════════════════════════╗\n");
+    text_printf("║                                                       ║\n");
+    text_printf("║    Raspberry Pi Pico 2 (RP2350A)                     ║\n");
+    text_printf("║    Standalone Seismic Detection System               ║\n");
+    text_printf("║    with SM-24 Geophone & Edge Impulse                ║\n");
+    text_printf("║                                                       ║\n");
+    text_printf("╚═══════════════════════════════════════════════════════╝\n");
+    text_printf("\n");
 
     // Initialize hardware
-    printf("[System] Initializing hardware...\n");
+    text_printf("[System] Initializing hardware...\n");
     gpio_init_all();
     adc_init_sm24();
 
-    printf("[System] Hardware initialization complete\n");
+    sample_ring_init(&geophone_ring, geophone_storage, RING_CAPACITY);
+
+    text_printf("[System] Hardware initialization complete\n");
     led_blink(LED_BUILTIN, 3, 200);  // Startup blink pattern
 
-    printf("\n[System] Starting data acquisition...\n");
-    printf("[System] Sample Rate: %d Hz\n", SAMPLE_RATE_HZ);
-    printf("[System] Window Size: %d samples\n", WINDOW_SIZE);
-    printf("\n[System] Waiting for buffer to fill...\n");
+    text_printf("\n[System] Starting data acquisition...\n");
+    text_printf("[System] Sample Rate: %d Hz\n", SAMPLE_RATE_HZ);
+    text_printf("[System] Window Size: %d samples\n", WINDOW_SIZE);
+    text_printf("[System] Inference Stride: %d samples (every %d ms)\n",
+           INFERENCE_STRIDE, (int)(INFERENCE_STRIDE * SAMPLE_PERIOD_MS));
+#ifdef SEISMIC_TRIGGER
+    text_printf("[System] STA/LTA trigger: %d / %d samples, on %.1f, off %.1f, onset lead %d ms, heartbeat every %d ms\n",
+           TRIGGER_STA_SAMPLES, TRIGGER_LTA_SAMPLES, (double)TRIGGER_ON_RATIO, (double)TRIGGER_OFF_RATIO,
+           (int)(TRIGGER_ONSET_LEAD * SAMPLE_PERIOD_MS), (int)(TRIGGER_HEARTBEAT * SAMPLE_PERIOD_MS));
+#endif
+    text_printf("\n[System] Waiting for buffer to fill...\n");
+
+    // Start free-running acquisition last, on core 1, so the boot sequence
+    // above does not count as missed blocks
+    multicore_fifo_drain();
+    multicore_launch_core1(core1_acquisition_main);
+
+    // Alert patterns run from a timer on core 0, see alert.h
+    if (!alert_init(LED_STATUS, LED_ALERT, BUZZER_PIN, LED_BUILTIN)) {
+        printf("[GPIO] ERROR: alert timer could not be started\n");
+    }
 
     system_ready = true;
+#ifdef SEISMIC_TELEMETRY
+    telemetry_init();
+    ei_set_features_observer(copy_window_features, NULL);
+    send_telemetry_status(to_ms_since_boot(get_absolute_time()));
+#endif
+#ifdef SEISMIC_PROFILE
+    ei_profiler_set_active(true);
+#endif
 
-    uint32_t last_sample_time = 0;
-    uint32_t last_inference_time = 0;
     uint32_t last_status_time = 0;
     uint32_t heartbeat_counter = 0;
 
-    geophone_sample_t current_sample;
     inference_result_t inference;
 
-    // Main loop
+    // Main loop (core 0): inference and alerts may take as long as they need,
+    // core 1 keeps sampling meanwhile
     while (1) {
         uint32_t now = to_ms_since_boot(get_absolute_time());
 
-        // Data acquisition (every 10ms = 100 Hz)
-        if (now - last_sample_time >= SAMPLE_PERIOD_MS) {
-            acquire_geophone_sample(&current_sample);
-            buffer_add_sample(current_sample.velocity_m_s);
+        // Run inference on the newest posted window; older ones still queued
+        // were overtaken while the previous result was being handled
+        if (multicore_fifo_rvalid()) {
+            uint32_t window_end = multicore_fifo_pop_blocking();
+            while (multicore_fifo_rvalid()) {
+                window_end = multicore_fifo_pop_blocking();
+                windows_skipped++;
+            }
 
-            last_sample_time = now;
-        }
-
-        // Run inference every 2.56 seconds (256 samples at 100 Hz)
-        if (geophone_buffer.filled && (now - last_inference_time >= 2560)) {
-            run_inference(&inference);
+            run_inference(window_end, &inference);
             process_inference_result(&inference);
-
-            last_inference_time = now;
+            windows_processed++;
         }
 
         // Print system status every 30 seconds
         if (now - last_status_time >= 30000) {
             print_system_status();
+#ifdef SEISMIC_TELEMETRY
+            send_telemetry_status(now);
+#endif
             last_status_time = now;
         }
 
@@ -460,6 +705,12 @@ int main(void) {
 
         // Check user button
         check_button();
+        alert_poll();
+
+#ifdef SEISMIC_TELEMETRY
+        // Whatever the port takes right now, the rest on the next pass
+        telemetry_flush();
+#endif
 
         sleep_ms(1);
     }
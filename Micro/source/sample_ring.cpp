@@ -0,0 +1,110 @@
+/* Single-producer / single-consumer sample ring
+ *
+ * See sample_ring.h. The head is the only shared variable: the producer
+ * stores it with release semantics after both copies of a sample are
+ * written, the consumer loads it with acquire semantics, so any sample
+ * below the head it sees is complete. On the Cortex-M33 these compile to
+ * STL/LDA, on the host to plain moves with compiler barriers.
+ */
+
+#include <string.h>
+#include "sample_ring.h"
+
+static inline uint32_t ring_head(const sample_ring_t *ring) {
+    return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+}
+
+// a - b in ring positions (modulo wrap)
+static inline uint32_t ring_sub(const sample_ring_t *ring, uint32_t a, uint32_t b) {
+    return sample_ring_position_sub(ring->wrap, a, b);
+}
+
+void sample_ring_init(sample_ring_t *ring, float *storage, uint32_t capacity) {
+    ring->data = storage;
+    ring->capacity = capacity;
+    // Wrapping at a multiple of capacity keeps head % capacity continuous
+    ring->wrap = capacity * (UINT32_MAX / capacity);
+    memset(storage, 0, 2 * capacity * sizeof(float));
+    ring->full = false;
+    __atomic_store_n(&ring->head, 0, __ATOMIC_RELEASE);
+}
+
+void sample_ring_push(sample_ring_t *ring, float value) {
+    uint32_t head = ring->head;     // Only the producer writes it
+    uint32_t slot = head % ring->capacity;
+
+    ring->data[slot] = value;
+    ring->data[slot + ring->capacity] = value;
+    if (slot == ring->capacity - 1) {
+        ring->full = true;
+    }
+
+    uint32_t next = head + 1;
+    if (next == ring->wrap) {
+        next = 0;
+    }
+    __atomic_store_n(&ring->head, next, __ATOMIC_RELEASE);
+}
+
+uint32_t sample_ring_count(const sample_ring_t *ring) {
+    uint32_t head = ring_head(ring);
+    // head wraps, full does not; both are published by the release of head
+    return ring->full ? ring->capacity : head;
+}
+
+uint32_t sample_ring_head(const sample_ring_t *ring) {
+    return ring_head(ring);
+}
+
+bool sample_ring_window(const sample_ring_t *ring, uint32_t length, sample_ring_view_t *view) {
+    uint32_t head = ring_head(ring);
+    uint32_t count = ring->full ? ring->capacity : head;
+
+    if (length == 0 || length > count) {
+        return false;
+    }
+
+    uint32_t first = ring_sub(ring, head, length);
+    view->samples = ring->data + (first % ring->capacity);
+    view->length = length;
+    view->first = first;
+    return true;
+}
+
+bool sample_ring_window_ending(const sample_ring_t *ring, uint32_t end, uint32_t length,
+                               sample_ring_view_t *view) {
+    uint32_t head = ring_head(ring);
+    uint32_t count = ring->full ? ring->capacity : head;
+    uint32_t behind = ring_sub(ring, head, end);
+
+    // The oldest sample must also pass sample_ring_view_valid()
+    if (length == 0 || behind >= ring->capacity ||
+        behind + length >= ring->capacity || behind + length > count) {
+        return false;
+    }
+
+    uint32_t first = ring_sub(ring, end, length);
+    view->samples = ring->data + (first % ring->capacity);
+    view->length = length;
+    view->first = first;
+    return true;
+}
+
+bool sample_ring_view_valid(const sample_ring_t *ring, const sample_ring_view_t *view) {
+    // Sample `first` is overwritten by sample first + capacity, which may be in
+    // the middle of being written as soon as head reaches it
+    return ring_sub(ring, ring_head(ring), view->first) < ring->capacity;
+}
+
+uint32_t sample_ring_distance(const sample_ring_t *ring, uint32_t from, uint32_t to) {
+    return ring_sub(ring, to, from);
+}
+
+int sample_ring_view_get_data(const sample_ring_view_t *view, size_t offset, size_t length, float *out_ptr) {
+    if (offset + length > view->length) {
+        return -1;
+    }
+
+    memcpy(out_ptr, view->samples + offset, length * sizeof(float));
+    return 0;
+}
@@ -0,0 +1,107 @@
+/* Single-producer / single-consumer sample ring
+ *
+ * Holds the most recent geophone samples for inference. Every sample is
+ * stored twice, at slot i and at slot i + capacity (a mirrored buffer), so
+ * the latest N samples are always one contiguous, chronological span: the
+ * consumer reads a window through a pointer instead of unwrapping the ring.
+ *
+ * The producer (main loop, DMA interrupt or the other core) only writes
+ * samples and then publishes the new head; the consumer only reads. No lock
+ * is needed. A window stays intact until the producer has written
+ * capacity - length more samples, so capacity should exceed the window by
+ * the number of samples that can arrive while one inference runs; the
+ * consumer can confirm afterwards with sample_ring_view_valid().
+ */
+
+#ifndef SEISMIC_SAMPLE_RING_H
+#define SEISMIC_SAMPLE_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    float *data;                // 2 x capacity floats, second half mirrors the first
+    uint32_t capacity;
+    uint32_t head;              // Position of the next sample, producer only
+    uint32_t wrap;              // head wraps here, a multiple of capacity
+    bool full;                  // Sticky once capacity samples were written
+} sample_ring_t;
+
+typedef struct {
+    const float *samples;       // length samples, oldest first
+    uint32_t length;
+    uint32_t first;             // Ring position of samples[0]
+} sample_ring_view_t;
+
+/**
+ * storage must hold 2 x capacity floats.
+ */
+void sample_ring_init(sample_ring_t *ring, float *storage, uint32_t capacity);
+
+/**
+ * Producer: append one sample and publish it.
+ */
+void sample_ring_push(sample_ring_t *ring, float value);
+
+/**
+ * Number of samples available, at most capacity.
+ */
+uint32_t sample_ring_count(const sample_ring_t *ring);
+
+/**
+ * Ring position one past the newest sample. Safe from either side; the
+ * producer can hand it to the consumer to mark the end of a window.
+ */
+uint32_t sample_ring_head(const sample_ring_t *ring);
+
+/**
+ * Consumer: view of the latest length samples. Returns false if fewer are
+ * available or length exceeds the capacity.
+ */
+bool sample_ring_window(const sample_ring_t *ring, uint32_t length, sample_ring_view_t *view);
+
+/**
+ * Consumer: view of the length samples ending just before ring position end
+ * (from sample_ring_head()). Returns false if they are not all available or
+ * the oldest has already been overwritten.
+ */
+bool sample_ring_window_ending(const sample_ring_t *ring, uint32_t end, uint32_t length,
+                               sample_ring_view_t *view);
+
+/**
+ * Consumer: true if no sample of the view has been overwritten yet. Call
+ * after the data has been used.
+ */
+bool sample_ring_view_valid(const sample_ring_t *ring, const sample_ring_view_t *view);
+
+/**
+ * a - b in ring positions of a ring with the given wrap (sample_ring_t::wrap):
+ * the samples from position b up to position a, or the position b samples
+ * before a. Positions wrap at a multiple of the capacity, not at 2^32, so
+ * plain uint32_t arithmetic is wrong across a wrap.
+ */
+static inline uint32_t sample_ring_position_sub(uint32_t wrap, uint32_t a, uint32_t b) {
+    return a >= b ? a - b : a + (wrap - b);
+}
+
+/**
+ * Samples from ring position from up to ring position to, e.g. between two
+ * window ends.
+ */
+uint32_t sample_ring_distance(const sample_ring_t *ring, uint32_t from, uint32_t to);
+
+/**
+ * signal_t style accessor on a view: a single memcpy of the requested span.
+ */
+int sample_ring_view_get_data(const sample_ring_view_t *view, size_t offset, size_t length, float *out_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SEISMIC_SAMPLE_RING_H
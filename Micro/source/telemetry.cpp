@@ -0,0 +1,241 @@
+/* Binary telemetry - framing and TX ring, see telemetry.h
+ *
+ * The ring is a power-of-two byte buffer with free-running head and tail
+ * counters. A frame is reserved in full before any byte is written, so the
+ * ring only ever holds complete frames and the reader can start at any
+ * frame boundary.
+ */
+
+#include <string.h>
+#include "telemetry.h"
+#include "sample_ring.h"
+
+static_assert((SEISMIC_TELEMETRY_TX_BYTES & (SEISMIC_TELEMETRY_TX_BYTES - 1)) == 0,
+              "SEISMIC_TELEMETRY_TX_BYTES must be a power of two");
+static_assert(TELEMETRY_HEADER_BYTES + TELEMETRY_MAX_PAYLOAD + TELEMETRY_CRC_BYTES <= SEISMIC_TELEMETRY_TX_BYTES,
+              "the TX ring must hold the largest frame");
+
+#define TX_MASK (SEISMIC_TELEMETRY_TX_BYTES - 1)
+
+static uint8_t tx_ring[SEISMIC_TELEMETRY_TX_BYTES];
+static uint32_t tx_head = 0;        // Next byte to write
+static uint32_t tx_tail = 0;        // Next byte to send
+static uint32_t tx_dropped = 0;
+static uint8_t tx_seq = 0;
+
+// Frame being written, between frame_begin() and frame_end()
+static uint32_t frame_pos = 0;
+static uint16_t frame_crc = 0;
+
+
+/* ========================================================================= */
+/* FRAMING                                                                   */
+/* ========================================================================= */
+
+uint16_t telemetry_crc16(uint16_t crc, const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static void ring_put(const uint8_t *data, size_t len) {
+    size_t offset = frame_pos & TX_MASK;
+    size_t first = SEISMIC_TELEMETRY_TX_BYTES - offset;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(tx_ring + offset, data, first);
+    memcpy(tx_ring, data + first, len - first);
+    frame_pos += (uint32_t)len;
+}
+
+static void frame_put(const void *data, size_t len) {
+    frame_crc = telemetry_crc16(frame_crc, (const uint8_t*)data, len);
+    ring_put((const uint8_t*)data, len);
+}
+
+static void frame_put_u8(uint8_t value) {
+    frame_put(&value, 1);
+}
+
+static void frame_put_u16(uint16_t value) {
+    uint8_t bytes[2] = { (uint8_t)value, (uint8_t)(value >> 8) };
+    frame_put(bytes, 2);
+}
+
+static void frame_put_u32(uint32_t value) {
+    uint8_t bytes[4] = { (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24) };
+    frame_put(bytes, 4);
+}
+
+// Little-endian targets only (Cortex-M33, x86-64 and AArch64 hosts)
+static void frame_put_f32s(const float *values, size_t count) {
+    frame_put(values, count * sizeof(float));
+}
+
+// Reserves the whole frame; false (and counted) if the ring cannot hold it
+static bool frame_begin(telemetry_type_t type, size_t length) {
+    size_t frame_bytes = TELEMETRY_HEADER_BYTES + length + TELEMETRY_CRC_BYTES;
+    if (length > TELEMETRY_MAX_PAYLOAD || frame_bytes > SEISMIC_TELEMETRY_TX_BYTES - (tx_head - tx_tail)) {
+        tx_dropped++;
+        tx_seq++;       // Leaves a gap in the sequence for the decoder
+        return false;
+    }
+
+    const uint8_t sync[2] = { TELEMETRY_SYNC0, TELEMETRY_SYNC1 };
+    frame_pos = tx_head;
+    ring_put(sync, 2);
+    frame_crc = 0xFFFF;
+    frame_put_u8((uint8_t)type);
+    frame_put_u8(tx_seq++);
+    frame_put_u16((uint16_t)length);
+    return true;
+}
+
+static bool frame_end(void) {
+    uint16_t crc = frame_crc;
+    uint8_t bytes[2] = { (uint8_t)crc, (uint8_t)(crc >> 8) };
+    ring_put(bytes, 2);
+    tx_head = frame_pos;
+    return true;
+}
+
+
+/* ========================================================================= */
+/* APPLICATION API                                                           */
+/* ========================================================================= */
+
+void telemetry_init(void) {
+    tx_head = 0;
+    tx_tail = 0;
+    tx_dropped = 0;
+    tx_seq = 0;
+}
+
+bool telemetry_send_hello(uint16_t sample_rate_hz, uint16_t window, uint16_t stride, uint32_t wrap,
+                          const char *const *labels, uint8_t label_count) {
+    size_t length = 13;
+    for (uint8_t i = 0; i < label_count; i++) {
+        length += strlen(labels[i]) + 1;
+    }
+    if (!frame_begin(TELEMETRY_HELLO, length)) {
+        return false;
+    }
+    frame_put_u16(TELEMETRY_VERSION);
+    frame_put_u16(sample_rate_hz);
+    frame_put_u16(window);
+    frame_put_u16(stride);
+    frame_put_u32(wrap);
+    frame_put_u8(label_count);
+    for (uint8_t i = 0; i < label_count; i++) {
+        frame_put(labels[i], strlen(labels[i]) + 1);
+    }
+    return frame_end();
+}
+
+bool telemetry_send_samples(uint32_t end, uint32_t wrap, const float *samples, uint16_t count) {
+    bool sent = true;
+    while (count > 0) {
+        uint16_t n = count < TELEMETRY_MAX_VALUES ? count : (uint16_t)TELEMETRY_MAX_VALUES;
+        if (frame_begin(TELEMETRY_SAMPLES, 6 + n * sizeof(float))) {
+            frame_put_u32(sample_ring_position_sub(wrap, end, count - n));
+            frame_put_u16(n);
+            frame_put_f32s(samples, n);
+            frame_end();
+        } else {
+            sent = false;
+        }
+        samples += n;
+        count -= n;
+    }
+    return sent;
+}
+
+bool telemetry_send_features(uint32_t end, const float *features, uint16_t count) {
+    if (!frame_begin(TELEMETRY_FEATURES, 6 + count * sizeof(float))) {
+        return false;
+    }
+    frame_put_u32(end);
+    frame_put_u16(count);
+    frame_put_f32s(features, count);
+    return frame_end();
+}
+
+bool telemetry_send_scores(uint32_t end, const float *scores, uint8_t count, uint8_t best) {
+    if (!frame_begin(TELEMETRY_SCORES, 6 + count * sizeof(float))) {
+        return false;
+    }
+    frame_put_u32(end);
+    frame_put_u8(count);
+    frame_put_u8(best);
+    frame_put_f32s(scores, count);
+    return frame_end();
+}
+
+bool telemetry_send_timing(uint32_t end, uint32_t dsp_us, uint32_t classification_us, uint32_t total_us) {
+    if (!frame_begin(TELEMETRY_TIMING, 16)) {
+        return false;
+    }
+    frame_put_u32(end);
+    frame_put_u32(dsp_us);
+    frame_put_u32(classification_us);
+    frame_put_u32(total_us);
+    return frame_end();
+}
+
+bool telemetry_send_event(uint32_t end, uint32_t timestamp_ms, uint8_t level, uint8_t label, float confidence,
+                          uint32_t total, uint32_t high, uint32_t critical) {
+    if (!frame_begin(TELEMETRY_EVENT, 28)) {
+        return false;
+    }
+    frame_put_u32(end);
+    frame_put_u32(timestamp_ms);
+    frame_put_u8(level);
+    frame_put_u8(label);
+    frame_put_u16(0);
+    frame_put_f32s(&confidence, 1);
+    frame_put_u32(total);
+    frame_put_u32(high);
+    frame_put_u32(critical);
+    return frame_end();
+}
+
+bool telemetry_send_status(const telemetry_status_t *status) {
+    if (!frame_begin(TELEMETRY_STATUS, 21)) {
+        return false;
+    }
+    frame_put_u32(status->uptime_ms);
+    frame_put_u32(status->windows_run);
+    frame_put_u32(status->windows_dropped);
+    frame_put_u32(status->adc_overruns);
+    frame_put_u32(tx_dropped);
+    frame_put_u8(status->flags);
+    return frame_end();
+}
+
+void telemetry_flush(void) {
+    while (tx_tail != tx_head) {
+        size_t offset = tx_tail & TX_MASK;
+        size_t len = tx_head - tx_tail;
+        if (len > SEISMIC_TELEMETRY_TX_BYTES - offset) {
+            len = SEISMIC_TELEMETRY_TX_BYTES - offset;
+        }
+        size_t sent = telemetry_backend_write(tx_ring + offset, len);
+        tx_tail += (uint32_t)sent;
+        if (sent < len) {
+            return;     // Transport full, try again next pass
+        }
+    }
+}
+
+uint32_t telemetry_dropped(void) {
+    return tx_dropped;
+}
+
+size_t telemetry_pending(void) {
+    return tx_head - tx_tail;
+}
@@ -0,0 +1,155 @@
+/* Binary telemetry - framed records through a non-blocking TX ring
+ *
+ * Replaces the formatted printf reports with compact binary frames. Frames
+ * are written into a byte ring and telemetry_flush() hands as much of the
+ * ring to the transport as it will take without waiting (USB CDC on the
+ * board, a file on the host). A frame that does not fit is dropped whole
+ * and counted, so a slow or absent reader never stalls the main loop.
+ * host/telemetry_decode.cpp turns a capture back into text or CSV.
+ *
+ * Frame (all fields little endian):
+ *   u8  0xA5, u8 0x5A      sync
+ *   u8  type               telemetry_type_t
+ *   u8  seq                +1 per frame, dropped ones included, so gaps
+ *                          show frames lost on the device or the link
+ *   u16 length             payload bytes
+ *   ... payload
+ *   u16 crc                CRC-16/CCITT-FALSE over type .. payload
+ *
+ * Payloads ("end" is the sample ring position one past the window's newest
+ * sample, i.e. a running sample count that wraps at the ring's wrap, a
+ * multiple of its capacity just below 2^32; differences between ends are
+ * taken modulo the wrap, see sample_ring_position_sub()):
+ *   HELLO     u16 version, u16 sample rate Hz, u16 window, u16 stride,
+ *             u32 ring wrap, u8 label count, then each label NUL
+ *             terminated
+ *   SAMPLES   u32 end, u16 count, f32 samples[count] (m/s, oldest first;
+ *             end is one past the newest sample of this frame). Each
+ *             window sends the samples no earlier window sent, at most
+ *             one window, so every sample goes out once; end - count ahead
+ *             of the previous end with no frame missing from the sequence
+ *             means samples no window covered (windows further apart than
+ *             the window length: heartbeats, a busy core 0)
+ *   FEATURES  u32 end, u16 count, f32 features[count] (normalized)
+ *   SCORES    u32 end, u8 count, u8 best, f32 scores[count]
+ *   TIMING    u32 end, u32 dsp us, u32 classification us, u32 total us
+ *   EVENT     u32 end, u32 timestamp ms, u8 level, u8 label, u16 0,
+ *             f32 confidence, u32 total, u32 high, u32 critical
+ *   STATUS    u32 uptime ms, u32 windows run, u32 windows dropped,
+ *             u32 ADC overruns, u32 telemetry frames dropped, u8 flags
+ *             (bit 0 ready, bit 1 alert silenced)
+ *
+ * Single producer: call the telemetry_send_* functions and telemetry_flush()
+ * from one core (core 0).
+ */
+
+#ifndef SEISMIC_TELEMETRY_H
+#define SEISMIC_TELEMETRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef SEISMIC_TELEMETRY_TX_BYTES
+#define SEISMIC_TELEMETRY_TX_BYTES  8192    // TX ring, a power of two (a whole window of samples and its frames)
+#endif
+
+#define TELEMETRY_VERSION       2
+#define TELEMETRY_SYNC0         0xA5
+#define TELEMETRY_SYNC1         0x5A
+#define TELEMETRY_HEADER_BYTES  6
+#define TELEMETRY_CRC_BYTES     2
+#define TELEMETRY_MAX_PAYLOAD   2048
+#define TELEMETRY_MAX_VALUES    ((TELEMETRY_MAX_PAYLOAD - 8) / 4)   // f32 per frame
+
+#define TELEMETRY_STATUS_READY      0x01
+#define TELEMETRY_STATUS_SILENCED   0x02
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    TELEMETRY_HELLO = 1,
+    TELEMETRY_SAMPLES,
+    TELEMETRY_FEATURES,
+    TELEMETRY_SCORES,
+    TELEMETRY_TIMING,
+    TELEMETRY_EVENT,
+    TELEMETRY_STATUS,
+    TELEMETRY_TYPE_COUNT
+} telemetry_type_t;
+
+typedef struct {
+    uint32_t uptime_ms;
+    uint32_t windows_run;
+    uint32_t windows_dropped;
+    uint32_t adc_overruns;
+    uint8_t flags;              // TELEMETRY_STATUS_*
+} telemetry_status_t;
+
+
+/* ========================================================================= */
+/* APPLICATION API                                                           */
+/* ========================================================================= */
+
+/**
+ * Empty the TX ring and reset the counters.
+ */
+void telemetry_init(void);
+
+/**
+ * The telemetry_send_* functions queue one frame and return false if it was
+ * dropped (TX ring full). telemetry_send_samples() splits more than
+ * TELEMETRY_MAX_VALUES samples over several frames, end being one past the
+ * newest sample and wrap the ring's position wrap; features and scores must
+ * fit in one frame.
+ */
+bool telemetry_send_hello(uint16_t sample_rate_hz, uint16_t window, uint16_t stride, uint32_t wrap,
+                          const char *const *labels, uint8_t label_count);
+bool telemetry_send_samples(uint32_t end, uint32_t wrap, const float *samples, uint16_t count);
+bool telemetry_send_features(uint32_t end, const float *features, uint16_t count);
+bool telemetry_send_scores(uint32_t end, const float *scores, uint8_t count, uint8_t best);
+bool telemetry_send_timing(uint32_t end, uint32_t dsp_us, uint32_t classification_us, uint32_t total_us);
+bool telemetry_send_event(uint32_t end, uint32_t timestamp_ms, uint8_t level, uint8_t label, float confidence,
+                          uint32_t total, uint32_t high, uint32_t critical);
+bool telemetry_send_status(const telemetry_status_t *status);
+
+/**
+ * Hand buffered frames to the transport, as many bytes as it accepts right
+ * now. Never blocks; call from the main loop.
+ */
+void telemetry_flush(void);
+
+/**
+ * Frames dropped because the TX ring was full.
+ */
+uint32_t telemetry_dropped(void);
+
+/**
+ * Bytes waiting in the TX ring.
+ */
+size_t telemetry_pending(void);
+
+/**
+ * CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF), continued from crc.
+ */
+uint16_t telemetry_crc16(uint16_t crc, const uint8_t *data, size_t len);
+
+
+/* ========================================================================= */
+/* PLATFORM BACKEND                                                          */
+/* ========================================================================= */
+
+/**
+ * Write up to len bytes without blocking and return how many were taken.
+ * Implemented by telemetry_rp2350.cpp (USB CDC) on the board and
+ * host/host_telemetry.cpp (SEISMIC_TELEMETRY_FILE) on the host.
+ */
+size_t telemetry_backend_write(const uint8_t *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SEISMIC_TELEMETRY_H
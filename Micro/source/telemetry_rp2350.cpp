@@ -0,0 +1,42 @@
+/* Binary telemetry - RP2350 backend
+ *
+ * Frames go out on the USB CDC port that also carries stdio. Only as many
+ * bytes as TinyUSB has room for are written, so stdio never waits for the
+ * host; with no terminal attached the bytes are discarded, which keeps the
+ * TX ring from filling up with stale frames before a reader connects.
+ * Without USB stdio (pico_enable_stdio_usb off) everything is discarded.
+ */
+
+#include "pico/stdlib.h"
+#include "telemetry.h"
+
+#if LIB_PICO_STDIO_USB
+#include "pico/stdio_usb.h"
+#include "tusb.h"
+#endif
+
+
+/* ========================================================================= */
+/* BACKEND                                                                   */
+/* ========================================================================= */
+
+size_t telemetry_backend_write(const uint8_t *data, size_t len) {
+#if LIB_PICO_STDIO_USB
+    if (!stdio_usb_connected()) {
+        return len;
+    }
+
+    size_t room = tud_cdc_write_available();
+    if (len > room) {
+        len = room;
+    }
+    if (len > 0) {
+        // Raw bytes: no newline, no CR/LF translation
+        stdio_put_string((const char*)data, (int)len, false, false);
+    }
+    return len;
+#else
+    (void)data;
+    return len;
+#endif
+}
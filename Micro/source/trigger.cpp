@@ -0,0 +1,114 @@
+/* STA/LTA trigger - see trigger.h */
+
+#include <stddef.h>
+#include "trigger.h"
+
+// Floor for the LTA so a dead-flat input (e.g. a disconnected sensor at
+// exactly mid-scale) cannot divide by zero
+#define TRIGGER_LTA_FLOOR   1e-20f
+
+void trigger_init(trigger_t *trigger, uint32_t sta_samples, uint32_t lta_samples,
+                  float on_ratio, float off_ratio, uint32_t stride, uint32_t heartbeat, uint32_t hold,
+                  uint32_t lead) {
+    trigger->sta = 0.0f;
+    trigger->lta = 0.0f;
+    trigger->mean = 0.0f;
+    trigger->sta_alpha = 1.0f / (float)(sta_samples > 0 ? sta_samples : 1);
+    trigger->lta_alpha = 1.0f / (float)(lta_samples > 0 ? lta_samples : 1);
+    trigger->mean_alpha = trigger->lta_alpha;
+    trigger->on_ratio = on_ratio;
+    trigger->off_ratio = off_ratio;
+    trigger->lta_samples = lta_samples;
+    trigger->seen = 0;
+    trigger->triggered = false;
+    trigger->stride = stride;
+    trigger->heartbeat = heartbeat;
+    trigger->hold = hold;
+    trigger->hold_left = 0;
+    trigger->lead = lead;
+    trigger->onset_due = 0;
+    trigger->since_window = 0;
+}
+
+trigger_window_t trigger_push(trigger_t *trigger, float sample, bool window_full) {
+    // During warm-up the averages are plain running means, so they start
+    // from the first samples instead of from zero
+    float mean_alpha = trigger->mean_alpha;
+    float sta_alpha = trigger->sta_alpha;
+    float lta_alpha = trigger->lta_alpha;
+    if (trigger->seen < trigger->lta_samples) {
+        float warm = 1.0f / (float)(++trigger->seen);
+        mean_alpha = warm > mean_alpha ? warm : mean_alpha;
+        sta_alpha = warm > sta_alpha ? warm : sta_alpha;
+        lta_alpha = warm > lta_alpha ? warm : lta_alpha;
+    }
+
+    trigger->mean += mean_alpha * (sample - trigger->mean);
+    float x = sample - trigger->mean;
+    float energy = x * x;
+    trigger->sta += sta_alpha * (energy - trigger->sta);
+    trigger->lta += lta_alpha * (energy - trigger->lta);
+
+    bool onset = false;
+    if (trigger->seen >= trigger->lta_samples) {
+        float ratio = trigger_ratio(trigger);
+        if (!trigger->triggered && ratio >= trigger->on_ratio) {
+            trigger->triggered = true;
+            onset = true;
+        } else if (trigger->triggered && ratio < trigger->off_ratio) {
+            trigger->triggered = false;
+        }
+    }
+
+    // Held for hold samples from the release, the release sample included
+    bool active = trigger->triggered || trigger->hold_left > 0;
+    if (trigger->triggered) {
+        trigger->hold_left = trigger->hold;
+    } else if (trigger->hold_left > 0) {
+        trigger->hold_left--;
+    }
+
+    // The onset window waits for lead samples of the event (counting the
+    // onset sample itself when lead is 0)
+    if (onset && trigger->onset_due == 0) {
+        trigger->onset_due = trigger->lead + 1;
+    }
+    bool onset_window = trigger->onset_due > 0 && --trigger->onset_due == 0;
+
+    trigger->since_window++;
+    if (!window_full) {
+        return TRIGGER_WINDOW_NONE;
+    }
+
+    trigger_window_t window = TRIGGER_WINDOW_NONE;
+    if (onset_window) {
+        window = TRIGGER_WINDOW_ONSET;
+    } else if (trigger->onset_due > 0) {
+        window = TRIGGER_WINDOW_NONE;   // The onset window is on its way
+    } else if (active && trigger->since_window >= trigger->stride) {
+        window = TRIGGER_WINDOW_ACTIVE;
+    } else if (trigger->since_window >= trigger->heartbeat) {
+        window = TRIGGER_WINDOW_HEARTBEAT;
+    }
+    if (window != TRIGGER_WINDOW_NONE) {
+        trigger->since_window = 0;
+    }
+    return window;
+}
+
+float trigger_ratio(const trigger_t *trigger) {
+    if (trigger->seen < trigger->lta_samples) {
+        return 0.0f;
+    }
+    float lta = trigger->lta > TRIGGER_LTA_FLOOR ? trigger->lta : TRIGGER_LTA_FLOOR;
+    return trigger->sta / lta;
+}
+
+const char *trigger_window_name(trigger_window_t window) {
+    switch (window) {
+        case TRIGGER_WINDOW_ONSET:      return "onset";
+        case TRIGGER_WINDOW_ACTIVE:     return "active";
+        case TRIGGER_WINDOW_HEARTBEAT:  return "heartbeat";
+        default:                        return "none";
+    }
+}
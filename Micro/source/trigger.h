@@ -0,0 +1,117 @@
+/* STA/LTA trigger - onset detector that schedules inference windows
+ *
+ * Classic short-term / long-term average ratio on the sample energy, run
+ * per sample on the acquisition path. Both averages are recursive
+ * (exponential) over the DC-free signal (a slow running mean is removed
+ * first, the geophone sits on the ADC mid-scale offset), so a sample costs
+ * a handful of multiply-adds and no history.
+ *
+ * The scheduler turns the trigger into inference windows:
+ *   - onset (ratio rises above on_ratio): a window `lead` samples later, so
+ *     it ends with that much of the event instead of at the onset sample
+ *     (nothing else is scheduled until then);
+ *   - while triggered, and for `hold` samples after the release (so the
+ *     whole event passes through the window): a window every `stride`
+ *     samples;
+ *   - otherwise: a heartbeat window every `heartbeat` samples, so the
+ *     classifier still sees the ground when nothing trips the trigger.
+ * The trigger releases once the ratio falls below off_ratio.
+ *
+ * Used by main.cpp (core 1, with SEISMIC_TRIGGER) and by the host replay
+ * tool, so both gate inference the same way.
+ */
+
+#ifndef SEISMIC_TRIGGER_H
+#define SEISMIC_TRIGGER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Defaults for main.cpp and the replay tool, override with -D
+#ifndef TRIGGER_STA_S
+#define TRIGGER_STA_S           0.5f        // Short-term average, s
+#endif
+#ifndef TRIGGER_LTA_S
+#define TRIGGER_LTA_S           10.0f       // Long-term average and warm-up, s
+#endif
+#ifndef TRIGGER_ON_RATIO
+#define TRIGGER_ON_RATIO        4.0f
+#endif
+#ifndef TRIGGER_OFF_RATIO
+#define TRIGGER_OFF_RATIO       1.5f
+#endif
+#ifndef TRIGGER_HEARTBEAT_S
+#define TRIGGER_HEARTBEAT_S     30.0f       // Window period while quiet, s
+#endif
+#ifndef TRIGGER_ONSET_LEAD_S
+#define TRIGGER_ONSET_LEAD_S    1.0f        // Event signal in the onset window, s
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    TRIGGER_WINDOW_NONE = 0,
+    TRIGGER_WINDOW_ONSET,       // lead samples after the ratio crossed on_ratio
+    TRIGGER_WINDOW_ACTIVE,      // Stride while triggered or held
+    TRIGGER_WINDOW_HEARTBEAT    // Low-rate window while quiet
+} trigger_window_t;
+
+typedef struct {
+    // STA/LTA
+    float sta;                  // Short-term mean energy
+    float lta;                  // Long-term mean energy
+    float mean;                 // Running DC offset
+    float sta_alpha;
+    float lta_alpha;
+    float mean_alpha;
+    float on_ratio;
+    float off_ratio;
+    uint32_t lta_samples;
+    uint32_t seen;              // Saturates at lta_samples (warm-up)
+    bool triggered;
+
+    // Scheduler
+    uint32_t stride;
+    uint32_t heartbeat;
+    uint32_t hold;
+    uint32_t hold_left;         // Active samples left after the release
+    uint32_t lead;
+    uint32_t onset_due;         // Samples until the onset window, 0 if none
+    uint32_t since_window;
+} trigger_t;
+
+/**
+ * sta_samples < lta_samples; no trigger before lta_samples were seen.
+ * stride, heartbeat, hold and lead in samples (heartbeat >= stride); a hold
+ * of one window length keeps classifying until the onset has left the
+ * window. A lead below the stride keeps the onset window ahead of the next
+ * stride-scheduled one; 0 classifies the window ending at the onset sample.
+ */
+void trigger_init(trigger_t *trigger, uint32_t sta_samples, uint32_t lta_samples,
+                  float on_ratio, float off_ratio, uint32_t stride, uint32_t heartbeat, uint32_t hold,
+                  uint32_t lead);
+
+/**
+ * Feed one sample; returns whether a window ending at this sample should be
+ * classified, and why. window_full: the ring holds a full window (no window
+ * is scheduled before, the trigger state is still tracked).
+ */
+trigger_window_t trigger_push(trigger_t *trigger, float sample, bool window_full);
+
+/**
+ * Current STA/LTA ratio (0 during warm-up).
+ */
+float trigger_ratio(const trigger_t *trigger);
+
+/**
+ * Short name of a window reason ("none", "onset", "active", "heartbeat").
+ */
+const char *trigger_window_name(trigger_window_t window);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SEISMIC_TRIGGER_H
@@ -35,7 +35,10 @@
 #include "edge-impulse-sdk/tensorflow/lite/c/builtin_op_data.h"
 #include "edge-impulse-sdk/tensorflow/lite/c/common.h"
 #include "edge-impulse-sdk/tensorflow/lite/micro/micro_mutable_op_resolver.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/common.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/kernel_util.h"
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "edge-impulse-sdk/dsp/ei_profiler.h"
 
 #if EI_CLASSIFIER_PRINT_STATE
 #if defined(__cplusplus) && EI_C_LINKAGE == 1
@@ -94,9 +97,9 @@ using namespace tflite::ops::micro;
 namespace {
 
 #if defined(EI_CLASSIFIER_ALLOCATION_STATIC_HIMAX) || defined(EI_CLASSIFIER_ALLOCATION_STATIC_HIMAX_GNU)
-constexpr int kTensorArenaSize = 5488;
+constexpr int kTensorArenaSize = 4592;
 #else
-constexpr int kTensorArenaSize = 4464;
+constexpr int kTensorArenaSize = 3568;
 #endif
 
 #if defined(EI_CLASSIFIER_ALLOCATION_STATIC)
@@ -332,7 +335,7 @@ const TfArray<1, int> outputs19 = { 1, { 43 } };
 };
 
 TensorInfo_t tensorData[] = {
-{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 224), (TfLiteIntArray*)&g0::tensor_dimension0, 224, },
+{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension0, 224, },
 { kTfLiteMmapRo, kTfLiteFloat32, (int32_t*)g0::tensor_data1, (TfLiteIntArray*)&g0::tensor_dimension1, 32, },
 { kTfLiteMmapRo, kTfLiteFloat32, (int32_t*)g0::tensor_data2, (TfLiteIntArray*)&g0::tensor_dimension2, 64, },
 { kTfLiteMmapRo, kTfLiteFloat32, (int32_t*)g0::tensor_data3, (TfLiteIntArray*)&g0::tensor_dimension2, 64, },
@@ -357,24 +360,24 @@ TensorInfo_t tensorData[] = {
 { kTfLiteMmapRo, kTfLiteFloat32, (int32_t*)g0::tensor_data22, (TfLiteIntArray*)&g0::tensor_dimension22, 64, },
 { kTfLiteMmapRo, kTfLiteFloat32, (int32_t*)g0::tensor_data23, (TfLiteIntArray*)&g0::tensor_dimension23, 8, },
 { kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension24, 224, },
-{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 1792), (TfLiteIntArray*)&g0::tensor_dimension25, 1792, },
-{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension26, 1792, },
-{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 1792), (TfLiteIntArray*)&g0::tensor_dimension27, 896, },
+{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 896), (TfLiteIntArray*)&g0::tensor_dimension25, 1792, },
+{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 896), (TfLiteIntArray*)&g0::tensor_dimension26, 1792, },
+{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension27, 896, },
 { kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension28, 896, },
-{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 1792), (TfLiteIntArray*)&g0::tensor_dimension29, 1792, },
-{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension30, 1792, },
-{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 1792), (TfLiteIntArray*)&g0::tensor_dimension31, 896, },
-{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 896), (TfLiteIntArray*)&g0::tensor_dimension32, 896, },
+{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 896), (TfLiteIntArray*)&g0::tensor_dimension29, 1792, },
+{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 896), (TfLiteIntArray*)&g0::tensor_dimension30, 1792, },
+{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension31, 896, },
 { kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension32, 896, },
 { kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 896), (TfLiteIntArray*)&g0::tensor_dimension32, 896, },
-{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension32, 896, },
+{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 1792), (TfLiteIntArray*)&g0::tensor_dimension32, 896, },
 { kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 896), (TfLiteIntArray*)&g0::tensor_dimension32, 896, },
-{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension37, 896, },
-{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 896), (TfLiteIntArray*)&g0::tensor_dimension22, 64, },
+{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 1792), (TfLiteIntArray*)&g0::tensor_dimension32, 896, },
+{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 1792), (TfLiteIntArray*)&g0::tensor_dimension37, 896, },
 { kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension22, 64, },
-{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 64), (TfLiteIntArray*)&g0::tensor_dimension40, 4, },
+{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 64), (TfLiteIntArray*)&g0::tensor_dimension22, 64, },
 { kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension40, 4, },
-{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 16), (TfLiteIntArray*)&g0::tensor_dimension42, 8, },
+{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 16), (TfLiteIntArray*)&g0::tensor_dimension40, 4, },
+{ kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 32), (TfLiteIntArray*)&g0::tensor_dimension42, 8, },
 { kTfLiteArenaRw, kTfLiteFloat32, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension42, 8, },
 };
 
@@ -667,6 +670,164 @@ class EonMicroContext : public MicroContext {
 };
 
 
+
+// Depthwise-separable block: DEPTHWISE_CONV_2D -> MUL -> ADD -> CONV_2D (1x1)
+// in one loop over the output positions. The depthwise output of a position,
+// scaled and shifted by the batch norm MUL/ADD, stays in a tile on the stack
+// and feeds the pointwise convolution directly, so the three intermediate
+// tensors are never written to the arena. The arithmetic follows the
+// reference float kernels operation by operation. Only enabled for float32
+// graphs whose block has the 1xW layout below; otherwise the nodes run one
+// by one.
+static const int kFusedMaxChannels = 64;
+
+typedef struct {
+  bool enabled;
+  size_t first_node;
+  int width;
+  int channels;
+  int out_channels;
+  int kernel;
+  int pad;
+  float dw_min, dw_max;
+  float mul_min, mul_max;
+  float add_min, add_max;
+  float pw_min, pw_max;
+} fused_separable_t;
+
+static fused_separable_t fused_separable;
+
+static float* eval_tensor_floats(int i) {
+  TfLiteEvalTensor tensor;
+  init_tflite_eval_tensor(i, &tensor);
+  return tensor.data.f;
+}
+
+static bool has_dims(int i, int d0, int d1, int d2, int d3) {
+  const TfLiteIntArray* dims = tensorData[i].dims;
+  const int expected[4] = { d0, d1, d2, d3 };
+  int size = d3 >= 0 ? 4 : (d2 >= 0 ? 3 : (d1 >= 0 ? 2 : 1));
+  if (dims->size != size || tensorData[i].type != kTfLiteFloat32) {
+    return false;
+  }
+  for (int d = 0; d < size; d++) {
+    if (dims->data[d] != expected[d]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool match_fused_separable(size_t n, fused_separable_t* f) {
+  if (n + 3 >= sizeof(used_ops) / sizeof(used_ops[0]) ||
+      used_ops[n] != OP_DEPTHWISE_CONV_2D || used_ops[n + 1] != OP_MUL ||
+      used_ops[n + 2] != OP_ADD || used_ops[n + 3] != OP_CONV_2D) {
+    return false;
+  }
+  const TfLiteNode& dw = tflNodes[n];
+  const TfLiteNode& mul = tflNodes[n + 1];
+  const TfLiteNode& add = tflNodes[n + 2];
+  const TfLiteNode& pw = tflNodes[n + 3];
+  const TfLiteDepthwiseConvParams* dw_params = (const TfLiteDepthwiseConvParams*)dw.builtin_data;
+  const TfLiteConvParams* pw_params = (const TfLiteConvParams*)pw.builtin_data;
+
+  const TfLiteIntArray* in_dims = tensorData[dw.inputs->data[0]].dims;
+  const TfLiteIntArray* dw_dims = tensorData[dw.inputs->data[1]].dims;
+  const TfLiteIntArray* pw_dims = tensorData[pw.inputs->data[1]].dims;
+  if (in_dims->size != 4 || dw_dims->size != 4 || pw_dims->size != 4) {
+    return false;
+  }
+  f->width = in_dims->data[2];
+  f->channels = in_dims->data[3];
+  f->out_channels = pw_dims->data[0];
+  f->kernel = dw_dims->data[2];
+  f->pad = (f->kernel - 1) / 2;
+  const int w = f->width, c = f->channels, oc = f->out_channels;
+
+  // the block's tensors chain into each other and are only used here
+  bool chained = mul.inputs->data[0] == dw.outputs->data[0] &&
+                 add.inputs->data[0] == mul.outputs->data[0] &&
+                 pw.inputs->data[0] == add.outputs->data[0];
+  bool shapes = has_dims(dw.inputs->data[0], 1, 1, w, c) &&
+                has_dims(dw.inputs->data[1], 1, 1, f->kernel, c) &&
+                (dw.inputs->size < 3 || has_dims(dw.inputs->data[2], c, -1, -1, -1)) &&
+                has_dims(dw.outputs->data[0], 1, 1, w, c) &&
+                has_dims(mul.inputs->data[1], c, -1, -1, -1) &&
+                has_dims(mul.outputs->data[0], 1, 1, w, c) &&
+                has_dims(add.inputs->data[1], c, -1, -1, -1) &&
+                has_dims(add.outputs->data[0], 1, 1, w, c) &&
+                has_dims(pw.inputs->data[1], oc, 1, 1, c) &&
+                (pw.inputs->size < 3 || has_dims(pw.inputs->data[2], oc, -1, -1, -1)) &&
+                has_dims(pw.outputs->data[0], 1, 1, w, oc);
+  bool params = dw_params->padding == kTfLitePaddingSame &&
+                dw_params->stride_width == 1 && dw_params->stride_height == 1 &&
+                dw_params->dilation_width_factor == 1 && dw_params->dilation_height_factor == 1 &&
+                dw_params->depth_multiplier == 1 &&
+                pw_params->stride_width == 1 && pw_params->stride_height == 1;
+  if (!chained || !shapes || !params || c > kFusedMaxChannels) {
+    return false;
+  }
+
+  CalculateActivationRange(dw_params->activation, &f->dw_min, &f->dw_max);
+  CalculateActivationRange(((const TfLiteMulParams*)mul.builtin_data)->activation, &f->mul_min, &f->mul_max);
+  CalculateActivationRange(((const TfLiteAddParams*)add.builtin_data)->activation, &f->add_min, &f->add_max);
+  CalculateActivationRange(pw_params->activation, &f->pw_min, &f->pw_max);
+  f->first_node = n;
+  return true;
+}
+
+static void init_fused_separable() {
+  fused_separable.enabled = false;
+  for (size_t n = 0; n < sizeof(used_ops) / sizeof(used_ops[0]); n++) {
+    if (match_fused_separable(n, &fused_separable)) {
+      fused_separable.enabled = true;
+      return;
+    }
+  }
+}
+
+static TfLiteStatus invoke_fused_separable() {
+  const fused_separable_t& f = fused_separable;
+  const TfLiteNode& dw = tflNodes[f.first_node];
+  const TfLiteNode& pw = tflNodes[f.first_node + 3];
+
+  const float* input = eval_tensor_floats(dw.inputs->data[0]);
+  const float* dw_filter = eval_tensor_floats(dw.inputs->data[1]);
+  const float* dw_bias = dw.inputs->size > 2 ? eval_tensor_floats(dw.inputs->data[2]) : nullptr;
+  const float* scale = eval_tensor_floats(tflNodes[f.first_node + 1].inputs->data[1]);
+  const float* shift = eval_tensor_floats(tflNodes[f.first_node + 2].inputs->data[1]);
+  const float* pw_filter = eval_tensor_floats(pw.inputs->data[1]);
+  const float* pw_bias = pw.inputs->size > 2 ? eval_tensor_floats(pw.inputs->data[2]) : nullptr;
+  float* output = eval_tensor_floats(pw.outputs->data[0]);
+
+  float tile[kFusedMaxChannels];
+  for (int x = 0; x < f.width; x++) {
+    for (int c = 0; c < f.channels; c++) {
+      float total = 0.f;
+      for (int k = 0; k < f.kernel; k++) {
+        const int in_x = x - f.pad + k;
+        if (in_x >= 0 && in_x < f.width) {
+          total += (input[in_x * f.channels + c] * dw_filter[k * f.channels + c]);
+        }
+      }
+      float value = ActivationFunctionWithMinMax(total + (dw_bias ? dw_bias[c] : 0.0f), f.dw_min, f.dw_max);
+      value = ActivationFunctionWithMinMax(value * scale[c], f.mul_min, f.mul_max);
+      tile[c] = ActivationFunctionWithMinMax(value + shift[c], f.add_min, f.add_max);
+    }
+
+    float* out = output + x * f.out_channels;
+    for (int oc = 0; oc < f.out_channels; oc++) {
+      const float* filter = pw_filter + oc * f.channels;
+      float total = 0.f;
+      for (int c = 0; c < f.channels; c++) {
+        total += (tile[c] * filter[c]);
+      }
+      out[oc] = ActivationFunctionWithMinMax(total + (pw_bias ? pw_bias[oc] : 0.0f), f.pw_min, f.pw_max);
+    }
+  }
+  return kTfLiteOk;
+}
+
 } // namespace
 
 TfLiteStatus tflite_learn_815551_95_init( void*(*alloc_fnc)(size_t,size_t) ) {
@@ -746,6 +907,8 @@ TfLiteStatus tflite_learn_815551_95_init( void*(*alloc_fnc)(size_t,size_t) ) {
   }
   current_subgraph_index = 0;
 
+  init_fused_separable();
+
   return kTfLiteOk;
 }
 
@@ -761,9 +924,24 @@ TfLiteStatus tflite_learn_815551_95_output(int index, TfLiteTensor *tensor) {
 
 TfLiteStatus tflite_learn_815551_95_invoke() {
   for (size_t i = 0; i < 20; ++i) {
+    // RESHAPE outputs share their input's arena offset, nothing to copy
+    if (used_ops[i] == OP_RESHAPE &&
+        tensorData[tflNodes[i].inputs->data[0]].data == tensorData[tflNodes[i].outputs->data[0]].data) {
+      continue;
+    }
+
     ResetTensors();
 
-    TfLiteStatus status = registrations[used_ops[i]].invoke(&ctx, &tflNodes[i]);
+    EI_PROFILE_START(node_start_us);
+    const bool fused = fused_separable.enabled && i == fused_separable.first_node;
+    TfLiteStatus status;
+    if (fused) {
+      status = invoke_fused_separable();
+    }
+    else {
+      status = registrations[used_ops[i]].invoke(&ctx, &tflNodes[i]);
+    }
+    EI_PROFILE_END(node_start_us, EI_PROFILE_NODE, i);
 
 #if EI_CLASSIFIER_PRINT_STATE
     ei_printf("layer %lu\n", i);
@@ -827,6 +1005,9 @@ TfLiteStatus tflite_learn_815551_95_invoke() {
     if (status != kTfLiteOk) {
       return status;
     }
+    if (fused) {
+      i += 3;   // MUL, ADD and CONV_2D ran in invoke_fused_separable()
+    }
   }
   return kTfLiteOk;
 }
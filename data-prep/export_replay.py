@@ -0,0 +1,128 @@
+"""
+Export STEAD .npz waveforms (from dataset-npz.ipynb) to the flat binary
+replay format read by Micro/host/replay.cpp.
+
+The .npz archives are zip-compressed and carry their metadata as a pickled
+dict, so the C++ side cannot map them directly. This script writes one file
+that it can: the Z channel of every trace as float32, plus a fixed-size index
+with the P/S arrival samples and the category of each trace.
+
+Layout (all fields little endian):
+
+  header, 32 bytes
+    char[4]  magic "SRPL"
+    u32      version (1)
+    u32      trace count
+    u32      sample rate in Hz
+    u32      index entry size (64)
+    u32[3]   reserved (0)
+
+  index, one 64-byte entry per trace
+    u64      byte offset of the samples from the start of the file
+    u32      sample count
+    i32      P arrival sample (-1 if none)
+    i32      S arrival sample (-1 if none)
+    u8       category: 0 noise, 1 earthquake_local, 2 other
+    u8[3]    reserved (0)
+    char[40] trace name, NUL padded (truncated if longer)
+
+  samples, float32, each trace 4-byte aligned
+
+Usage:
+  python export_replay.py OUTPUT.bin FOLDER_OR_NPZ [FOLDER_OR_NPZ ...]
+"""
+
+import math
+import os
+import struct
+import sys
+
+import numpy as np
+
+MAGIC = b"SRPL"
+VERSION = 1
+HEADER_BYTES = 32
+ENTRY_BYTES = 64
+NAME_BYTES = 40
+SAMPLE_RATE_HZ = 100    # STEAD
+Z_CHANNEL = 2           # STEAD waveforms are (samples, 3): E, N, Z
+
+CATEGORIES = {"noise": 0, "earthquake_local": 1}
+
+
+def arrival_sample(attributes, key):
+    value = attributes.get(key, None)
+    try:
+        value = float(value)
+    except (TypeError, ValueError):
+        return -1
+    return int(value) if math.isfinite(value) and value >= 0 else -1
+
+
+def category(attributes, path):
+    label = attributes.get("trace_category", None)
+    if label is None:
+        # dataset-npz.ipynb names the noise archives *_noise.npz
+        label = "noise" if path.endswith("_noise.npz") else "earthquake_local"
+    return CATEGORIES.get(str(label), 2)
+
+
+def collect(paths):
+    files = []
+    for path in paths:
+        if os.path.isdir(path):
+            files += [os.path.join(path, f) for f in sorted(os.listdir(path)) if f.endswith(".npz")]
+        elif path.endswith(".npz"):
+            files.append(path)
+    return files
+
+
+def load(path):
+    npz = np.load(path, allow_pickle=True)
+    waveform = np.asarray(npz["waveform"])
+    attributes = npz["attributes"].item() if "attributes" in npz else {}
+    z = waveform[:, Z_CHANNEL] if waveform.ndim == 2 else waveform
+    name = str(attributes.get("trace_name", os.path.splitext(os.path.basename(path))[0]))
+    return {
+        "name": name.encode("utf-8")[:NAME_BYTES],
+        "samples": np.ascontiguousarray(z, dtype="<f4"),
+        "p": arrival_sample(attributes, "p_arrival_sample"),
+        "s": arrival_sample(attributes, "s_arrival_sample"),
+        "category": category(attributes, path),
+    }
+
+
+def main():
+    if len(sys.argv) < 3:
+        print(__doc__)
+        return 1
+
+    files = collect(sys.argv[2:])
+    if not files:
+        print("No .npz files found")
+        return 1
+
+    traces = []
+    for path in files:
+        try:
+            traces.append(load(path))
+        except Exception as e:
+            print(f"Skipping {path}: {e}")
+
+    offset = HEADER_BYTES + ENTRY_BYTES * len(traces)
+    with open(sys.argv[1], "wb") as out:
+        out.write(struct.pack("<4sIIII12x", MAGIC, VERSION, len(traces), SAMPLE_RATE_HZ, ENTRY_BYTES))
+        for trace in traces:
+            out.write(struct.pack("<QIiiB3x40s", offset, len(trace["samples"]),
+                                  trace["p"], trace["s"], trace["category"], trace["name"]))
+            offset += trace["samples"].nbytes
+        for trace in traces:
+            out.write(trace["samples"].tobytes())
+
+    events = sum(1 for t in traces if t["category"] == 1)
+    print(f"Wrote {sys.argv[1]}: {len(traces)} traces ({events} earthquake_local)")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())